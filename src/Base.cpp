@@ -5,26 +5,20 @@
  * \date May 2007
  */
 #include "Base.h"
-
-#include <Fl/fl_draw.h>
-
-/** \brief Global vector of pointers to all Base objects.
- *
- * This vector stores pointers to all Base objects. It is self-managed.
- * When a Base object is created, it adds itself to the vector and when
- * it is destroyed it removes itself from the vector.
- */
-vector<Base*> Base::bases_;
+#include "WorldState.h"
+#include "SaveState.h"
+#include "View.h"
+#include "Canvas.h"
 
 /** \brief Constructor for Base.
  *
- * The constructor adds the Base object to the global vector of bases.
+ * The constructor adds the Base object to the current world's vector of bases.
  * To create an object, use "new Base(...)" and the object can be 
  * accessed via the Base::bases() function.
  */
 Base::Base(double x, double y) : PlayerItem(x, y, BASE_RADIUS)
 {
-	bases_.push_back(this);
+	WorldState::current().bases.push_back(this);
 }
 
 /** \brief Destructor for Base.
@@ -34,12 +28,13 @@ Base::Base(double x, double y) : PlayerItem(x, y, BASE_RADIUS)
  */
 Base::~Base()
 {
+	vector<Base*> &bases = WorldState::current().bases;
 	vector<Base*>::iterator it;
-	for (it = bases_.begin(); it != bases_.end(); it++)
+	for (it = bases.begin(); it != bases.end(); it++)
 	{
 		if ((*it) == this)
 		{
-			bases_.erase(it);
+			bases.erase(it);
 			break;
 		}
 	}
@@ -54,39 +49,58 @@ Base::~Base()
  */
 const vector<Base*>& Base::bases()
 {
-	return bases_;
+	return WorldState::current().bases;
 }
 
-/** \brief The interface to draw the Base.
+/** \brief The interface to capture the Base for drawing.
  *
- * This protected draw() function calls the private draw_base() function
- * to draw the object
+ * This protected capture() function adds the drawing state of the Base
+ * to the snapshot.
+ * \param snap The snapshot being filled in.
  */
-void Base::draw()
+void Base::capture(Snapshot &snap)
 {
-	draw_base();
+	BaseState s;
+	s.handle = handle();
+	s.x = x();
+	s.y = y();
+	s.radius = radius();
+	snap.bases.push_back(s);
 }
 
 /** \brief The specialised drawing function for Base.
  *
- * The draw_base() function uses the FLTK routines to draw the Base in
- * the form of a house.
+ * The draw_base() function uses the FLTK routines to draw a captured Base
+ * in the form of a house.
+ * \param s The drawing state of the Base.
  */
-void Base::draw_base()
+void Base::draw_base(const BaseState &s)
 {
+	const View &v = View::current();
+	Canvas &canvas = Canvas::current();
 #ifdef DEBUG // draw collision radius
-	fl_color(FL_RED);
-	fl_circle(x(), y(), radius());
+	canvas.color(FL_RED);
+	canvas.circle(v.x(s.x), v.y(s.y), v.size(s.radius));
 #endif
-	fl_color(FL_WHITE);
-	fl_rectf((int)x()-20, (int)y()-15, 40, 30);
-	fl_color(FL_BLACK);
-	fl_rect((int)x()-20, (int)y()-15, 40, 30);
-	fl_begin_polygon();
-	fl_begin_loop();
-	fl_vertex(x() - 30, y() - 15);
-	fl_vertex(x(), y() - 25);
-	fl_vertex(x() + 30, y() - 15);
-	fl_end_loop();
-	fl_end_polygon();
+	canvas.color(FL_WHITE);
+	canvas.rectf((int)v.x(s.x-20), (int)v.y(s.y-15), (int)v.size(40), (int)v.size(30));
+	canvas.color(FL_BLACK);
+	canvas.rect((int)v.x(s.x-20), (int)v.y(s.y-15), (int)v.size(40), (int)v.size(30));
+	canvas.begin_polygon();
+	canvas.begin_loop();
+	canvas.vertex(v.x(s.x - 30), v.y(s.y - 15));
+	canvas.vertex(v.x(s.x), v.y(s.y - 25));
+	canvas.vertex(v.x(s.x + 30), v.y(s.y - 15));
+	canvas.end_loop();
+	canvas.end_polygon();
+}
+
+/** \brief A function to save the Base's state.
+ *
+ * \param r The record to save into.
+ */
+void Base::save(ObjectRecord &r)
+{
+	PlayerItem::save(r);
+	r.type = OBJECT_BASE;
 }
@@ -8,6 +8,7 @@
 #define BASE_H
 
 #include "PlayerItem.h"
+#include "Snapshot.h"
 
 /** \brief The players Base class.
  *
@@ -22,12 +23,13 @@ public:
 	Base(double x, double y);
 	virtual ~Base();
 
+	friend class World;
+
 	static const vector<Base*>& bases();
+	static void draw_base(const BaseState &s);
+	virtual void save(ObjectRecord &r);
 protected:
-	virtual void draw();
-private:
-	static vector<Base*> bases_;
-	virtual void draw_base();
+	void capture(Snapshot &snap);
 };
 
 #endif
@@ -0,0 +1,177 @@
+/** \file Canvas.cpp
+ * \brief Code implementation for Canvas class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "Canvas.h"
+
+#include <Fl/fl_draw.h>
+
+#include "thread.h"
+
+/** \brief The Canvas used when none has been chosen, which draws with FLTK.
+ */
+static Canvas fltk_canvas;
+
+/** \brief The current Canvas of this thread, 0 for fltk_canvas.
+ */
+static THREAD_LOCAL Canvas *current_canvas = 0;
+
+/** \brief Constructor for Canvas.
+ */
+Canvas::Canvas()
+{
+}
+
+/** \brief Destructor for Canvas.
+ */
+Canvas::~Canvas()
+{
+}
+
+/** \brief A function to set the colour of everything drawn after it.
+ *
+ * \param c The colour.
+ */
+void Canvas::color(Fl_Color c)
+{
+	fl_color(c);
+}
+
+/** \brief A function to set the width of lines drawn after it.
+ *
+ * \param width The width in pixels, 0 for the thinnest line.
+ */
+void Canvas::line_style(int width)
+{
+	fl_line_style(FL_SOLID, width);
+}
+
+/** \brief A function to fill a rectangle.
+ */
+void Canvas::rectf(int x, int y, int w, int h)
+{
+	fl_rectf(x, y, w, h);
+}
+
+/** \brief A function to draw the outline of a rectangle.
+ */
+void Canvas::rect(int x, int y, int w, int h)
+{
+	fl_rect(x, y, w, h);
+}
+
+/** \brief A function to draw a line.
+ */
+void Canvas::line(int x, int y, int x1, int y1)
+{
+	fl_line(x, y, x1, y1);
+}
+
+/** \brief A function to draw a single pixel.
+ */
+void Canvas::point(int x, int y)
+{
+	fl_point(x, y);
+}
+
+/** \brief A function to draw the outline of a circle.
+ */
+void Canvas::circle(double x, double y, double r)
+{
+	fl_circle(x, y, r);
+}
+
+/** \brief A function to fill part of an ellipse.
+ *
+ * The ellipse fits the rectangle given, and the part between the angles a1
+ * and a2 is filled. Angles are in degrees anticlockwise from 3 o'clock.
+ */
+void Canvas::pie(int x, int y, int w, int h, double a1, double a2)
+{
+	fl_pie(x, y, w, h, a1, a2);
+}
+
+/** \brief A function to draw part of the outline of an ellipse.
+ *
+ * The arguments are the same as for pie().
+ */
+void Canvas::arc(int x, int y, int w, int h, double a1, double a2)
+{
+	fl_arc(x, y, w, h, a1, a2);
+}
+
+/** \brief A function to start a filled polygon.
+ *
+ * The vertices given after it are filled by end_polygon().
+ */
+void Canvas::begin_polygon()
+{
+	fl_begin_polygon();
+}
+
+/** \brief A function to start a closed outline.
+ *
+ * The vertices given after it are joined up by end_loop().
+ */
+void Canvas::begin_loop()
+{
+	fl_begin_loop();
+}
+
+/** \brief A function to start a batch of single pixels.
+ *
+ * The vertices given after it are drawn by end_points().
+ */
+void Canvas::begin_points()
+{
+	fl_begin_points();
+}
+
+/** \brief A function to add a vertex to the current shape.
+ */
+void Canvas::vertex(double x, double y)
+{
+	fl_vertex(x, y);
+}
+
+/** \brief A function to draw the closed outline of the vertices given.
+ */
+void Canvas::end_loop()
+{
+	fl_end_loop();
+}
+
+/** \brief A function to draw a pixel at each of the vertices given.
+ */
+void Canvas::end_points()
+{
+	fl_end_points();
+}
+
+/** \brief A function to fill the polygon of the vertices given.
+ */
+void Canvas::end_polygon()
+{
+	fl_end_polygon();
+}
+
+/** \brief A function to return the current Canvas.
+ *
+ * \return Returns the Canvas the draw functions on this thread use.
+ */
+Canvas& Canvas::current()
+{
+	return current_canvas ? *current_canvas : fltk_canvas;
+}
+
+/** \brief A function to choose the current Canvas.
+ *
+ * \param canvas The Canvas for the draw functions on this thread to use, or
+ *	0 for FLTK. It must stay alive while it is current.
+ */
+void Canvas::current(Canvas *canvas)
+{
+	current_canvas = canvas;
+}
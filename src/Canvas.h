@@ -0,0 +1,49 @@
+/** \file Canvas.h
+ * \brief Header file for Canvas class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef CANVAS_H
+#define CANVAS_H
+
+#include <Fl/Fl.H>
+
+#include "enum.h"
+
+/** \brief The Canvas class.
+ *
+ * The Canvas class is the set of drawing primitives the draw functions use,
+ * with the same arguments as the FLTK functions of the same names. This
+ * class draws with FLTK, so it needs a display; subclasses can draw
+ * somewhere else. The draw functions draw on the current Canvas, which is
+ * chosen separately for each thread and is FLTK unless changed.
+ */
+class Canvas
+{
+public:
+	Canvas();
+	virtual ~Canvas();
+
+	virtual void color(Fl_Color c);
+	virtual void line_style(int width);
+	virtual void rectf(int x, int y, int w, int h);
+	virtual void rect(int x, int y, int w, int h);
+	virtual void line(int x, int y, int x1, int y1);
+	virtual void point(int x, int y);
+	virtual void circle(double x, double y, double r);
+	virtual void pie(int x, int y, int w, int h, double a1, double a2);
+	virtual void arc(int x, int y, int w, int h, double a1, double a2);
+	virtual void begin_polygon();
+	virtual void begin_loop();
+	virtual void begin_points();
+	virtual void vertex(double x, double y);
+	virtual void end_loop();
+	virtual void end_points();
+	virtual void end_polygon();
+
+	static Canvas& current();
+	static void current(Canvas *canvas);
+};
+
+#endif
@@ -0,0 +1,218 @@
+/** \file CommandBuffer.cpp
+ * \brief Code implementation for CommandBuffer class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "CommandBuffer.h"
+#include "WorldState.h"
+#include "trace.h"
+#include "alloc.h"
+
+#include "Missile.h"
+#include "UFO.h"
+#include "Shell.h"
+#include "ShellExplosion.h"
+
+/** \brief A function to record that an object should be deleted.
+ *
+ * The object is marked dead immediately. Recording the same object more
+ * than once has no further effect. Call on_death() first if the object
+ * should do anything on death.
+ * \param obj The object to delete.
+ */
+void CommandBuffer::destroy(GameObject *obj)
+{
+	if (obj->dead_)
+	{
+		return;
+	}
+	obj->dead_ = true;
+	record(DESTROY, 0, 0, 0, 0, 0);
+	Command &c = WorldState::current().commands.back();
+	c.object = obj->handle();
+	if (c.object == NULL_HANDLE) // the HandleTable was full when it was created
+	{
+		c.pointer = obj;
+	}
+}
+
+/** \brief A function to record that a Missile should be created.
+ *
+ * \param startx The x co-ordinate of the start location.
+ * \param starty The y co-ordinate of the start location.
+ * \param endx The x co-ordinate of the target.
+ * \param endy The y co-ordinate of the target.
+ * \param vel The velocity of the Missile.
+ */
+void CommandBuffer::spawn_missile(double startx, double starty, double endx, double endy, double vel)
+{
+	record(SPAWN_MISSILE, startx, starty, endx, endy, vel);
+}
+
+/** \brief A function to record that a UFO should be created.
+ *
+ * \param startx The x co-ordinate of the start location.
+ * \param starty The y co-ordinate of the start location.
+ * \param endx The x co-ordinate of the target.
+ * \param endy The y co-ordinate of the target.
+ * \param vel The velocity of the UFO.
+ */
+void CommandBuffer::spawn_ufo(double startx, double starty, double endx, double endy, double vel)
+{
+	record(SPAWN_UFO, startx, starty, endx, endy, vel);
+}
+
+/** \brief A function to record that a Shell should be created.
+ *
+ * \param startx The x co-ordinate of the start location.
+ * \param starty The y co-ordinate of the start location.
+ * \param endx The x co-ordinate of the target.
+ * \param endy The y co-ordinate of the target.
+ * \param radius The radius of the Shell.
+ */
+void CommandBuffer::spawn_shell(double startx, double starty, double endx, double endy, double radius)
+{
+	record(SPAWN_SHELL, startx, starty, endx, endy, radius);
+}
+
+/** \brief A function to record that a ShellExplosion should be created.
+ *
+ * \param x The x co-ordinate of the explosion.
+ * \param y The y co-ordinate of the explosion.
+ * \param radius The maximum radius of the explosion.
+ */
+void CommandBuffer::spawn_shellexplosion(double x, double y, double radius)
+{
+	record(SPAWN_SHELLEXPLOSION, x, y, radius, 0, 0);
+}
+
+/** \brief A function to report a visual effect.
+ *
+ * The effect changes nothing in the game. It is kept until the end of the
+ * update, when the World passes it on to be drawn.
+ * \param kind One of the EFFECT_ values.
+ * \param x The x co-ordinate of the effect.
+ * \param y The y co-ordinate of the effect.
+ * \param size The radius of what caused the effect.
+ */
+void CommandBuffer::effect(int kind, double x, double y, double size)
+{
+	EffectState e;
+	e.kind = kind;
+	e.x = x;
+	e.y = y;
+	e.size = size;
+	WorldState::current().effects.push_back(e);
+}
+
+/** \brief A function to count the recorded commands of a type.
+ *
+ * This is used to keep limits such as MAX_MISSILES when objects spawned this
+ * update are not in the registries yet.
+ * \param type The command type.
+ * \return Returns the number of commands of that type not yet applied.
+ */
+int CommandBuffer::pending(int type)
+{
+	return WorldState::current().pending[type];
+}
+
+/** \brief A function to apply all recorded commands.
+ *
+ * The commands are applied in the order they were recorded. Objects that have
+ * already been deleted by other means are skipped. This must only be called
+ * when nothing is looping over the registries. The command vector is emptied
+ * but keeps its storage, so recording commands does not allocate once the
+ * game has warmed up.
+ */
+void CommandBuffer::apply()
+{
+	TRACE_SCOPE("apply");
+	ALLOC_TAG("apply");
+	WorldState &w = WorldState::current();
+	vector<Command> &commands = w.commands;
+	TRACE_COUNTER("destroyed", w.pending[DESTROY]);
+	TRACE_COUNTER("spawned", (long)commands.size() - w.pending[DESTROY]);
+	for (unsigned int i = 0; i < commands.size(); i++)
+	{
+		Command &c = commands[i];
+		switch (c.type)
+		{
+			case DESTROY:
+				delete ((c.object != NULL_HANDLE) ? HandleTable::lookup(c.object) : c.pointer);
+				break;
+			case SPAWN_MISSILE:
+			{
+				ALLOC_TAG("Missile");
+				new Missile(c.param[0], c.param[1], c.param[2], c.param[3], c.param[4]);
+				break;
+			}
+			case SPAWN_UFO:
+			{
+				ALLOC_TAG("UFO");
+				new UFO(c.param[0], c.param[1], c.param[2], c.param[3], c.param[4]);
+				break;
+			}
+			case SPAWN_SHELL:
+			{
+				ALLOC_TAG("Shell");
+				new Shell(c.param[0], c.param[1], c.param[2], c.param[3], c.param[4]);
+				break;
+			}
+			case SPAWN_SHELLEXPLOSION:
+			{
+				ALLOC_TAG("ShellExplosion");
+				new ShellExplosion(c.param[0], c.param[1], c.param[2]);
+				break;
+			}
+			default:
+				break;
+		}
+	}
+	commands.clear();
+	for (int i = 0; i < COMMAND_TYPES; i++)
+	{
+		w.pending[i] = 0;
+	}
+}
+
+/** \brief A function to throw away all recorded commands without applying them.
+ *
+ * Used when the objects the commands refer to are about to be deleted, such
+ * as when a game is replaced. Visual effects already reported are kept.
+ */
+void CommandBuffer::clear()
+{
+	WorldState &w = WorldState::current();
+	w.commands.clear();
+	for (int i = 0; i < COMMAND_TYPES; i++)
+	{
+		w.pending[i] = 0;
+	}
+}
+
+/** \brief A function to add a command to the buffer.
+ *
+ * \param type The command type.
+ * \param a First parameter.
+ * \param b Second parameter.
+ * \param c Third parameter.
+ * \param d Fourth parameter.
+ * \param e Fifth parameter.
+ */
+void CommandBuffer::record(int type, double a, double b, double c, double d, double e)
+{
+	Command cmd;
+	cmd.type = type;
+	cmd.object = NULL_HANDLE;
+	cmd.pointer = 0;
+	cmd.param[0] = a;
+	cmd.param[1] = b;
+	cmd.param[2] = c;
+	cmd.param[3] = d;
+	cmd.param[4] = e;
+	WorldState &w = WorldState::current();
+	w.commands.push_back(cmd);
+	w.pending[type]++;
+}
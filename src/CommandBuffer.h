@@ -0,0 +1,57 @@
+/** \file CommandBuffer.h
+ * \brief Header file for CommandBuffer class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef COMMANDBUFFER_H
+#define COMMANDBUFFER_H
+
+#include "GameObject.h"
+
+/** \brief Command types recorded by the CommandBuffer.
+ */
+enum {DESTROY = 0, SPAWN_MISSILE, SPAWN_UFO, SPAWN_SHELL, SPAWN_SHELLEXPLOSION, COMMAND_TYPES};
+
+/** \brief A single recorded structural change.
+ *
+ * For DESTROY commands object is the Handle of the object to delete, or
+ * NULL_HANDLE and pointer is the object if it was given no handle because the
+ * HandleTable was full. For spawn commands the meaning of the parameters
+ * follows the constructor of the spawned class, e.g. start x, start y, end x,
+ * end y and velocity for a Missile.
+ */
+struct Command
+{
+	int type;
+	Handle object;
+	GameObject *pointer;
+	double param[5];
+};
+
+/** \brief The CommandBuffer class.
+ *
+ * Objects must not be created or deleted while the registries are being
+ * looped over, so during an update all such changes are recorded in the
+ * CommandBuffer instead and applied together by apply() at the end of the
+ * update. An object recorded for destruction is marked dead straight away
+ * so the rest of the update can skip it. Visual effects are reported here
+ * too, and collected for the World to pass on for drawing.
+ */
+class CommandBuffer
+{
+public:
+	static void destroy(GameObject *obj);
+	static void spawn_missile(double startx, double starty, double endx, double endy, double vel);
+	static void spawn_ufo(double startx, double starty, double endx, double endy, double vel);
+	static void spawn_shell(double startx, double starty, double endx, double endy, double radius);
+	static void spawn_shellexplosion(double x, double y, double radius);
+	static void effect(int kind, double x, double y, double size);
+	static int pending(int type);
+	static void apply();
+	static void clear();
+private:
+	static void record(int type, double a, double b, double c, double d, double e);
+};
+
+#endif
@@ -5,24 +5,18 @@
  * \date May 2007
  */
 #include "EnemyItem.h"
-
-/** \brief Global vector of pointers to all EnemyItem objects.
- *
- * This vector stores pointers to all EnemyItem objects. It is self-managed.
- * When an EnemyItem object is created, it adds itself to the vector and when
- * it is destroyed it removes itself from the vector.
- */
-vector<EnemyItem*> EnemyItem::enemyitems_;
+#include "WorldState.h"
+#include "CommandBuffer.h"
 
 /** \brief Constructor for EnemyItem.
  *
- * The constructor adds the EnemyItem object to the global vector of enemy items.
+ * The constructor adds the EnemyItem object to the current world's vector of enemy items.
  * To create an object, use "new EnemyItem(...)" and the object can be 
  * accessed via the EnemyItem::enemyitems() function.
  */
 EnemyItem::EnemyItem(double startx, double starty, double endx, double endy, double r, double vel) : Projectile(startx, starty, endx, endy, r, vel)
 {
-	enemyitems_.push_back(this);
+	WorldState::current().enemyitems.push_back(this);
 }
 
 /** \brief Destructor for EnemyItem.
@@ -32,12 +26,13 @@ EnemyItem::EnemyItem(double startx, double starty, double endx, double endy, dou
  */
 EnemyItem::~EnemyItem()
 {
+	vector<EnemyItem*> &enemyitems = WorldState::current().enemyitems;
 	vector<EnemyItem*>::iterator it;
-	for(it = enemyitems_.begin(); it != enemyitems_.end(); it++)
+	for(it = enemyitems.begin(); it != enemyitems.end(); it++)
 	{
 		if((*it) == this)
 		{
-			enemyitems_.erase(it);
+			enemyitems.erase(it);
 			break;
 		}
 	}
@@ -53,5 +48,25 @@ EnemyItem::~EnemyItem()
  */
 const vector<EnemyItem*>& EnemyItem::enemyitems()
 {
-	return enemyitems_;
+	return WorldState::current().enemyitems;
+}
+
+/** \brief A function to show the EnemyItem being destroyed.
+ *
+ * This function reports debris where the EnemyItem was, whether it was
+ * caught in an explosion or hit its target.
+ */
+void EnemyItem::on_death()
+{
+	CommandBuffer::effect(EFFECT_DEBRIS, x(), y(), radius());
+}
+
+/** \brief A function to execute stuff when the EnemyItem is caught in an explosion.
+ *
+ * This function does nothing and is to be overridden by child classes that
+ * need to know how they died. It is called before on_death(), which is also
+ * called when the EnemyItem dies any other way.
+ */
+void EnemyItem::on_shot_down()
+{
 }
@@ -22,8 +22,8 @@ public:
 	virtual ~EnemyItem();
 	
 	static const vector<EnemyItem*>& enemyitems();
-private:
-	static vector<EnemyItem*> enemyitems_;
+	virtual void on_death();
+	virtual void on_shot_down();
 };
 
 #endif
@@ -5,20 +5,14 @@
  * \date May 2007
  */
 #include "Explosion.h"
+#include "WorldState.h"
+#include "SaveState.h"
 
 #include <Fl/fl_draw.h>
 
-/** \brief Global vector of pointers to all Explosion objects.
- *
- * This vector stores pointers to all Explosion objects. It is self-managed.
- * When an Explosion object is created, it adds itself to the vector and when
- * it is destroyed it removes itself from the vector.
- */
-vector<Explosion*> Explosion::explosions_;
-
 /** \brief Constructor for Explosion.
  *
- * The constructor adds the Explosion object to the global vector of enemy items.
+ * The constructor adds the Explosion object to the current world's vector of enemy items.
  * The constructor also records the creation time of the Explosion object.
  * To create an object, use "new Explosion(...)" and the object can be accessed 
  * via the Explosion::explosions() function.
@@ -26,7 +20,7 @@ vector<Explosion*> Explosion::explosions_;
 Explosion::Explosion(double x, double y, double r) : GameObject(x, y, r)
 {
 	timealive_ = 0;
-	explosions_.push_back(this);
+	WorldState::current().explosions.push_back(this);
 }
 
 /** \brief Destructor for Explosion.
@@ -36,12 +30,13 @@ Explosion::Explosion(double x, double y, double r) : GameObject(x, y, r)
  */
 Explosion::~Explosion()
 {
+	vector<Explosion*> &explosions = WorldState::current().explosions;
 	vector<Explosion*>::iterator it;
-	for(it = explosions_.begin(); it != explosions_.end(); it++)
+	for(it = explosions.begin(); it != explosions.end(); it++)
 	{
 		if((*it) == this)
 		{
-			explosions_.erase(it);
+			explosions.erase(it);
 			break;
 		}
 	}
@@ -56,16 +51,7 @@ Explosion::~Explosion()
  */
 const vector<Explosion*>& Explosion::explosions()
 {
-	return explosions_;
-}
-
-/** \brief A function to read the value of timealive.
- *
- * \return Returns the value of timealive.
- */
-double Explosion::timealive()
-{
-	return timealive_;
+	return WorldState::current().explosions;
 }
 
 /** \brief A function to animate the Explosion.
@@ -87,3 +73,23 @@ int Explosion::animate(double timediff)
 	}
 	return 0;
 }
+
+/** \brief A function to save the Explosion's state.
+ *
+ * \param r The record to save into.
+ */
+void Explosion::save(ObjectRecord &r)
+{
+	GameObject::save(r);
+	r.timealive = timealive_;
+}
+
+/** \brief A function to restore the Explosion's state.
+ *
+ * \param r The record to restore from.
+ */
+void Explosion::load(const ObjectRecord &r)
+{
+	GameObject::load(r);
+	timealive_ = r.timealive;
+}
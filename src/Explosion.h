@@ -26,12 +26,22 @@ public:
 	virtual ~Explosion();
 	
 	static const vector<Explosion*>& explosions();
-	virtual double timealive();
+	double timealive();
 	virtual int collision_detect(int scr) = 0;
-	virtual int animate(double timediff);
+	int animate(double timediff);
+	virtual void save(ObjectRecord &r);
+	virtual void load(const ObjectRecord &r);
 private:
-	static vector<Explosion*> explosions_;
 	double timealive_;
 };
 
+/** \brief A function to read the value of timealive.
+ *
+ * \return Returns the value of timealive.
+ */
+inline double Explosion::timealive()
+{
+	return timealive_;
+}
+
 #endif
@@ -5,78 +5,87 @@
  * \date May 2007
  */
 #include "GameObject.h"
+#include "SaveState.h"
+#include "WorldState.h"
 
 /** \brief Constructor for Explosion.
  *
- * The constructor initialises its variables.
+ * The constructor initialises its variables and issues the object's Handle.
  */
 GameObject::GameObject(double x, double y, double r)
 {
+#ifdef FIXED_POINT
+	x_ = to_fixed(x);
+	y_ = to_fixed(y);
+	radius_ = to_fixed(r);
+#else
 	x_ = x;
 	y_ = y;
 	radius_ = r;
+#endif
+	dead_ = false;
+	handle_ = HandleTable::add(this);
 }
 
 /** \brief Destructor for Explosion.
  *
- * The destructor does nothing fancy.
+ * The destructor invalidates the object's Handle.
  */
 GameObject::~GameObject()
 {
+	HandleTable::remove(handle_);
 }
 
-/** \brief A function to allow repositioning of objects.
+/** \brief Allocation function for all game objects.
  *
- * \param x New x co-ordinate.
- * \param y New y co-ordinate.
+ * The memory comes from the current WorldState's ObjectPool.
+ * \param size The size of the object.
+ * \return Returns the memory for the object.
  */
-void GameObject::position(double x, double y)
+void* GameObject::operator new(size_t size)
 {
-	x_ = x;
-	y_ = y;
+	return WorldState::current().pool.allocate(size);
 }
 
-/** \brief A function to return the x co-ordinate.
+/** \brief Deallocation function for all game objects.
  *
- * \return Returns the x co-ordinate, type double.
+ * \param p The memory of the object.
+ * \param size The size of the object.
  */
-double GameObject::x()
+void GameObject::operator delete(void *p, size_t size)
 {
-	return x_;
+	WorldState::current().pool.release(p, size);
 }
 
-/** \brief A function to return the y co-ordinate.
- *
- * \return Returns the y co-ordinate, type double.
+/** \brief A function to execute stuff on object death.
+ * 
+ * This function does nothing and is to be overridden by child classes if that class
+ * needs to do something on death, such as generate an explosion.
  */
-double GameObject::y()
+void GameObject::on_death()
 {
-	return y_;
 }
 
-/** \brief A function to return the radius of the object.
+/** \brief A function to save the object's state.
  *
- * \return Returns the radius, type double.
+ * Child classes extend this to save their own fields.
+ * \param r The record to save into, which starts zeroed.
  */
-double GameObject::radius()
+void GameObject::save(ObjectRecord &r)
 {
-	return radius_;
+	r.x = x();
+	r.y = y();
+	r.radius = radius();
 }
 
-/** \brief A function to change the radius of the object.
+/** \brief A function to restore the object's state.
  *
- * \param r The new radius, type double;
- */
-void GameObject::radius(double r)
-{
-	radius_ = r;
-}
-
-/** \brief A function to execute stuff on object death.
- * 
- * This function does nothing and is to be overridden by child classes if that class
- * needs to do something on death, such as generate an explosion.
+ * This is called on a newly constructed object to restore the fields that
+ * its constructor could not. Child classes extend this to restore their own.
+ * \param r The record to restore from.
  */
-void GameObject::on_death()
+void GameObject::load(const ObjectRecord &r)
 {
+	position(r.x, r.y);
+	radius(r.radius);
 }
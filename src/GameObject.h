@@ -10,11 +10,23 @@
 #include <Fl/Fl_Widget.H>
 
 #include "enum.h"
+#include "Handle.h"
+#include "fixed.h"
+
+struct ObjectRecord;
 
 /** \brief The GameObject class. The class all objects derive from.
  *
- * The GameObject class grants friend privileges to the Window class
- * for access to private functions such as draw().
+ * The GameObject class grants friend privileges to the World class
+ * for access to private functions. The accessors are not virtual and are
+ * defined in this header so the update loops can inline them; only death,
+ * saving and loading are overridden through a GameObject pointer. Each
+ * concrete class has its own non-virtual capture(), which World::publish()
+ * calls through that class's registry. When FIXED_POINT is
+ * defined the position and radius are stored in fixed point and the fx(),
+ * fy() and fradius() functions give access to the exact values. Objects are
+ * allocated from the current WorldState's ObjectPool, so they must be deleted
+ * while the same WorldState is current.
  */
 class GameObject
 {
@@ -22,20 +34,199 @@ public:
 	GameObject(double x, double y, double r);
 	virtual ~GameObject();
 
-	friend class Window;
+	static void* operator new(size_t size);
+	static void operator delete(void *p, size_t size);
+
+	friend class World;
+	friend class CommandBuffer;
 
-	virtual double x();
-	virtual double y();
-	virtual double radius();
+	double x();
+	double y();
+	double radius();
+#ifdef FIXED_POINT
+	fixed_t fx();
+	fixed_t fy();
+	fixed_t fradius();
+#endif
+	bool touching(GameObject *obj);
+	bool dead();
+	Handle handle();
 	virtual void on_death();
+	virtual void save(ObjectRecord &r);
+	virtual void load(const ObjectRecord &r);
 protected:
-	virtual void position(double x, double y);
-	virtual void draw() = 0;
-	virtual void radius(double r);
+	void position(double x, double y);
+#ifdef FIXED_POINT
+	void fposition(fixed_t x, fixed_t y);
+#endif
+	void radius(double r);
 private:
+#ifdef FIXED_POINT
+	fixed_t x_;
+	fixed_t y_;
+	fixed_t radius_;
+#else
 	double x_;
 	double y_;
 	double radius_;
+#endif
+	bool dead_;
+	Handle handle_;
 };
 
+/** \brief A function to allow repositioning of objects.
+ *
+ * \param x New x co-ordinate.
+ * \param y New y co-ordinate.
+ */
+inline void GameObject::position(double x, double y)
+{
+#ifdef FIXED_POINT
+	x_ = to_fixed(x);
+	y_ = to_fixed(y);
+#else
+	x_ = x;
+	y_ = y;
+#endif
+}
+
+#ifdef FIXED_POINT
+/** \brief A function to allow repositioning of objects in fixed point.
+ *
+ * \param x New x co-ordinate, type fixed_t.
+ * \param y New y co-ordinate, type fixed_t.
+ */
+inline void GameObject::fposition(fixed_t x, fixed_t y)
+{
+	x_ = x;
+	y_ = y;
+}
+#endif
+
+/** \brief A function to return the x co-ordinate.
+ *
+ * \return Returns the x co-ordinate, type double.
+ */
+inline double GameObject::x()
+{
+#ifdef FIXED_POINT
+	return from_fixed(x_);
+#else
+	return x_;
+#endif
+}
+
+/** \brief A function to return the y co-ordinate.
+ *
+ * \return Returns the y co-ordinate, type double.
+ */
+inline double GameObject::y()
+{
+#ifdef FIXED_POINT
+	return from_fixed(y_);
+#else
+	return y_;
+#endif
+}
+
+/** \brief A function to return the radius of the object.
+ *
+ * \return Returns the radius, type double.
+ */
+inline double GameObject::radius()
+{
+#ifdef FIXED_POINT
+	return from_fixed(radius_);
+#else
+	return radius_;
+#endif
+}
+
+/** \brief A function to change the radius of the object.
+ *
+ * \param r The new radius, type double;
+ */
+inline void GameObject::radius(double r)
+{
+#ifdef FIXED_POINT
+	radius_ = to_fixed(r);
+#else
+	radius_ = r;
+#endif
+}
+
+#ifdef FIXED_POINT
+/** \brief A function to return the fixed point x co-ordinate.
+ *
+ * \return Returns the x co-ordinate, type fixed_t.
+ */
+inline fixed_t GameObject::fx()
+{
+	return x_;
+}
+
+/** \brief A function to return the fixed point y co-ordinate.
+ *
+ * \return Returns the y co-ordinate, type fixed_t.
+ */
+inline fixed_t GameObject::fy()
+{
+	return y_;
+}
+
+/** \brief A function to return the fixed point radius of the object.
+ *
+ * \return Returns the radius, type fixed_t.
+ */
+inline fixed_t GameObject::fradius()
+{
+	return radius_;
+}
+#endif
+
+/** \brief A function to check if two objects are touching.
+ *
+ * Objects are touching if the distance between them is no more than the sum of
+ * their radii. In FIXED_POINT mode the squared distances are compared exactly
+ * in integers.
+ * \param obj The other object.
+ * \return Returns true if the objects are touching.
+ */
+inline bool GameObject::touching(GameObject *obj)
+{
+#ifdef FIXED_POINT
+	fixed_sq_t x_diff = (fixed_sq_t)obj->fx() - fx();
+	fixed_sq_t y_diff = (fixed_sq_t)obj->fy() - fy();
+	fixed_sq_t r = (fixed_sq_t)radius_ + obj->fradius();
+	return x_diff*x_diff + y_diff*y_diff <= r*r;
+#else
+	double x_diff = obj->x() - x();
+	double y_diff = obj->y() - y();
+	return x_diff*x_diff + y_diff*y_diff <= (radius()+obj->radius())*(radius()+obj->radius());
+#endif
+}
+
+/** \brief A function to check if the object is waiting to be deleted.
+ *
+ * Objects recorded for destruction in the CommandBuffer stay in the registries
+ * until the end of the update and should be skipped by anything looping over them.
+ * \return Returns true if the object has been destroyed.
+ */
+inline bool GameObject::dead()
+{
+	return dead_;
+}
+
+/** \brief A function to return the Handle of the object.
+ *
+ * The Handle can be kept instead of a pointer to the object and checked with
+ * HandleTable::valid() or HandleTable::lookup() after the object may have
+ * been destroyed.
+ * \return Returns the Handle of the object.
+ */
+inline Handle GameObject::handle()
+{
+	return handle_;
+}
+
 #endif
@@ -0,0 +1,141 @@
+/** \file Governor.cpp
+ * \brief Code implementation for Governor class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "Governor.h"
+
+/** \brief Constructor for Governor.
+ *
+ * The governor starts at the highest quality.
+ * \param budget Optional: The frame time budget in seconds, defaults to FRAME_BUDGET.
+ */
+Governor::Governor(double budget)
+{
+	budget_ = budget;
+	average_ = 0;
+	quality_ = QUALITY_MAX;
+	frames_over_ = 0;
+	frames_under_ = 0;
+}
+
+/** \brief Destructor for Governor.
+ *
+ * The destructor does nothing fancy.
+ */
+Governor::~Governor()
+{
+}
+
+/** \brief A function to set the frame time budget.
+ *
+ * \param b The budget in seconds, type double.
+ */
+void Governor::budget(double b)
+{
+	budget_ = b;
+}
+
+/** \brief A function to read the frame time budget.
+ *
+ * \return Returns the budget in seconds, type double.
+ */
+double Governor::budget()
+{
+	return budget_;
+}
+
+/** \brief A function to record the cost of a frame.
+ *
+ * The cost is averaged over recent frames. If the average stays over budget
+ * for GOVERNOR_DOWN_FRAMES frames in a row the quality drops a step; if it
+ * stays under GOVERNOR_UP_FRACTION of the budget for GOVERNOR_UP_FRAMES
+ * frames in a row the quality rises a step.
+ * \param draw_time The time in seconds spent drawing the frame.
+ * \param animate_time The time in seconds the simulation spent on the frame.
+ */
+void Governor::frame(double draw_time, double animate_time)
+{
+	double cost = draw_time + animate_time;
+	average_ = average_ + (cost - average_)*GOVERNOR_SMOOTHING;
+	if (average_ > budget_)
+	{
+		frames_under_ = 0;
+		frames_over_++;
+		if ((frames_over_ >= GOVERNOR_DOWN_FRAMES) && (quality_ > 0))
+		{
+			quality_--;
+			frames_over_ = 0;
+		}
+	}
+	else if (average_ < budget_*GOVERNOR_UP_FRACTION)
+	{
+		frames_over_ = 0;
+		frames_under_++;
+		if ((frames_under_ >= GOVERNOR_UP_FRAMES) && (quality_ < QUALITY_MAX))
+		{
+			quality_++;
+			frames_under_ = 0;
+		}
+	}
+	else
+	{
+		frames_over_ = 0;
+		frames_under_ = 0;
+	}
+}
+
+/** \brief A function to read the current quality.
+ *
+ * \return Returns the quality, from 0 (lowest) to QUALITY_MAX.
+ */
+int Governor::quality()
+{
+	return quality_;
+}
+
+/** \brief A function to read the average frame cost.
+ *
+ * \return Returns the average cost in seconds, type double.
+ */
+double Governor::average()
+{
+	return average_;
+}
+
+/** \brief A function to check if the background should be drawn from a cache.
+ *
+ * \return Returns true below the highest quality.
+ */
+bool Governor::background_cache()
+{
+	return quality_ < QUALITY_MAX;
+}
+
+/** \brief A function to read the most detail missile trails may be drawn with.
+ *
+ * \return Returns DETAIL_REDUCED at quality QUALITY_MAX - 2 and below, otherwise DETAIL_FULL.
+ */
+int Governor::trail_detail()
+{
+	return quality_ <= QUALITY_MAX - 2 ? DETAIL_REDUCED : DETAIL_FULL;
+}
+
+/** \brief A function to check if explosions should be filled.
+ *
+ * \return Returns false at quality QUALITY_MAX - 3 and below.
+ */
+bool Governor::explosion_fill()
+{
+	return quality_ > QUALITY_MAX - 3;
+}
+
+/** \brief A function to read how often the HUD should be redrawn.
+ *
+ * \return Returns the number of frames between HUD updates, 1 for every frame.
+ */
+int Governor::hud_interval()
+{
+	return quality_ <= QUALITY_MAX - 4 ? GOVERNOR_HUD_INTERVAL : 1;
+}
@@ -0,0 +1,47 @@
+/** \file Governor.h
+ * \brief Header file for Governor class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef GOVERNOR_H
+#define GOVERNOR_H
+
+#include "enum.h"
+
+/** \brief The Governor class.
+ *
+ * The Governor keeps drawing within a frame time budget. Each frame it is
+ * told how long drawing and the simulation took, and when the average goes
+ * over budget it lowers the render quality one step, turning on one more
+ * saving. It only raises the quality again once the average has stayed well
+ * under budget for a while, so it does not flicker between levels. Only
+ * drawing is affected; the simulation always runs in full.
+ *
+ * From the highest quality down the savings are: caching the background,
+ * short missile trails, unfilled explosions and a slower HUD refresh.
+ */
+class Governor
+{
+public:
+	Governor(double budget = FRAME_BUDGET);
+	virtual ~Governor();
+
+	virtual void budget(double b);
+	virtual double budget();
+	virtual void frame(double draw_time, double animate_time);
+	virtual int quality();
+	virtual double average();
+	virtual bool background_cache();
+	virtual int trail_detail();
+	virtual bool explosion_fill();
+	virtual int hud_interval();
+private:
+	double budget_;
+	double average_;
+	int quality_;
+	int frames_over_;
+	int frames_under_;
+};
+
+#endif
@@ -5,21 +5,16 @@
  * \date May 2007
  */
 #include "Gun.h"
+#include "WorldState.h"
+#include "SaveState.h"
+#include "View.h"
+#include "Canvas.h"
 
-#include <Fl/fl_draw.h>
 #include <math.h>
 
-/** \brief Global vector of pointers to all Gun objects.
- *
- * This vector stores pointers to all Gun objects. It is self-managed.
- * When a Gun object is created, it adds itself to the vector and when
- * it is destroyed it removes itself from the vector.
- */
-vector<Gun*> Gun::guns_;
-
 /** \brief Constructor for Gun.
  *
- * The constructor adds the Gun object to the global vector of guns.
+ * The constructor adds the Gun object to the current world's vector of guns.
  * To create an object, use "new Gun(...)" and the object can be 
  * accessed via the Gun::guns() function. The constructor also initialises
  * its variables.
@@ -28,9 +23,10 @@ Gun::Gun(double x, double y, double width) : PlayerItem(x, y, GUN_RADIUS)
 {
 	target_x_ = 0;
 	target_y_ = 0;
+	theta = 0;
 	barrel_width_ = width;
 	valid_target = false;
-	guns_.push_back(this);
+	WorldState::current().guns.push_back(this);
 }
 
 /** \brief Destructor for Gun.
@@ -40,12 +36,13 @@ Gun::Gun(double x, double y, double width) : PlayerItem(x, y, GUN_RADIUS)
  */
 Gun::~Gun()
 {
+	vector<Gun*> &guns = WorldState::current().guns;
 	vector<Gun*>::iterator it;
-	for(it = guns_.begin(); it != guns_.end(); it++)
+	for(it = guns.begin(); it != guns.end(); it++)
 	{
 		if((*it) == this)
 		{
-			guns_.erase(it);
+			guns.erase(it);
 			break;
 		}
 	}
@@ -60,13 +57,14 @@ Gun::~Gun()
  */
 const vector<Gun*>& Gun::guns()
 {
-	return guns_;
+	return WorldState::current().guns;
 }
 
 /** \brief A function to change the target location of the Gun.
  *
  * This function accepts the x and y co-ordinates of the new target for
- * the gun.
+ * the gun. It checks to see if the target is valid, sets the valid_target
+ * flag appropriately and aims the barrel if it is.
  * \param x The x co-ordinate of the new target, type double.
  * \param y The y co-ordinate of the new target, type double.
  */
@@ -74,6 +72,15 @@ void Gun::target(double x, double y)
 {
 	target_x_ = x;
 	target_y_ = y;
+	if (target_y() - this->y() < 0) // gun can't aim down
+	{
+		theta = atan((double)(target_x() - this->x()) / (double)(target_y() - this->y()));
+		valid_target = true;
+	}
+	else
+	{
+		valid_target = false;
+	}
 }
 
 /** \brief A function to read the x co-ordinate of the target.
@@ -121,51 +128,76 @@ void Gun::barrel_width(double width)
 	barrel_width_ = width;
 } 
 
-/** \brief The interface to draw the Gun.
+/** \brief The interface to capture the Gun for drawing.
  *
- * This protected draw() function calls the private draw_gun() function
- * to draw the object
+ * This protected capture() function adds the drawing state of the Gun
+ * to the snapshot.
+ * \param snap The snapshot being filled in.
  */
-void Gun::draw()
+void Gun::capture(Snapshot &snap)
 {
-	draw_gun();
+	GunState s;
+	s.handle = handle();
+	s.x = x();
+	s.y = y();
+	s.radius = radius();
+	s.theta = theta;
+	s.barrel_width = barrel_width();
+	snap.guns.push_back(s);
 }
 
 /** \brief The specialised drawing function for Gun.
  *
- * The draw_gun() function uses the FLTK routines to draw the Gun in
- * the form of a turret. It checks to see if the target is valid and
- * sets the valid_target flag appropriately.
+ * The draw_gun() function uses the FLTK routines to draw a captured Gun in
+ * the form of a turret, with the barrel at the angle set by target().
+ * \param s The drawing state of the Gun.
  */
-void Gun::draw_gun()
+void Gun::draw_gun(const GunState &s)
 {
+	const View &v = View::current();
+	Canvas &canvas = Canvas::current();
 #ifdef DEBUG // draw collision radius
-	fl_color(FL_RED);
-	fl_circle(x(), y(), radius());
+	canvas.color(FL_RED);
+	canvas.circle(v.x(s.x), v.y(s.y), v.size(s.radius));
 #endif
-	if (target_y() - y() < 0) // gun can't aim down
-	{
-		theta = atan((double)(target_x() - x()) / (double)(target_y() - y()));
-		valid_target = true;
-	}
-	else
-	{
-		valid_target = false;
-	}
-	
-	fl_color(FL_BLACK);
-	fl_begin_polygon(); // draw barrel
-	fl_begin_loop();
-	fl_vertex(x()+barrel_width()/2*cos(theta),y()-barrel_width()/2*sin(theta));
-	fl_vertex(x()-barrel_width()/2*cos(theta),y()+barrel_width()/2*sin(theta));
-	fl_vertex(x()-barrel_width()/2*cos(theta)-BARREL_LENGTH*sin(theta), y()+barrel_width()/2*sin(theta)-BARREL_LENGTH*cos(theta));
-	fl_vertex(x()+barrel_width()/2*cos(theta)-BARREL_LENGTH*sin(theta), y()-barrel_width()/2*sin(theta)-BARREL_LENGTH*cos(theta));
-	fl_end_loop();
-	fl_end_polygon();
+	canvas.color(FL_BLACK);
+	canvas.begin_polygon(); // draw barrel
+	canvas.begin_loop();
+	canvas.vertex(v.x(s.x+s.barrel_width/2*cos(s.theta)), v.y(s.y-s.barrel_width/2*sin(s.theta)));
+	canvas.vertex(v.x(s.x-s.barrel_width/2*cos(s.theta)), v.y(s.y+s.barrel_width/2*sin(s.theta)));
+	canvas.vertex(v.x(s.x-s.barrel_width/2*cos(s.theta)-BARREL_LENGTH*sin(s.theta)), v.y(s.y+s.barrel_width/2*sin(s.theta)-BARREL_LENGTH*cos(s.theta)));
+	canvas.vertex(v.x(s.x+s.barrel_width/2*cos(s.theta)-BARREL_LENGTH*sin(s.theta)), v.y(s.y-s.barrel_width/2*sin(s.theta)-BARREL_LENGTH*cos(s.theta)));
+	canvas.end_loop();
+	canvas.end_polygon();
 	
-	fl_color(FL_DARK_GREY);
+	canvas.color(FL_DARK_GREY);
 	// draw base of gun
-	fl_pie((int)x()-GUN_BASE_RADIUS/2, (int)y()-GUN_BASE_RADIUS/4, GUN_BASE_RADIUS, GUN_BASE_RADIUS, 0, 180);
-	fl_color(FL_BLACK);
-	fl_circle(x(),y(),2); // draw pivot pin
+	canvas.pie((int)v.x(s.x-GUN_BASE_RADIUS/2), (int)v.y(s.y-GUN_BASE_RADIUS/4), (int)v.size(GUN_BASE_RADIUS), (int)v.size(GUN_BASE_RADIUS), 0, 180);
+	canvas.color(FL_BLACK);
+	canvas.circle(v.x(s.x), v.y(s.y), v.size(2)); // draw pivot pin
+}
+
+/** \brief A function to save the Gun's state.
+ *
+ * \param r The record to save into.
+ */
+void Gun::save(ObjectRecord &r)
+{
+	PlayerItem::save(r);
+	r.type = OBJECT_GUN;
+	r.target_x = target_x();
+	r.target_y = target_y();
+	r.barrel_width = barrel_width();
+}
+
+/** \brief A function to restore the Gun's state.
+ *
+ * The barrel is re-aimed at the saved target.
+ * \param r The record to restore from.
+ */
+void Gun::load(const ObjectRecord &r)
+{
+	PlayerItem::load(r);
+	barrel_width(r.barrel_width);
+	target(r.target_x, r.target_y);
 }
@@ -8,6 +8,7 @@
 #define GUN_H
 
 #include "PlayerItem.h"
+#include "Snapshot.h"
 
 #include "enum.h"
 
@@ -24,6 +25,8 @@ public:
 	Gun(double x, double y, double width);
 	virtual ~Gun();
 
+	friend class World;
+
 	static const vector<Gun*>& guns();
 	virtual void target(double x, double y);
 	virtual double target_x();
@@ -31,11 +34,12 @@ public:
 	virtual bool target_valid();
 	virtual double barrel_width();
 	virtual void barrel_width(double width);
+	static void draw_gun(const GunState &s);
+	virtual void save(ObjectRecord &r);
+	virtual void load(const ObjectRecord &r);
 protected:
-	virtual void draw();
+	void capture(Snapshot &snap);
 private:
-	static vector<Gun*> guns_;
-	virtual void draw_gun();
 	double target_x_;
 	double target_y_;
 	double theta;
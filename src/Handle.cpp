@@ -0,0 +1,130 @@
+/** \file Handle.cpp
+ * \brief Code implementation for HandleTable class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "Handle.h"
+#include "WorldState.h"
+
+/** \brief A function to issue a handle for a new object.
+ *
+ * Slot 0 is never used so that no valid handle is ever 0.
+ * \param obj The object to issue the handle for.
+ * \return Returns the new handle, or NULL_HANDLE if the table is full.
+ */
+Handle HandleTable::add(GameObject *obj)
+{
+	WorldState &w = WorldState::current();
+	vector<HandleSlot> &slots = w.handle_slots;
+	unsigned int &free_head = w.handle_free_head;
+	unsigned int &free_tail = w.handle_free_tail;
+	if (slots.empty())
+	{
+		HandleSlot reserved = {0, 0, 0};
+		slots.push_back(reserved);
+	}
+	unsigned int index;
+	if (free_head != 0)
+	{
+		index = free_head;
+		free_head = slots[index].next_free;
+		if (free_head == 0)
+		{
+			free_tail = 0;
+		}
+	}
+	else
+	{
+		index = slots.size();
+		if (index > HANDLE_INDEX_MASK) // table full, the object gets no handle
+		{
+			return NULL_HANDLE;
+		}
+		HandleSlot s = {0, 1, 0};
+		slots.push_back(s);
+	}
+	slots[index].object = obj;
+	return index | (slots[index].generation << HANDLE_INDEX_BITS);
+}
+
+/** \brief A function to invalidate a handle when its object is destroyed.
+ *
+ * \param h The handle of the object being destroyed.
+ */
+void HandleTable::remove(Handle h)
+{
+	if (!valid(h))
+	{
+		return;
+	}
+	WorldState &w = WorldState::current();
+	vector<HandleSlot> &slots = w.handle_slots;
+	unsigned int &free_tail = w.handle_free_tail;
+	unsigned int index = h & HANDLE_INDEX_MASK;
+	HandleSlot &s = slots[index];
+	s.object = 0;
+	s.generation = (s.generation + 1) & HANDLE_GENERATION_MASK;
+	if (s.generation == 0) // 0 is reserved so handles are never NULL_HANDLE
+	{
+		s.generation = 1;
+	}
+	s.next_free = 0;
+	if (free_tail != 0)
+	{
+		slots[free_tail].next_free = index;
+	}
+	else
+	{
+		w.handle_free_head = index;
+	}
+	free_tail = index;
+}
+
+/** \brief A function to check if a handle still refers to a live object.
+ *
+ * \param h The handle to check.
+ * \return Returns true if the object has not been destroyed.
+ */
+bool HandleTable::valid(Handle h)
+{
+	const vector<HandleSlot> &slots = WorldState::current().handle_slots;
+	unsigned int index = h & HANDLE_INDEX_MASK;
+	return (index != 0) && (index < slots.size()) && (slots[index].object != 0)
+		&& (slots[index].generation == (h >> HANDLE_INDEX_BITS));
+}
+
+/** \brief A function to get the object a handle refers to.
+ *
+ * \param h The handle to look up.
+ * \return Returns the object, or 0 if the handle is no longer valid.
+ */
+GameObject* HandleTable::lookup(Handle h)
+{
+	return valid(h) ? WorldState::current().handle_slots[h & HANDLE_INDEX_MASK].object : 0;
+}
+
+/** \brief A function to point a handle at an object that has been moved.
+ *
+ * \param h The handle of the object.
+ * \param obj The object's new address.
+ */
+void HandleTable::move(Handle h, GameObject *obj)
+{
+	if (valid(h))
+	{
+		WorldState::current().handle_slots[h & HANDLE_INDEX_MASK].object = obj;
+	}
+}
+
+/** \brief A function to get the slot index of a handle.
+ *
+ * Indices of live objects are unique and small, so they can be used to index
+ * arrays holding per-object data.
+ * \param h The handle.
+ * \return Returns the slot index.
+ */
+unsigned int HandleTable::index(Handle h)
+{
+	return h & HANDLE_INDEX_MASK;
+}
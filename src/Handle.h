@@ -0,0 +1,57 @@
+/** \file Handle.h
+ * \brief Header file for Handle type and HandleTable class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef HANDLE_H
+#define HANDLE_H
+
+#include "enum.h"
+
+class GameObject;
+
+/** \brief A 32 bit generational reference to a GameObject.
+ *
+ * The low HANDLE_INDEX_BITS bits are a slot in the HandleTable and the
+ * remaining bits are the generation of that slot when the handle was issued.
+ * When an object is deleted its slot's generation is incremented, so any
+ * handle still referring to it stops being valid. Handle 0 is never issued.
+ */
+typedef unsigned int Handle;
+
+#define NULL_HANDLE 0
+#define HANDLE_INDEX_BITS 20
+#define HANDLE_INDEX_MASK ((1u << HANDLE_INDEX_BITS) - 1)
+#define HANDLE_GENERATION_MASK ((1u << (32 - HANDLE_INDEX_BITS)) - 1)
+
+/** \brief A slot in the HandleTable, either in use or on the free list.
+ */
+struct HandleSlot
+{
+	GameObject *object;
+	unsigned int generation;
+	unsigned int next_free;
+};
+
+/** \brief The HandleTable class.
+ *
+ * The HandleTable maps Handles to live GameObject pointers. Every GameObject
+ * adds itself when it is created and removes itself when it is destroyed, so
+ * a Handle can be kept anywhere (caches, snapshots, command buffers) and
+ * checked or looked up in constant time without scanning the registries.
+ * Freed slots are reused oldest first so a slot's generation wraps as
+ * slowly as possible. The table belongs to the current WorldState.
+ */
+class HandleTable
+{
+public:
+	static Handle add(GameObject *obj);
+	static void remove(Handle h);
+	static bool valid(Handle h);
+	static GameObject* lookup(Handle h);
+	static void move(Handle h, GameObject *obj);
+	static unsigned int index(Handle h);
+};
+
+#endif
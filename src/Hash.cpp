@@ -0,0 +1,160 @@
+/** \file Hash.cpp
+ * \brief Code implementation for Hash class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "Hash.h"
+
+#include <string.h>
+
+#define PRIME1 2654435761u
+#define PRIME2 2246822519u
+#define PRIME3 3266489917u
+#define PRIME4 668265263u
+#define PRIME5 374761393u
+
+/** \brief A function to rotate a 32 bit value left.
+ */
+static inline unsigned int rotl(unsigned int x, int r)
+{
+	return (x << r) | (x >> (32 - r));
+}
+
+/** \brief A function to read 4 bytes as an unsigned int.
+ */
+static inline unsigned int read32(const unsigned char *p)
+{
+	unsigned int v;
+	memcpy(&v, p, 4);
+	return v;
+}
+
+/** \brief A function to mix 4 bytes into an accumulator.
+ */
+static inline unsigned int round(unsigned int acc, unsigned int input)
+{
+	acc = acc + input*PRIME2;
+	acc = rotl(acc, 13);
+	return acc*PRIME1;
+}
+
+/** \brief Constructor for Hash.
+ *
+ * \param seed Optional: A value to start the hash from, defaults to 0.
+ */
+Hash::Hash(unsigned int seed)
+{
+	seed_ = seed;
+	acc_[0] = seed + PRIME1 + PRIME2;
+	acc_[1] = seed + PRIME2;
+	acc_[2] = seed;
+	acc_[3] = seed - PRIME1;
+	buffered_ = 0;
+	total_ = 0;
+}
+
+/** \brief A function to add bytes to the hash.
+ *
+ * \param data The bytes.
+ * \param length The number of bytes.
+ */
+void Hash::add(const void *data, unsigned int length)
+{
+	const unsigned char *p = (const unsigned char*)data;
+	total_ = total_ + length;
+	if (buffered_ + length < 16)
+	{
+		memcpy(buffer_ + buffered_, p, length);
+		buffered_ = buffered_ + length;
+		return;
+	}
+	if (buffered_ > 0)
+	{
+		unsigned int fill = 16 - buffered_;
+		memcpy(buffer_ + buffered_, p, fill);
+		stripe(buffer_);
+		p = p + fill;
+		length = length - fill;
+		buffered_ = 0;
+	}
+	while (length >= 16)
+	{
+		stripe(p);
+		p = p + 16;
+		length = length - 16;
+	}
+	memcpy(buffer_, p, length);
+	buffered_ = length;
+}
+
+/** \brief A function to add an int to the hash.
+ */
+void Hash::add(int value)
+{
+	add(&value, sizeof(value));
+}
+
+/** \brief A function to add an unsigned int to the hash.
+ */
+void Hash::add(unsigned int value)
+{
+	add(&value, sizeof(value));
+}
+
+/** \brief A function to add a double to the hash.
+ *
+ * The bits are hashed, so 0 and -0 differ.
+ */
+void Hash::add(double value)
+{
+	add(&value, sizeof(value));
+}
+
+/** \brief A function to return the hash of the bytes added so far.
+ *
+ * More bytes can still be added afterwards.
+ * \return Returns the hash.
+ */
+unsigned int Hash::value() const
+{
+	unsigned int h;
+	if (total_ >= 16)
+	{
+		h = rotl(acc_[0], 1) + rotl(acc_[1], 7) + rotl(acc_[2], 12) + rotl(acc_[3], 18);
+	}
+	else
+	{
+		h = seed_ + PRIME5;
+	}
+	h = h + total_;
+	unsigned int i = 0;
+	for (; i + 4 <= buffered_; i = i + 4)
+	{
+		h = h + read32(buffer_ + i)*PRIME3;
+		h = rotl(h, 17)*PRIME4;
+	}
+	for (; i < buffered_; i++)
+	{
+		h = h + buffer_[i]*PRIME5;
+		h = rotl(h, 11)*PRIME1;
+	}
+	h = h ^ (h >> 15);
+	h = h*PRIME2;
+	h = h ^ (h >> 13);
+	h = h*PRIME3;
+	h = h ^ (h >> 16);
+	return h;
+}
+
+/** \brief A function to mix a 16 byte stripe into the accumulators.
+ *
+ * \param p The stripe.
+ */
+void Hash::stripe(const unsigned char *p)
+{
+	acc_[0] = round(acc_[0], read32(p));
+	acc_[1] = round(acc_[1], read32(p + 4));
+	acc_[2] = round(acc_[2], read32(p + 8));
+	acc_[3] = round(acc_[3], read32(p + 12));
+}
@@ -0,0 +1,38 @@
+/** \file Hash.h
+ * \brief Header file for Hash class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef HASH_H
+#define HASH_H
+
+/** \brief The Hash class.
+ *
+ * The Hash class is a fast 32 bit hash of a stream of bytes, built up a
+ * piece at a time. It follows the xxHash32 algorithm, so hashing bytes in
+ * one piece or many gives the same value, as xxHash32 would. It is not
+ * meant to be secure, only to make any change to its input show. Values are
+ * hashed as they are stored in memory, so only the same kind of machine
+ * gives the same hash.
+ */
+class Hash
+{
+public:
+	Hash(unsigned int seed = 0);
+
+	void add(const void *data, unsigned int length);
+	void add(int value);
+	void add(unsigned int value);
+	void add(double value);
+	unsigned int value() const;
+private:
+	void stripe(const unsigned char *p);
+	unsigned int seed_;
+	unsigned int acc_[4];
+	unsigned char buffer_[16]; ///< bytes not yet making up a whole stripe
+	unsigned int buffered_;
+	unsigned int total_;       ///< bytes added, modulo 2^32
+};
+
+#endif
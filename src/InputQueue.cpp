@@ -0,0 +1,105 @@
+/** \file InputQueue.cpp
+ * \brief Code implementation for InputQueue class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "InputQueue.h"
+
+#include <Fl/Fl.H>
+
+/** \brief Constructor for InputQueue.
+ *
+ * The constructor creates an empty queue.
+ */
+InputQueue::InputQueue()
+{
+	move_.type = FL_MOVE;
+	move_.x = 0;
+	move_.y = 0;
+	move_pending_ = false;
+	held_.reserve(INPUT_QUEUE_SIZE);
+}
+
+/** \brief Destructor for InputQueue.
+ *
+ * The destructor does nothing fancy.
+ */
+InputQueue::~InputQueue()
+{
+}
+
+/** \brief A function to add an event to the queue.
+ *
+ * Only the FLTK thread may call this function. FL_MOVE and FL_DRAG events
+ * are treated the same and only remember the latest position, which is
+ * queued by flush(). Any other event flushes the pending movement first so
+ * the order of events is preserved. If the queue is full the event is held
+ * until flush() finds room for it.
+ * \param type The FLTK event number.
+ * \param x The x co-ordinate of the mouse, or the key for key events.
+ * \param y The y co-ordinate of the mouse.
+ * \return Returns true if the event was queued or held, false if it was a
+ *	click refused because too many events are already held.
+ */
+bool InputQueue::push(int type, int x, int y)
+{
+	if ((type == FL_MOVE) || (type == FL_DRAG))
+	{
+		move_.x = x;
+		move_.y = y;
+		move_pending_ = true;
+		return true;
+	}
+	flush();
+	InputEvent e;
+	e.type = type;
+	e.x = x;
+	e.y = y;
+	if (!move_pending_ && held_.empty() && queue_.push(e))
+	{
+		return true;
+	}
+	if ((type != FL_KEYDOWN) && (held_.size() >= INPUT_QUEUE_SIZE))
+	{
+		return false;
+	}
+	if (move_pending_) // it must still arrive before this event
+	{
+		held_.push_back(move_);
+		move_pending_ = false;
+	}
+	held_.push_back(e);
+	return true;
+}
+
+/** \brief A function to queue the latest mouse movement, if any.
+ *
+ * Only the FLTK thread may call this function. It should be called once per
+ * frame. Held events are queued first. Whatever still does not fit is kept
+ * and retried next time.
+ */
+void InputQueue::flush()
+{
+	unsigned int n = 0;
+	while ((n < held_.size()) && queue_.push(held_[n]))
+	{
+		n++;
+	}
+	held_.erase(held_.begin(), held_.begin() + n);
+	if (move_pending_ && held_.empty() && queue_.push(move_))
+	{
+		move_pending_ = false;
+	}
+}
+
+/** \brief A function to remove the oldest event from the queue.
+ *
+ * Only the simulation thread may call this function.
+ * \param e The event to copy the oldest event into.
+ * \return Returns true if an event was removed, false if the queue was empty.
+ */
+bool InputQueue::pop(InputEvent &e)
+{
+	return queue_.pop(e);
+}
@@ -0,0 +1,55 @@
+/** \file InputQueue.h
+ * \brief Header file for InputQueue class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef INPUTQUEUE_H
+#define INPUTQUEUE_H
+
+#include "enum.h"
+#include "SpscQueue.h"
+
+/** \brief A single buffered input event.
+ *
+ * The type is the FLTK event number (FL_MOVE, FL_PUSH, FL_KEYDOWN etc). For
+ * mouse events x, y are the mouse co-ordinates at the time the event was
+ * generated, for key events x is the key.
+ */
+struct InputEvent
+{
+	int type;
+	int x;
+	int y;
+};
+
+/** \brief The InputQueue class.
+ *
+ * The InputQueue class passes input events from the FLTK thread to the
+ * simulation thread without locking. Mouse movements are held back by the
+ * producer and only the latest position is queued, when flush() is called
+ * once per frame or just before the next click or key press. Clicks and key
+ * presses are queued in order with their exact positions.
+ *
+ * If the simulation falls behind and the queue fills up, events are held by
+ * the producer and queued by later calls to flush(), still in order. Key
+ * presses are always held, so Escape is never lost, but once INPUT_QUEUE_SIZE
+ * events are held further clicks are refused.
+ */
+class InputQueue
+{
+public:
+	InputQueue();
+	virtual ~InputQueue();
+
+	virtual bool push(int type, int x, int y);
+	virtual void flush();
+	virtual bool pop(InputEvent &e);
+private:
+	SpscQueue<InputEvent, INPUT_QUEUE_SIZE> queue_;
+	InputEvent move_;
+	bool move_pending_;
+	vector<InputEvent> held_; ///< events waiting for room in the queue, oldest first
+};
+
+#endif
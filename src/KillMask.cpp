@@ -0,0 +1,312 @@
+/** \file KillMask.cpp
+ * \brief Code implementation for KillMask class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "KillMask.h"
+
+#include <math.h>
+
+#include "ShellExplosion.h"
+#include "EnemyItem.h"
+
+/** \brief Constructor for KillMask.
+ *
+ * The grid is sized for the world once, and room is reserved for
+ * KILL_MASK_RESERVE edge cells and WORLD_RESERVE explosions, so marking
+ * explosions does not allocate during play.
+ */
+KillMask::KillMask()
+{
+	cols_ = (WORLD_WIDTH + KILL_MASK_CELL - 1)/KILL_MASK_CELL;
+	rows_ = (WORLD_HEIGHT + KILL_MASK_CELL - 1)/KILL_MASK_CELL;
+	full_.assign(cols_*rows_, 0);
+	head_.assign(cols_*rows_, -1);
+	entries_.reserve(KILL_MASK_RESERVE);
+	free_ = -1;
+	marks_.reserve(WORLD_RESERVE);
+}
+
+/** \brief Destructor for KillMask.
+ */
+KillMask::~KillMask()
+{
+}
+
+/** \brief A function to mark an explosion on the mask, or bring its mark up to date.
+ *
+ * An explosion already marked at the same place with a radius no larger
+ * only has the cells its growth changes updated. Otherwise its old mark is
+ * removed first.
+ * \param e The explosion.
+ */
+void KillMask::add(ShellExplosion *e)
+{
+	int m = e->mask_mark_;
+	if (m >= 0)
+	{
+		const Mark &old = marks_[m];
+		if ((old.x == e->x()) && (old.y == e->y()) && (old.radius <= e->radius()))
+		{
+			if (old.radius < e->radius())
+			{
+				mark(m, e->radius());
+			}
+			return;
+		}
+		remove(e);
+	}
+	Mark k;
+	k.explosion = e;
+	k.x = e->x();
+	k.y = e->y();
+	k.radius = -1;
+	e->mask_mark_ = marks_.size();
+	marks_.push_back(k);
+	mark(e->mask_mark_, e->radius());
+}
+
+/** \brief A function to take an explosion off the mask.
+ *
+ * Does nothing if the explosion is not on it.
+ * \param e The explosion.
+ */
+void KillMask::remove(ShellExplosion *e)
+{
+	int m = e->mask_mark_;
+	if (m < 0)
+	{
+		return;
+	}
+	const Mark &k = marks_[m];
+	double reach = k.radius + KILL_MASK_MARGIN + 1;
+	int c_min = (int)floor((k.x - reach)/KILL_MASK_CELL) - 1; // a cell to spare against rounding
+	int c_max = (int)floor((k.x + reach)/KILL_MASK_CELL) + 1;
+	int r_min = (int)floor((k.y - reach)/KILL_MASK_CELL) - 1;
+	int r_max = (int)floor((k.y + reach)/KILL_MASK_CELL) + 1;
+	for (int row = (r_min < 0) ? 0 : r_min; (row <= r_max) && (row < rows_); row++)
+	{
+		for (int col = (c_min < 0) ? 0 : c_min; (col <= c_max) && (col < cols_); col++)
+		{
+			int cell = classify(k.x, k.y, k.radius, row, col);
+			if (cell == CELL_FULL)
+			{
+				full_[row*cols_ + col]--;
+			}
+			else if (cell == CELL_EDGE)
+			{
+				unlink(row*cols_ + col, e);
+			}
+		}
+	}
+	marks_[m] = marks_.back();
+	marks_[m].explosion->mask_mark_ = m;
+	marks_.pop_back();
+	e->mask_mark_ = -1;
+}
+
+/** \brief A function to grow a mark to a larger radius.
+ *
+ * Only cells that change are touched. Cells that were full stay full, and
+ * the run of them across each row is skipped without being looked at.
+ * \param m The index of the mark.
+ * \param r The new radius, no smaller than the marked one.
+ */
+void KillMask::mark(int m, double r)
+{
+	Mark &k = marks_[m];
+	bool fresh = (k.radius < 0);
+	double reach = r + KILL_MASK_MARGIN + 1;
+	int c_min = (int)floor((k.x - reach)/KILL_MASK_CELL) - 1; // a cell to spare against rounding
+	int c_max = (int)floor((k.x + reach)/KILL_MASK_CELL) + 1;
+	int r_min = (int)floor((k.y - reach)/KILL_MASK_CELL) - 1;
+	int r_max = (int)floor((k.y + reach)/KILL_MASK_CELL) + 1;
+	for (int row = (r_min < 0) ? 0 : r_min; (row <= r_max) && (row < rows_); row++)
+	{
+		int skip_first = 0;
+		int skip_last = -1;
+		if (!fresh)
+		{
+			full_span(k.x, k.y, k.radius, row, skip_first, skip_last);
+		}
+		for (int col = (c_min < 0) ? 0 : c_min; (col <= c_max) && (col < cols_); col++)
+		{
+			if ((col == skip_first) && (skip_first <= skip_last))
+			{
+				col = skip_last;
+				continue;
+			}
+			int was = fresh ? CELL_EMPTY : classify(k.x, k.y, k.radius, row, col);
+			int now = classify(k.x, k.y, r, row, col);
+			if (now == was)
+			{
+				continue;
+			}
+			int i = row*cols_ + col;
+			if (was == CELL_EDGE)
+			{
+				unlink(i, k.explosion);
+			}
+			if (now == CELL_FULL)
+			{
+				full_[i]++;
+			}
+			else
+			{
+				link(i, k.explosion);
+			}
+		}
+	}
+	k.radius = r;
+}
+
+/** \brief A function to work out what an explosion makes of a cell.
+ *
+ * Cells are classified with a unit to spare on each side, so rounding can
+ * only make a cell an edge cell, never give a wrong answer. A larger radius
+ * never gives a lesser answer.
+ * \param x The x co-ordinate of the explosion.
+ * \param y The y co-ordinate of the explosion.
+ * \param r The radius of the explosion.
+ * \param row The row of the cell.
+ * \param col The column of the cell.
+ * \return Returns CELL_FULL if every enemy centred in the cell touches the
+ *	explosion, CELL_EMPTY if none can, otherwise CELL_EDGE.
+ */
+int KillMask::classify(double x, double y, double r, int row, int col)
+{
+	const double cell = KILL_MASK_CELL;
+	double reach = r + KILL_MASK_MARGIN + 1; // no enemy centred further away can touch
+	double inner = r - 1;                    // every enemy centred closer does touch
+	double top = row*cell - y;
+	double bottom = top + cell;
+	double near_y = (top > 0) ? top : ((bottom < 0) ? -bottom : 0);
+	double far_y = (-top > bottom) ? -top : bottom;
+	double left = col*cell - x;
+	double right = left + cell;
+	double near_x = (left > 0) ? left : ((right < 0) ? -right : 0);
+	double far_x = (-left > right) ? -left : right;
+	if (near_x*near_x + near_y*near_y > reach*reach)
+	{
+		return CELL_EMPTY;
+	}
+	if ((inner > 0) && (far_x*far_x + far_y*far_y <= inner*inner))
+	{
+		return CELL_FULL;
+	}
+	return CELL_EDGE;
+}
+
+/** \brief A function to find the cells of a row an explosion makes full.
+ *
+ * The full cells of a row are always one run. The run is estimated and
+ * then trimmed until classify() agrees at both ends.
+ * \param x The x co-ordinate of the explosion.
+ * \param y The y co-ordinate of the explosion.
+ * \param r The radius of the explosion.
+ * \param row The row.
+ * \param first Set to the first full column.
+ * \param last Set to the last full column, less than first if there are none.
+ */
+void KillMask::full_span(double x, double y, double r, int row, int &first, int &last)
+{
+	const double cell = KILL_MASK_CELL;
+	double inner = r - 1;
+	double top = row*cell - y;
+	double far_y = (-top > top + cell) ? -top : top + cell;
+	first = 0;
+	last = -1;
+	if ((inner <= 0) || (far_y >= inner))
+	{
+		return;
+	}
+	double half = sqrt(inner*inner - far_y*far_y);
+	first = (int)ceil((x - half)/cell);
+	last = (int)floor((x + half)/cell) - 1;
+	first = (first < 0) ? 0 : first;
+	last = (last >= cols_) ? cols_ - 1 : last;
+	while ((first <= last) && (classify(x, y, r, row, first) != CELL_FULL))
+	{
+		first++;
+	}
+	while ((last >= first) && (classify(x, y, r, row, last) != CELL_FULL))
+	{
+		last--;
+	}
+}
+
+/** \brief A function to list an explosion against an edge cell.
+ *
+ * \param cell The index of the cell.
+ * \param e The explosion.
+ */
+void KillMask::link(int cell, ShellExplosion *e)
+{
+	int j = free_;
+	if (j >= 0)
+	{
+		free_ = entries_[j].next;
+	}
+	else
+	{
+		j = entries_.size();
+		entries_.push_back(Entry());
+	}
+	entries_[j].explosion = e;
+	entries_[j].next = head_[cell];
+	head_[cell] = j;
+}
+
+/** \brief A function to take an explosion off an edge cell's list.
+ *
+ * \param cell The index of the cell.
+ * \param e The explosion, which must be on the list.
+ */
+void KillMask::unlink(int cell, ShellExplosion *e)
+{
+	int *p = &head_[cell];
+	while (entries_[*p].explosion != e)
+	{
+		p = &entries_[*p].next;
+	}
+	int j = *p;
+	*p = entries_[j].next;
+	entries_[j].next = free_;
+	free_ = j;
+}
+
+/** \brief A function to check if an enemy touches any explosion on the mask.
+ *
+ * \param e The enemy.
+ * \return Returns true if the enemy touches an explosion on the mask.
+ */
+bool KillMask::hit(EnemyItem *e)
+{
+	int col = (int)floor(e->x()/KILL_MASK_CELL);
+	int row = (int)floor(e->y()/KILL_MASK_CELL);
+	if ((e->radius() > KILL_MASK_MARGIN) || (col < 0) || (col >= cols_) || (row < 0) || (row >= rows_))
+	{
+		for (unsigned int i = 0; i < marks_.size(); i++)
+		{
+			if (marks_[i].explosion->touching(e))
+			{
+				return true;
+			}
+		}
+		return false;
+	}
+	int i = row*cols_ + col;
+	if (full_[i])
+	{
+		return true;
+	}
+	for (int j = head_[i]; j >= 0; j = entries_[j].next)
+	{
+		if (entries_[j].explosion->touching(e))
+		{
+			return true;
+		}
+	}
+	return false;
+}
@@ -0,0 +1,76 @@
+/** \file KillMask.h
+ * \brief Header file for KillMask class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef KILLMASK_H
+#define KILLMASK_H
+
+#include "enum.h"
+
+class ShellExplosion;
+class EnemyItem;
+
+/** \brief The KillMask class.
+ *
+ * The KillMask class answers which EnemyItem objects touch any ShellExplosion
+ * without testing every enemy against every explosion. The explosions are
+ * marked on a coarse grid of KILL_MASK_CELL unit cells covering the world. A
+ * cell is full if it lies wholly inside an explosion, so any enemy centred
+ * in it is hit. A cell near the edge of an explosion lists the explosions it
+ * is near, and only those are tested exactly. Every other cell is empty.
+ * Looking up an enemy then costs the same however many explosions there are.
+ *
+ * Explosions stay marked between updates. As one grows only the cells whose
+ * state changes are visited, skipping those it already covered, and it is
+ * only unmarked cell by cell when it shrinks, moves, dies or is deleted.
+ *
+ * The answers are exactly those of GameObject::touching(). Enemies centred
+ * outside the world, or larger than KILL_MASK_MARGIN, are tested against
+ * every explosion instead.
+ */
+class KillMask
+{
+public:
+	KillMask();
+	virtual ~KillMask();
+
+	virtual void add(ShellExplosion *e);
+	virtual void remove(ShellExplosion *e);
+	virtual bool hit(EnemyItem *e);
+private:
+	/** \brief What an explosion makes of a cell.
+	 */
+	enum {CELL_EMPTY = 0, CELL_EDGE, CELL_FULL};
+	/** \brief An explosion listed against an edge cell.
+	 */
+	struct Entry
+	{
+		ShellExplosion *explosion;
+		int next; ///< next entry for the same cell, or the next unused entry, -1 if none
+	};
+	/** \brief An explosion on the mask, as it was marked.
+	 */
+	struct Mark
+	{
+		ShellExplosion *explosion;
+		double x;
+		double y;
+		double radius; ///< negative before anything is marked
+	};
+	void mark(int m, double r);
+	int classify(double x, double y, double r, int row, int col);
+	void full_span(double x, double y, double r, int row, int &first, int &last);
+	void link(int cell, ShellExplosion *e);
+	void unlink(int cell, ShellExplosion *e);
+	int cols_;
+	int rows_;
+	vector<int> full_;           ///< explosions each cell lies wholly inside
+	vector<int> head_;           ///< first entry for each cell, -1 if none
+	vector<Entry> entries_;
+	int free_;                   ///< first unused entry, -1 if none
+	vector<Mark> marks_;         ///< every explosion on the mask
+};
+
+#endif
@@ -0,0 +1,142 @@
+/** \file MappedFile.cpp
+ * \brief Code implementation for MappedFile class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "MappedFile.h"
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+/** \brief Constructor for MappedFile.
+ *
+ * The constructor does not map anything, call open() to do that.
+ */
+MappedFile::MappedFile()
+{
+#ifdef WIN32
+	file_ = INVALID_HANDLE_VALUE;
+	mapping_ = NULL;
+#endif
+	data_ = 0;
+	size_ = 0;
+}
+
+/** \brief Destructor for MappedFile.
+ *
+ * The destructor unmaps the file.
+ */
+MappedFile::~MappedFile()
+{
+	close();
+}
+
+/** \brief A function to map a file.
+ *
+ * Any file already mapped by this object is unmapped first.
+ * \param filename The name of the file to map.
+ * \return Returns true if the file was mapped, false if it could not be opened or is empty.
+ */
+bool MappedFile::open(const char *filename)
+{
+	close();
+#ifdef WIN32
+	file_ = CreateFileA(filename, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_ATTRIBUTE_NORMAL, NULL);
+	if (file_ == INVALID_HANDLE_VALUE)
+	{
+		return false;
+	}
+	size_ = GetFileSize(file_, NULL);
+	if ((size_ == 0) || (size_ == INVALID_FILE_SIZE))
+	{
+		close();
+		return false;
+	}
+	mapping_ = CreateFileMapping(file_, NULL, PAGE_READONLY, 0, 0, NULL);
+	if (mapping_ == NULL)
+	{
+		close();
+		return false;
+	}
+	data_ = MapViewOfFile(mapping_, FILE_MAP_READ, 0, 0, 0);
+#else
+	int fd = ::open(filename, O_RDONLY);
+	if (fd < 0)
+	{
+		return false;
+	}
+	struct stat st;
+	if ((fstat(fd, &st) != 0) || (st.st_size == 0))
+	{
+		::close(fd);
+		return false;
+	}
+	size_ = (unsigned long)st.st_size;
+	data_ = mmap(0, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	::close(fd);
+	if (data_ == MAP_FAILED)
+	{
+		data_ = 0;
+	}
+#endif
+	if (data_ == 0)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+/** \brief A function to unmap the file.
+ *
+ * Pointers returned by data() are no longer valid afterwards.
+ */
+void MappedFile::close()
+{
+#ifdef WIN32
+	if (data_)
+	{
+		UnmapViewOfFile(data_);
+	}
+	if (mapping_ != NULL)
+	{
+		CloseHandle(mapping_);
+	}
+	if (file_ != INVALID_HANDLE_VALUE)
+	{
+		CloseHandle(file_);
+	}
+	mapping_ = NULL;
+	file_ = INVALID_HANDLE_VALUE;
+#else
+	if (data_)
+	{
+		munmap(data_, size_);
+	}
+#endif
+	data_ = 0;
+	size_ = 0;
+}
+
+/** \brief A function to access the mapped file.
+ *
+ * \return Returns a pointer to the start of the file, or 0 if nothing is mapped.
+ */
+const void* MappedFile::data()
+{
+	return data_;
+}
+
+/** \brief A function to read the size of the mapped file.
+ *
+ * \return Returns the size in bytes, or 0 if nothing is mapped.
+ */
+unsigned long MappedFile::size()
+{
+	return size_;
+}
@@ -0,0 +1,40 @@
+/** \file MappedFile.h
+ * \brief Header file for MappedFile class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef MAPPEDFILE_H
+#define MAPPEDFILE_H
+
+#ifdef WIN32
+#include <windows.h>
+#endif
+
+/** \brief The MappedFile class.
+ *
+ * The MappedFile class maps a whole file read-only into memory so it can be
+ * used in place without reading or parsing it. The mapping lasts until the
+ * object is destroyed or close() is called. It includes code to make it
+ * cross-platform between POSIX and Windows systems.
+ */
+class MappedFile
+{
+public:
+	MappedFile();
+	virtual ~MappedFile();
+
+	virtual bool open(const char *filename);
+	virtual void close();
+	virtual const void* data();
+	virtual unsigned long size();
+private:
+#ifdef WIN32
+	HANDLE file_;
+	HANDLE mapping_;
+#endif
+	void *data_;
+	unsigned long size_;
+};
+
+#endif
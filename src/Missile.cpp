@@ -5,27 +5,24 @@
  * \date May 2007
  */
 #include "Missile.h"
+#include "WorldState.h"
+#include "SaveState.h"
+#include "View.h"
+#include "Canvas.h"
 #include "PlayerItem.h"
+#include "CommandBuffer.h"
 
-#include <Fl/fl_draw.h>
-
-/** \brief Global vector of pointers to all Missile objects.
- *
- * This vector stores pointers to all Missile objects. It is self-managed.
- * When a Missile object is created, it adds itself to the vector and when
- * it is destroyed it removes itself from the vector.
- */
-vector<Missile*> Missile::missiles_;
+#include <math.h>
 
 /** \brief Constructor for Gun.
  *
- * The constructor adds the Gun object to the global vector of guns.
+ * The constructor adds the Gun object to the current world's vector of guns.
  * To create an object, use "new Missile(...)" and the object can be 
  * accessed via the Missile::missiles() function.
  */
 Missile::Missile(double startx, double starty, double endx, double endy, double vel) : EnemyItem(startx, starty, endx, endy, MISSILE_RADIUS, vel)
 {
-	missiles_.push_back(this);
+	WorldState::current().missiles.push_back(this);
 }
 
 /** \brief Destructor for Missile.
@@ -35,12 +32,13 @@ Missile::Missile(double startx, double starty, double endx, double endy, double
  */
 Missile::~Missile()
 {
+	vector<Missile*> &missiles = WorldState::current().missiles;
 	vector<Missile*>::iterator it;
-	for (it = missiles_.begin(); it != missiles_.end(); it++)
+	for (it = missiles.begin(); it != missiles.end(); it++)
 	{
 		if ((*it) == this)
 		{
-			missiles_.erase(it);
+			missiles.erase(it);
 			break;
 		}
 	}
@@ -55,13 +53,24 @@ Missile::~Missile()
  */
 const vector<Missile*>& Missile::missiles()
 {
-	return missiles_;
+	return WorldState::current().missiles;
+}
+
+/** \brief A function to count the Missile as shot down.
+ *
+ * This function adds one to the number of missiles the current world has
+ * destroyed with shell explosions.
+ */
+void Missile::on_shot_down()
+{
+	WorldState::current().missiles_killed++;
 }
 
 /** \brief A function to check if the Missile has hit its target.
  *
  * This function checks to see if the Missile has hit its target, and if so it
- * destroys the target.
+ * destroys the target through the CommandBuffer. Targets already destroyed
+ * this update are ignored.
  * \return Returns boolean true if Missile has hit a target, false otherwise.
  */
 bool Missile::collision_detect()
@@ -69,43 +78,100 @@ bool Missile::collision_detect()
 	bool ret = false;
 	for (int i = 0; i < (int)PlayerItem::playeritems().size(); i++)
 	{
-		double x_diff = PlayerItem::playeritems()[i]->x() - x();
-		double y_diff = PlayerItem::playeritems()[i]->y() - y();
-		if (x_diff*x_diff + y_diff*y_diff <= (radius()+PlayerItem::playeritems()[i]->radius())*(radius()+PlayerItem::playeritems()[i]->radius()))
+		if (PlayerItem::playeritems()[i]->dead())
+		{
+			continue;
+		}
+		if (touching(PlayerItem::playeritems()[i]))
 		{
 #ifdef DEBUG
 			cout << "missile interacted with player item " << i << endl;
 #endif
 			ret = true;
 			PlayerItem::playeritems()[i]->on_death();
-			delete PlayerItem::playeritems()[i];
-			i--;
+			CommandBuffer::destroy(PlayerItem::playeritems()[i]);
 		}
 	}
 	return ret;
 }
 
-/** \brief The interface to draw the Missile.
+/** \brief The interface to capture the Missile for drawing.
  *
- * This protected draw() function calls the private draw_missile() function
- * to draw the object
+ * This protected capture() function adds the drawing state of the Missile
+ * to the snapshot.
+ * \param snap The snapshot being filled in.
  */
-void Missile::draw()
+void Missile::capture(Snapshot &snap)
 {
-	draw_missile();
+	MissileState s;
+	s.handle = handle();
+	s.x = x();
+	s.y = y();
+	s.radius = radius();
+	s.start_x = start_x();
+	s.start_y = start_y();
+	snap.missiles.push_back(s);
 }
 
 /** \brief The specialised drawing function for Missile.
  *
- * The draw_missile() function uses the FLTK routines to draw the Missile as
- * a line from its start location to its current location.
+ * The draw_missile() function uses the FLTK routines to draw a captured
+ * Missile as a line from its start location to its current location. At
+ * lower detail only a short tail behind the Missile is drawn, or just a point.
+ * \param s The drawing state of the Missile.
+ * \param detail Optional: DETAIL_FULL, DETAIL_REDUCED or DETAIL_MINIMAL, defaults to DETAIL_FULL.
  */
-void Missile::draw_missile()
+void Missile::draw_missile(const MissileState &s, int detail)
 {
+	const View &v = View::current();
+	Canvas &canvas = Canvas::current();
 #ifdef DEBUG
-	fl_color(FL_RED);
-	fl_circle(x(), y(), radius());
+	canvas.color(FL_RED);
+	canvas.circle(v.x(s.x), v.y(s.y), v.size(s.radius));
 #endif
-	fl_color(FL_BLACK);
-	fl_line((int)start_x(), (int)start_y(), (int)x(), (int)y());
+	canvas.color(FL_BLACK);
+	if (detail == DETAIL_MINIMAL)
+	{
+		canvas.point((int)v.x(s.x), (int)v.y(s.y));
+		return;
+	}
+	double start_x = s.start_x;
+	double start_y = s.start_y;
+	if (detail == DETAIL_REDUCED)
+	{
+		double length = sqrt((s.start_x - s.x)*(s.start_x - s.x) + (s.start_y - s.y)*(s.start_y - s.y));
+		if (length > LOD_MISSILE_TAIL_LENGTH)
+		{
+			start_x = s.x + (s.start_x - s.x)*LOD_MISSILE_TAIL_LENGTH/length;
+			start_y = s.y + (s.start_y - s.y)*LOD_MISSILE_TAIL_LENGTH/length;
+		}
+	}
+	draw_trail(start_x, start_y, s.x, s.y);
+}
+
+/** \brief A function to draw part of a Missile's trail.
+ *
+ * Each end is rounded to a pixel on its own, so a trail drawn a piece at a
+ * time joins up exactly and ends where the whole trail would.
+ * \param from_x The x co-ordinate to draw from.
+ * \param from_y The y co-ordinate to draw from.
+ * \param to_x The x co-ordinate to draw to.
+ * \param to_y The y co-ordinate to draw to.
+ */
+void Missile::draw_trail(double from_x, double from_y, double to_x, double to_y)
+{
+	const View &v = View::current();
+	Canvas &canvas = Canvas::current();
+	canvas.color(FL_BLACK);
+	canvas.line((int)v.x(from_x), (int)v.y(from_y), (int)v.x(to_x), (int)v.y(to_y));
+}
+
+/** \brief A function to save the Missile's state.
+ *
+ * \param r The record to save into.
+ */
+void Missile::save(ObjectRecord &r)
+{
+	EnemyItem::save(r);
+	r.type = OBJECT_MISSILE;
 }
@@ -8,26 +8,35 @@
 #define MISSILE_H
 
 #include "EnemyItem.h"
+#include "Snapshot.h"
 
 /** \brief The enemy Missile class.
  *
  * The Missile class inherits from EnemyItem and adds the specialised draw() and
  * collision_detect() functions. The missiles also allow acces to a list of all
  * the missiles and the missiles alone.
+ *
+ * SpatialSort::relocate() moves missiles with the implicit copy constructor
+ * and assignment operator, and drops the copies without destroying them, so
+ * a Missile must stay trivially copyable apart from its vtable: no member
+ * may own memory or anything else, and none may define its own copying.
  */
 class Missile : public EnemyItem
 {
 public:
 	Missile(double startx, double starty, double endx, double endy, double vel);
 	virtual ~Missile();
+
+	friend class World;
 	
 	static const vector<Missile*>& missiles();
-	virtual bool collision_detect();
+	bool collision_detect();
+	virtual void on_shot_down();
+	static void draw_missile(const MissileState &s, int detail = DETAIL_FULL);
+	static void draw_trail(double from_x, double from_y, double to_x, double to_y);
+	virtual void save(ObjectRecord &r);
 protected:
-	virtual void draw();
-private:
-	static vector<Missile*> missiles_;
-	virtual void draw_missile();
+	void capture(Snapshot &snap);
 };
 
 #endif
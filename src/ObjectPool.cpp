@@ -0,0 +1,81 @@
+/** \file ObjectPool.cpp
+ * \brief Code implementation for ObjectPool class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "ObjectPool.h"
+
+#include <new>
+
+/** \brief Constructor for ObjectPool.
+ *
+ * The pool starts empty and takes nothing from the heap until it is used.
+ */
+ObjectPool::ObjectPool()
+{
+	for (int i = 0; i < POOL_SIZE_CLASSES; i++)
+	{
+		free_[i] = 0;
+	}
+}
+
+/** \brief Destructor for ObjectPool.
+ *
+ * The destructor returns every chunk to the heap.
+ */
+ObjectPool::~ObjectPool()
+{
+	for (unsigned int i = 0; i < chunks_.size(); i++)
+	{
+		::operator delete(chunks_[i]);
+	}
+}
+
+/** \brief A function to allocate a block.
+ *
+ * \param size The size of the block in bytes.
+ * \return Returns the block.
+ */
+void* ObjectPool::allocate(size_t size)
+{
+	size_t c = (size + POOL_GRANULE - 1)/POOL_GRANULE;
+	if ((c == 0) || (c > POOL_SIZE_CLASSES))
+	{
+		return ::operator new(size);
+	}
+	FreeBlock *&head = free_[c - 1];
+	if (!head)
+	{
+		size_t block = c*POOL_GRANULE;
+		char *chunk = (char*)::operator new(block*POOL_CHUNK_OBJECTS);
+		chunks_.push_back(chunk);
+		for (int i = POOL_CHUNK_OBJECTS - 1; i >= 0; i--)
+		{
+			FreeBlock *b = (FreeBlock*)(chunk + i*block);
+			b->next = head;
+			head = b;
+		}
+	}
+	FreeBlock *b = head;
+	head = b->next;
+	return b;
+}
+
+/** \brief A function to release a block.
+ *
+ * \param p The block, as returned by allocate().
+ * \param size The size passed to allocate().
+ */
+void ObjectPool::release(void *p, size_t size)
+{
+	size_t c = (size + POOL_GRANULE - 1)/POOL_GRANULE;
+	if ((c == 0) || (c > POOL_SIZE_CLASSES))
+	{
+		::operator delete(p);
+		return;
+	}
+	FreeBlock *b = (FreeBlock*)p;
+	b->next = free_[c - 1];
+	free_[c - 1] = b;
+}
@@ -0,0 +1,49 @@
+/** \file ObjectPool.h
+ * \brief Header file for ObjectPool class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef OBJECTPOOL_H
+#define OBJECTPOOL_H
+
+#include "enum.h"
+
+#include <stddef.h>
+
+/** \brief The ObjectPool class.
+ *
+ * The ObjectPool class hands out memory for game objects. Blocks are grouped
+ * into size classes of POOL_GRANULE bytes and taken from the heap
+ * POOL_CHUNK_OBJECTS at a time, and released blocks go on a free list for
+ * their size class instead of back to the heap. Once the game has had as
+ * many objects of each size alive at once as it ever will, creating and
+ * deleting objects no longer allocates. Sizes above the largest class go
+ * straight to the heap.
+ *
+ * Chunks are only returned to the heap when the pool is destroyed, after
+ * every object in it has been deleted.
+ */
+class ObjectPool
+{
+public:
+	ObjectPool();
+	virtual ~ObjectPool();
+
+	virtual void* allocate(size_t size);
+	virtual void release(void *p, size_t size);
+private:
+	ObjectPool(const ObjectPool&);
+	ObjectPool& operator=(const ObjectPool&);
+
+	/** \brief A released block, linked into its size class's free list.
+	 */
+	struct FreeBlock
+	{
+		FreeBlock *next;
+	};
+	FreeBlock *free_[POOL_SIZE_CLASSES];
+	vector<char*> chunks_;
+};
+
+#endif
@@ -0,0 +1,257 @@
+/** \file ParticleSystem.cpp
+ * \brief Code implementation for ParticleSystem class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "ParticleSystem.h"
+
+#include <Fl/fl_draw.h>
+#include <math.h>
+
+#if defined(__SSE__) || defined(_M_X64) || (defined(_M_IX86_FP) && (_M_IX86_FP >= 1))
+#define PARTICLE_SSE
+#include <xmmintrin.h>
+#endif
+
+#include "Canvas.h"
+#include "View.h"
+
+/** \brief The colours each kind of particle fades through, from newest to oldest.
+ */
+static const unsigned char particle_colours[PARTICLE_KINDS][PARTICLE_SHADES][3] =
+{
+	{{255, 240, 120}, {255, 180, 40}, {230, 90, 20}, {150, 40, 20}},  // PARTICLE_SPARK
+	{{60, 50, 45}, {80, 70, 60}, {100, 90, 80}, {120, 110, 100}},     // PARTICLE_DEBRIS
+	{{90, 90, 90}, {130, 130, 130}, {165, 165, 165}, {190, 200, 210}} // PARTICLE_SMOKE
+};
+
+/** \brief Constructor for ParticleSystem.
+ *
+ * The whole pool is allocated here, so spawning never allocates.
+ */
+ParticleSystem::ParticleSystem()
+{
+	count_ = 0;
+	x_.resize(PARTICLE_CAPACITY);
+	y_.resize(PARTICLE_CAPACITY);
+	vx_.resize(PARTICLE_CAPACITY);
+	vy_.resize(PARTICLE_CAPACITY);
+	ay_.resize(PARTICLE_CAPACITY);
+	age_.resize(PARTICLE_CAPACITY);
+	life_.resize(PARTICLE_CAPACITY);
+	kind_.resize(PARTICLE_CAPACITY);
+	order_.resize(PARTICLE_CAPACITY);
+	buckets_.resize(PARTICLE_KINDS*PARTICLE_SHADES + 1);
+	seed_ = 1;
+}
+
+/** \brief Destructor for ParticleSystem.
+ */
+ParticleSystem::~ParticleSystem()
+{
+}
+
+/** \brief A function to remove every particle.
+ */
+void ParticleSystem::clear()
+{
+	count_ = 0;
+}
+
+/** \brief A function to spawn the particles for an effect.
+ *
+ * Particles that do not fit in the pool are not spawned.
+ * \param e The effect.
+ */
+void ParticleSystem::emit(const EffectState &e)
+{
+	switch (e.kind)
+	{
+	case EFFECT_FLASH:
+		spawn(PARTICLE_SPARK, e.x, e.y, e.size, 0.3, 0, false, 24);
+		break;
+	case EFFECT_DEBRIS:
+		spawn(PARTICLE_DEBRIS, e.x, e.y, 60, 0.6, PARTICLE_GRAVITY, false, 10);
+		spawn(PARTICLE_SPARK, e.x, e.y, 60, 0.3, 0, false, 6);
+		break;
+	case EFFECT_IMPACT:
+		spawn(PARTICLE_DEBRIS, e.x, e.y, 80, 1.0, PARTICLE_GRAVITY, true, 40);
+		spawn(PARTICLE_SMOKE, e.x, e.y, 10, 1.5, -PARTICLE_GRAVITY/15, true, 30);
+		break;
+	}
+}
+
+/** \brief A function to spawn particles of one kind.
+ *
+ * Each particle gets a random direction, a speed between speed and twice
+ * speed, and a life between life and twice life.
+ * \param kind The kind of particle, one of the PARTICLE_ enums.
+ * \param x The x co-ordinate to spawn at, in world units.
+ * \param y The y co-ordinate to spawn at, in world units.
+ * \param speed The slowest speed, in world units per second.
+ * \param life The shortest life, in seconds.
+ * \param gravity The downwards acceleration, negative to rise.
+ * \param upward Whether to only send particles upwards.
+ * \param count The number of particles.
+ */
+void ParticleSystem::spawn(int kind, double x, double y, double speed, double life, double gravity, bool upward, int count)
+{
+	for (int i = 0; (i < count) && (count_ < PARTICLE_CAPACITY); i++)
+	{
+		double angle = random()*2*M_PI;
+		if (upward)
+		{
+			angle = M_PI + 0.2 + random()*(M_PI - 0.4);
+		}
+		double v = speed*(1 + random());
+		unsigned int n = count_++;
+		x_[n] = (float)x;
+		y_[n] = (float)y;
+		vx_[n] = (float)(v*cos(angle));
+		vy_[n] = (float)(v*sin(angle));
+		ay_[n] = (float)gravity;
+		age_[n] = 0;
+		life_[n] = (float)(life*(1 + random()));
+		kind_[n] = (unsigned char)kind;
+	}
+}
+
+/** \brief A function to move the particles on and remove the dead ones.
+ *
+ * Particles die when their life is up or they fall to the ground.
+ * \param t The time to move them on by, in seconds.
+ */
+void ParticleSystem::update(double t)
+{
+	float dt = (float)t;
+	unsigned int i = 0;
+#ifdef PARTICLE_SSE
+	__m128 step = _mm_set1_ps(dt);
+	for (; i + 4 <= count_; i = i + 4)
+	{
+		__m128 vx = _mm_loadu_ps(&vx_[i]);
+		__m128 vy = _mm_loadu_ps(&vy_[i]);
+		_mm_storeu_ps(&x_[i], _mm_add_ps(_mm_loadu_ps(&x_[i]), _mm_mul_ps(vx, step)));
+		_mm_storeu_ps(&y_[i], _mm_add_ps(_mm_loadu_ps(&y_[i]), _mm_mul_ps(vy, step)));
+		_mm_storeu_ps(&vy_[i], _mm_add_ps(vy, _mm_mul_ps(_mm_loadu_ps(&ay_[i]), step)));
+		_mm_storeu_ps(&age_[i], _mm_add_ps(_mm_loadu_ps(&age_[i]), step));
+	}
+#endif
+	for (; i < count_; i++)
+	{
+		x_[i] += vx_[i]*dt;
+		y_[i] += vy_[i]*dt;
+		vy_[i] += ay_[i]*dt;
+		age_[i] += dt;
+	}
+
+	float ground = (float)(WORLD_HEIGHT - GROUND_HEIGHT);
+	for (i = 0; i < count_; i++)
+	{
+		while ((i < count_) && ((age_[i] >= life_[i]) || (y_[i] > ground)))
+		{
+			unsigned int last = --count_;
+			x_[i] = x_[last];
+			y_[i] = y_[last];
+			vx_[i] = vx_[last];
+			vy_[i] = vy_[last];
+			ay_[i] = ay_[last];
+			age_[i] = age_[last];
+			life_[i] = life_[last];
+			kind_[i] = kind_[last];
+		}
+	}
+}
+
+/** \brief A function to draw the particles on the current Canvas through the current View.
+ *
+ * The particles are sorted by colour, then each colour is set once and its
+ * particles drawn together, as single pixels or, when a world unit is more
+ * than a pixel, as squares that size.
+ */
+void ParticleSystem::draw()
+{
+	if (count_ == 0)
+	{
+		return;
+	}
+	const View &v = View::current();
+	Canvas &canvas = Canvas::current();
+	unsigned int colours = PARTICLE_KINDS*PARTICLE_SHADES;
+
+	// counting sort of the particles by colour
+	for (unsigned int c = 0; c <= colours; c++)
+	{
+		buckets_[c] = 0;
+	}
+	for (unsigned int i = 0; i < count_; i++)
+	{
+		int shade = (int)(age_[i]*PARTICLE_SHADES/life_[i]);
+		shade = (shade < PARTICLE_SHADES) ? shade : PARTICLE_SHADES - 1;
+		buckets_[kind_[i]*PARTICLE_SHADES + shade + 1]++;
+	}
+	for (unsigned int c = 1; c <= colours; c++)
+	{
+		buckets_[c] += buckets_[c - 1];
+	}
+	for (unsigned int i = 0; i < count_; i++)
+	{
+		int shade = (int)(age_[i]*PARTICLE_SHADES/life_[i]);
+		shade = (shade < PARTICLE_SHADES) ? shade : PARTICLE_SHADES - 1;
+		order_[buckets_[kind_[i]*PARTICLE_SHADES + shade]++] = i;
+	}
+	// each bucket now ends where the next one started
+
+	int size = (int)(v.scale() + 0.5);
+	unsigned int start = 0;
+	for (unsigned int c = 0; c < colours; c++)
+	{
+		unsigned int end = buckets_[c];
+		if (start == end)
+		{
+			continue;
+		}
+		const unsigned char *rgb = particle_colours[c/PARTICLE_SHADES][c%PARTICLE_SHADES];
+		canvas.color(fl_rgb_color(rgb[0], rgb[1], rgb[2]));
+		if (size > 1)
+		{
+			for (unsigned int j = start; j < end; j++)
+			{
+				unsigned int i = order_[j];
+				canvas.rectf((int)v.x(x_[i]) - size/2, (int)v.y(y_[i]) - size/2, size, size);
+			}
+		}
+		else
+		{
+			canvas.begin_points();
+			for (unsigned int j = start; j < end; j++)
+			{
+				unsigned int i = order_[j];
+				canvas.vertex(v.x(x_[i]), v.y(y_[i]));
+			}
+			canvas.end_points();
+		}
+		start = end;
+	}
+}
+
+/** \brief A function to return the number of live particles.
+ *
+ * \return Returns the number of live particles.
+ */
+unsigned int ParticleSystem::size()
+{
+	return count_;
+}
+
+/** \brief A function to return a random number for spawning.
+ *
+ * This is separate from game_rand() so drawing cannot change the game.
+ * \return Returns a random number from 0 up to but not including 1.
+ */
+float ParticleSystem::random()
+{
+	seed_ = seed_*1664525 + 1013904223;
+	return (float)(seed_ >> 8)/16777216.0f;
+}
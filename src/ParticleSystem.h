@@ -0,0 +1,54 @@
+/** \file ParticleSystem.h
+ * \brief Header file for ParticleSystem class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef PARTICLESYSTEM_H
+#define PARTICLESYSTEM_H
+
+#include "enum.h"
+#include "Snapshot.h"
+
+/** \brief The ParticleSystem class.
+ *
+ * The ParticleSystem class turns the effects the World reports into sparks,
+ * debris and smoke and draws them. It only decorates the picture: the game
+ * never sees a particle, and particles use their own random numbers, so they
+ * do not change the game.
+ *
+ * Particles live in a pool of PARTICLE_CAPACITY that is allocated once. Each
+ * field is kept in its own array so update() can move four particles at a
+ * time with SSE where it is available. Dead particles are replaced by the
+ * last live one, so the live particles are always the first size(). draw()
+ * sorts them by colour and draws each colour as one batch of points.
+ */
+class ParticleSystem
+{
+public:
+	ParticleSystem();
+	virtual ~ParticleSystem();
+
+	virtual void clear();
+	virtual void emit(const EffectState &e);
+	virtual void update(double t);
+	virtual void draw();
+	virtual unsigned int size();
+private:
+	void spawn(int kind, double x, double y, double speed, double life, double gravity, bool upward, int count);
+	float random();
+	unsigned int count_;
+	vector<float> x_;
+	vector<float> y_;
+	vector<float> vx_;
+	vector<float> vy_;
+	vector<float> ay_;
+	vector<float> age_;
+	vector<float> life_;
+	vector<unsigned char> kind_;
+	vector<unsigned int> order_;   ///< particle indices sorted by colour
+	vector<unsigned int> buckets_; ///< where each colour starts in order_
+	unsigned int seed_;
+};
+
+#endif
@@ -5,24 +5,18 @@
  * \date May 2007
  */
 #include "PlayerItem.h"
-
-/** \brief Global vector of pointers to all PlayerItem objects.
- *
- * This vector stores pointers to all PlayerItem objects. It is self-managed.
- * When an PlayerItem object is created, it adds itself to the vector and when
- * it is destroyed it removes itself from the vector.
- */
-vector<PlayerItem*> PlayerItem::playeritems_;
+#include "WorldState.h"
+#include "CommandBuffer.h"
 
 /** \brief Constructor for PlayerItem.
  *
- * The constructor adds the PlayerItem object to the global vector of player items.
+ * The constructor adds the PlayerItem object to the current world's vector of player items.
  * To create an object, use "new PlayerItem(...)" and the object can be 
  * accessed via the PlayerItem::playeritems() function.
  */
 PlayerItem::PlayerItem(double x, double y, double r) : GameObject(x, y, r)
 {
-	playeritems_.push_back(this);
+	WorldState::current().playeritems.push_back(this);
 }
 
 /** \brief Destructor for PlayerItem.
@@ -32,12 +26,13 @@ PlayerItem::PlayerItem(double x, double y, double r) : GameObject(x, y, r)
  */
 PlayerItem::~PlayerItem()
 {
+	vector<PlayerItem*> &playeritems = WorldState::current().playeritems;
 	vector<PlayerItem*>::iterator it;
-	for(it = playeritems_.begin(); it != playeritems_.end(); it++)
+	for(it = playeritems.begin(); it != playeritems.end(); it++)
 	{
 		if((*it) == this)
 		{
-			playeritems_.erase(it);
+			playeritems.erase(it);
 			break;
 		}
 	}
@@ -52,5 +47,14 @@ PlayerItem::~PlayerItem()
  */
 const vector<PlayerItem*>& PlayerItem::playeritems()
 {
-	return playeritems_;
+	return WorldState::current().playeritems;
+}
+
+/** \brief A function to show the PlayerItem being hit.
+ *
+ * This function reports an impact effect where the PlayerItem was.
+ */
+void PlayerItem::on_death()
+{
+	CommandBuffer::effect(EFFECT_IMPACT, x(), y(), radius());
 }
@@ -22,8 +22,7 @@ public:
 	virtual ~PlayerItem();
 	
 	static const vector<PlayerItem*>& playeritems();
-private:
-	static vector<PlayerItem*> playeritems_;
+	virtual void on_death();
 };
 
 #endif
@@ -5,37 +5,43 @@
  * \date May 2007
  */
 #include "Projectile.h"
+#include "WorldState.h"
+#include "SaveState.h"
 
 #include <stdlib.h>
 #include <math.h>
 
-/** \brief Global vector of pointers to all Projectile objects.
- *
- * This vector stores pointers to all Projectile objects. It is self-managed.
- * When a Projectile object is created, it adds itself to the vector and when
- * it is destroyed it removes itself from the vector.
- */
-vector<Projectile*> Projectile::projectiles_;
-
 /** \brief Constructor for Projectile.
  *
- * The constructor adds the Projectile object to the global vector of projectiles.
+ * The constructor adds the Projectile object to the current world's vector of projectiles.
  * To create an object, use "new Projectile(...)" and the object can be 
  * accessed via the Projectile::projectiles() function.
  */
 Projectile::Projectile(double startx, double starty, double endx, double endy, double r, double vel) : GameObject(startx, starty, r)
 {
-	projectiles_.push_back(this);
+	WorldState::current().projectiles.push_back(this);
+#ifdef FIXED_POINT
+	// keep the start and target exactly representable so the fixed point
+	// movement and arrival test see the same values as the accessors
+	start_x_ = from_fixed(to_fixed(startx));
+	start_y_ = from_fixed(to_fixed(starty));
+	target_x_ = from_fixed(to_fixed(endx));
+	target_y_ = from_fixed(to_fixed(endy));
+#else
 	start_x_ = startx;
 	start_y_ = starty;
 	target_x_ = endx;
 	target_y_ = endy;
+#endif
 	velocity_ = vel;
 	angle_ = atan((double)(endx - startx) / (double)(endy - starty));
 	if ((endy - starty) >= 0)
 	{
 		angle_ = angle_ + M_PI;
 	}
+#ifdef FIXED_POINT
+	fvelocity();
+#endif
 }
 
 /** \brief Destructor for Projectile.
@@ -45,12 +51,13 @@ Projectile::Projectile(double startx, double starty, double endx, double endy, d
  */
 Projectile::~Projectile()
 {
+	vector<Projectile*> &projectiles = WorldState::current().projectiles;
 	vector<Projectile*>::iterator it;
-	for (it = projectiles_.begin(); it != projectiles_.end(); it++)
+	for (it = projectiles.begin(); it != projectiles.end(); it++)
 	{
 		if ((*it) == this)
 		{
-			projectiles_.erase(it);
+			projectiles.erase(it);
 			break;
 		}
 	}
@@ -65,90 +72,7 @@ Projectile::~Projectile()
  */
 const vector<Projectile*>& Projectile::projectiles()
 {
-	return projectiles_;
-}
-
-/** \brief A function to return the value of the x co-ordinate of the target.
- *
- * \return Returns the x co-ordinate of the target, type double.
- */
-double Projectile::target_x()
-{
-	return target_x_;
-}
-
-/** \brief A function to return the value of the y co-ordinate of the target.
- *
- * \return Returns the y co-ordinate of the target, type double.
- */
-double Projectile::target_y()
-{
-	return target_y_;
-}
-
-/** \brief A function to set the target of the projectile.
- *
- * \param x The x co-ordinate of the target, type double.
- * \param y The y co-ordinate of the target, type double.
- */
-void Projectile::target(double x, double y)
-{
-	target_x_ = x;
-	target_y_ = y;
-}
-
-/** \brief A function to return the value of the x co-ordinate of the start location.
- *
- * \return Returns the y co-ordinate of the start location, type double.
- */
-double Projectile::start_x()
-{
-	return start_x_;
-}
-
-/** \brief A function to return the value of the y co-ordinate of the start location.
- *
- * \return Returns the y co-ordinate of the start location, type double.
- */
-double Projectile::start_y()
-{
-	return start_y_;
-}
-
-/** \brief A function to return the value of the velocity of the projectile.
- *
- * \return Returns the velocity of the projectile, type double.
- */
-double Projectile::velocity()
-{
-	return velocity_;
-}
-
-/** \brief A function to set the velocity of the projectile.
- *
- * \param v The velocity to be assigned to the projectile, type double.
- */
-void Projectile::velocity(double v)
-{
-	velocity_ = v;
-}
-
-/** \brief A function to return the angle the projectile is travelling at.
- *
- * \return Returns the angle the projectile is travelling at, type double.
- */
-double Projectile::angle()
-{
-	return angle_;
-}
-
-/** \brief A function to set the value of the angle the projectile is travelling in.
- *
- * \param a The angle to be assigned to the projectile, type double.
- */
-void Projectile::angle(double a)
-{
-	angle_ = a;
+	return WorldState::current().projectiles;
 }
 
 /** \brief A function to animate the Projectile.
@@ -162,6 +86,19 @@ void Projectile::angle(double a)
  */
 int Projectile::animate(double t)
 {
+#ifdef FIXED_POINT
+	fixed_t error_x = fx() - to_fixed(target_x());
+	fixed_t error_y = fy() - to_fixed(target_y());
+	int sign_x = (to_fixed(start_x()) - to_fixed(target_x())) >= FIXED_ONE ? 1 : -1;
+	int sign_y = (to_fixed(start_y()) - to_fixed(target_y())) >= FIXED_ONE ? 1 : -1;
+
+	if ((error_x*sign_x <= 10*FIXED_ONE) && (error_y*sign_y <= 10*FIXED_ONE)) // if within 10 pixels
+	{
+		return 1;
+	}
+	fixed_t ft = to_fixed(t);
+	fposition(fx() + fixed_mul(velocity_x_, ft), fy() + fixed_mul(velocity_y_, ft));
+#else
 	double error_x = x() - target_x();
 	double error_y = y() - target_y();
 	double sign_x = (start_x() - target_x()) >= 1 ? 1 : -1;
@@ -172,6 +109,45 @@ int Projectile::animate(double t)
 		return 1;
 	}
 	position(x() - sin(angle())*velocity()*t, y() - cos(angle())*velocity()*t);
+#endif
 
 	return 0;
 }
+
+/** \brief A function to save the Projectile's state.
+ *
+ * \param r The record to save into.
+ */
+void Projectile::save(ObjectRecord &r)
+{
+	GameObject::save(r);
+	r.start_x = start_x();
+	r.start_y = start_y();
+	r.target_x = target_x();
+	r.target_y = target_y();
+	r.velocity = velocity();
+}
+
+#ifdef FIXED_POINT
+/** \brief A function to compute the fixed point velocity vector.
+ *
+ * The vector points from the start location to the target and has a length of
+ * velocity(). It is computed with integer arithmetic only, so it is the same
+ * on every build.
+ */
+void Projectile::fvelocity()
+{
+	fixed_sq_t dx = (fixed_sq_t)to_fixed(target_x_) - to_fixed(start_x_);
+	fixed_sq_t dy = (fixed_sq_t)to_fixed(target_y_) - to_fixed(start_y_);
+	fixed_sq_t length = isqrt(dx*dx + dy*dy);
+	fixed_sq_t v = to_fixed(velocity_);
+	if (length == 0)
+	{
+		velocity_x_ = 0;
+		velocity_y_ = 0;
+		return;
+	}
+	velocity_x_ = (fixed_t)(dx*v/length);
+	velocity_y_ = (fixed_t)(dy*v/length);
+}
+#endif
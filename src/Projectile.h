@@ -14,7 +14,9 @@
  * The Projectile class inherits from GameObject and extends it to allow for moving
  * objects. The projectiles are assumed to move in a straight line towards the target.
  * The Projectile class allows acces to a list of all the projectiles and the 
- * projectiles alone.
+ * projectiles alone. When FIXED_POINT is defined the projectile moves by a
+ * fixed point velocity vector computed once from its start and target, so no
+ * trigonometry is involved in its movement.
  */
 class Projectile : public GameObject
 {
@@ -23,25 +25,122 @@ public:
 	virtual ~Projectile();
 
 	static const vector<Projectile*>& projectiles();
-	virtual double target_x();
-	virtual double target_y();
-	virtual double start_x();
-	virtual double start_y();
-	virtual double velocity();
-	virtual int animate(double t);
+	double target_x();
+	double target_y();
+	double start_x();
+	double start_y();
+	double velocity();
+	int animate(double t);
+	virtual void save(ObjectRecord &r);
 protected:
-	virtual void target(double x, double y);
-	virtual void velocity(double v);
-	virtual double angle();
-	virtual void angle(double a);
+	void target(double x, double y);
+	void velocity(double v);
+	double angle();
+	void angle(double a);
 private:
-	static vector<Projectile*> projectiles_;
 	double target_x_;
 	double target_y_;
 	double start_x_;
 	double start_y_;
 	double velocity_;
 	double angle_;
+#ifdef FIXED_POINT
+	void fvelocity();
+	fixed_t velocity_x_;
+	fixed_t velocity_y_;
+#endif
 };
 
+/** \brief A function to return the value of the x co-ordinate of the target.
+ *
+ * \return Returns the x co-ordinate of the target, type double.
+ */
+inline double Projectile::target_x()
+{
+	return target_x_;
+}
+
+/** \brief A function to return the value of the y co-ordinate of the target.
+ *
+ * \return Returns the y co-ordinate of the target, type double.
+ */
+inline double Projectile::target_y()
+{
+	return target_y_;
+}
+
+/** \brief A function to set the target of the projectile.
+ *
+ * \param x The x co-ordinate of the target, type double.
+ * \param y The y co-ordinate of the target, type double.
+ */
+inline void Projectile::target(double x, double y)
+{
+#ifdef FIXED_POINT
+	target_x_ = from_fixed(to_fixed(x));
+	target_y_ = from_fixed(to_fixed(y));
+	fvelocity();
+#else
+	target_x_ = x;
+	target_y_ = y;
+#endif
+}
+
+/** \brief A function to return the value of the x co-ordinate of the start location.
+ *
+ * \return Returns the y co-ordinate of the start location, type double.
+ */
+inline double Projectile::start_x()
+{
+	return start_x_;
+}
+
+/** \brief A function to return the value of the y co-ordinate of the start location.
+ *
+ * \return Returns the y co-ordinate of the start location, type double.
+ */
+inline double Projectile::start_y()
+{
+	return start_y_;
+}
+
+/** \brief A function to return the value of the velocity of the projectile.
+ *
+ * \return Returns the velocity of the projectile, type double.
+ */
+inline double Projectile::velocity()
+{
+	return velocity_;
+}
+
+/** \brief A function to set the velocity of the projectile.
+ *
+ * \param v The velocity to be assigned to the projectile, type double.
+ */
+inline void Projectile::velocity(double v)
+{
+	velocity_ = v;
+#ifdef FIXED_POINT
+	fvelocity();
+#endif
+}
+
+/** \brief A function to return the angle the projectile is travelling at.
+ *
+ * \return Returns the angle the projectile is travelling at, type double.
+ */
+inline double Projectile::angle()
+{
+	return angle_;
+}
+
+/** \brief A function to set the value of the angle the projectile is travelling in.
+ *
+ * \param a The angle to be assigned to the projectile, type double.
+ */
+inline void Projectile::angle(double a)
+{
+	angle_ = a;
+}
+
 #endif
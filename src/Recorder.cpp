@@ -0,0 +1,411 @@
+/** \file Recorder.cpp
+ * \brief Code implementation for Recorder class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "Recorder.h"
+
+#include <string.h>
+#ifdef WIN32
+#include <io.h>
+#include <fcntl.h>
+#endif
+
+#include "Base.h"
+#include "Gun.h"
+#include "Missile.h"
+#include "UFO.h"
+#include "Shell.h"
+#include "ShellExplosion.h"
+#include "trace.h"
+
+/** \brief A function to check a pattern for PPM file names.
+ *
+ * The pattern must have exactly one conversion, which is %lu with an
+ * optional width of at most TEXT_LENGTH, and may have %% for a literal
+ * percent sign. Anything else could make sprintf() read arguments that are
+ * not there or write past the end of the file name.
+ * \param path The pattern.
+ * \return Returns the width of the conversion, 0 if none is given, or -1
+ *	if the pattern is not allowed.
+ */
+static int pattern_width(const char *path)
+{
+	int width = -1;
+	for (const char *p = path; *p; p++)
+	{
+		if (*p != '%')
+		{
+			continue;
+		}
+		p++;
+		if (*p == '%')
+		{
+			continue;
+		}
+		if (width >= 0)
+		{
+			return -1; // a second conversion
+		}
+		width = 0;
+		while ((*p >= '0') && (*p <= '9'))
+		{
+			width = width*10 + (*p - '0');
+			if (width > TEXT_LENGTH)
+			{
+				return -1;
+			}
+			p++;
+		}
+		if ((p[0] != 'l') || (p[1] != 'u'))
+		{
+			return -1;
+		}
+		p++;
+	}
+	return width;
+}
+
+/** \brief Constructor for Recorder.
+ *
+ * The new Recorder is not recording until open() is called.
+ */
+Recorder::Recorder()
+{
+	format_ = RECORD_PPM;
+	wait_ = false;
+	stream_ = 0;
+	current_ = -1;
+	running_ = 0;
+	written_ = 0;
+	dropped_ = 0;
+	failed_ = 0;
+	for (int i = 0; i < RECORD_QUEUE_SIZE; i++)
+	{
+		free_.push(i);
+	}
+}
+
+/** \brief Destructor for Recorder.
+ *
+ * The destructor writes any frames still waiting and closes the output.
+ */
+Recorder::~Recorder()
+{
+	close();
+}
+
+/** \brief A function to start recording.
+ *
+ * \param path For RECORD_PPM, a printf() pattern for the file names that is
+ *	given the frame number as an unsigned long, such as "frame%06lu.ppm". It
+ *	must have exactly one conversion, %lu with an optional width, and may
+ *	have %% for a percent sign. For
+ *	RECORD_RAW, the file to write, or "-" for the standard output.
+ * \param format RECORD_PPM or RECORD_RAW.
+ * \param scale The size of the frames as a fraction of WORLD_WIDTH by
+ *	WORLD_HEIGHT.
+ * \param wait If true, frame() waits for a free slot instead of dropping the
+ *	frame, for when the simulation has no clock to keep up with.
+ * \param threads Optional: The number of threads to draw each frame with,
+ *	defaults to 1. The frames are the same whatever the number.
+ * \return Returns false if already recording, or if the arguments are bad or
+ *	the output cannot be opened.
+ */
+bool Recorder::open(const char *path, int format, double scale, bool wait, int threads)
+{
+	if (recording() || (scale <= 0))
+	{
+		return false;
+	}
+	if (format == RECORD_PPM)
+	{
+		int width = pattern_width(path);
+		if (width < 0)
+		{
+			return false;
+		}
+		// the frame number takes at most the width or 20 digits, and %% shrinks
+		filename_.resize(strlen(path) + ((width > 20) ? width : 20) + 1);
+	}
+	else if (format == RECORD_RAW)
+	{
+		if (strcmp(path, "-") == 0)
+		{
+#ifdef WIN32
+			_setmode(_fileno(stdout), _O_BINARY);
+#endif
+			stream_ = stdout;
+		}
+		else
+		{
+			stream_ = fopen(path, "wb");
+		}
+		if (!stream_)
+		{
+			return false;
+		}
+	}
+	else
+	{
+		return false;
+	}
+	path_ = path;
+	format_ = format;
+	wait_ = wait;
+	int width = (int)(WORLD_WIDTH*scale + 0.5);
+	int height = (int)(WORLD_HEIGHT*scale + 0.5);
+	canvas_.threads(threads);
+	canvas_.resize((width > 1) ? width : 1, (height > 1) ? height : 1);
+	view_.fit(canvas_.width(), canvas_.height());
+	atomic_store(&written_, 0);
+	atomic_store(&dropped_, 0);
+	atomic_store(&failed_, 0);
+	atomic_store(&running_, 1);
+	if (!thread_.start(thread_main, this))
+	{
+		atomic_store(&running_, 0);
+		close();
+		return false;
+	}
+	return true;
+}
+
+/** \brief A function to stop recording.
+ *
+ * Every frame already submitted is written first. Nothing may be capturing
+ * a frame while this is called.
+ */
+void Recorder::close()
+{
+	atomic_store(&running_, 0);
+	thread_.join();
+	if (current_ >= 0)
+	{
+		free_.push(current_);
+		current_ = -1;
+	}
+	if (stream_)
+	{
+		if (stream_ == stdout)
+		{
+			fflush(stream_);
+		}
+		else if (fclose(stream_) != 0)
+		{
+			atomic_store(&failed_, 1);
+		}
+		stream_ = 0;
+	}
+}
+
+/** \brief A function to check if the Recorder is recording.
+ *
+ * \return Returns true between a successful open() and close().
+ */
+bool Recorder::recording()
+{
+	return atomic_load(&running_) != 0;
+}
+
+/** \brief A function to return the width of the frames.
+ *
+ * \return Returns the width in pixels.
+ */
+int Recorder::width()
+{
+	return canvas_.width();
+}
+
+/** \brief A function to return the height of the frames.
+ *
+ * \return Returns the height in pixels.
+ */
+int Recorder::height()
+{
+	return canvas_.height();
+}
+
+/** \brief A function to get a slot to capture the next frame into.
+ *
+ * Only the thread running the World may call this function, and it must
+ * call submit() once the slot is filled in.
+ * \return Returns the slot, or 0 if not recording or the frame was dropped.
+ */
+Snapshot* Recorder::frame()
+{
+	if (!recording())
+	{
+		return 0;
+	}
+	int slot;
+	while (!free_.pop(slot))
+	{
+		if (!wait_)
+		{
+			atomic_increment(&dropped_);
+			return 0;
+		}
+		Thread::sleep(RECORD_POLL);
+	}
+	current_ = slot;
+	return &slots_[slot];
+}
+
+/** \brief A function to pass the frame captured into the slot from frame() on to be written.
+ */
+void Recorder::submit()
+{
+	if (current_ >= 0)
+	{
+		ready_.push(current_);
+		current_ = -1;
+	}
+}
+
+/** \brief A function to return the number of frames written.
+ *
+ * \return Returns the number of frames written since open().
+ */
+unsigned long Recorder::written()
+{
+	return (unsigned long)atomic_load(&written_);
+}
+
+/** \brief A function to return the number of frames dropped.
+ *
+ * \return Returns the number of frames dropped since open() because every
+ *	slot was waiting to be written.
+ */
+unsigned long Recorder::dropped()
+{
+	return (unsigned long)atomic_load(&dropped_);
+}
+
+/** \brief A function to check if writing failed.
+ *
+ * Once a write fails no more frames are written.
+ * \return Returns true if a frame could not be written since open().
+ */
+bool Recorder::failed()
+{
+	return atomic_load(&failed_) != 0;
+}
+
+/** \brief Entry point for the encoder thread.
+ *
+ * \param recorder Pointer to the Recorder.
+ */
+void Recorder::thread_main(void *recorder)
+{
+	((Recorder*)recorder)->run();
+}
+
+/** \brief The encoder loop.
+ *
+ * The loop draws and writes each submitted frame in order and hands its slot
+ * back. Once recording stops it finishes the frames already submitted.
+ */
+void Recorder::run()
+{
+	TRACE_THREAD("recorder");
+	for (;;)
+	{
+		bool stopping = !recording();
+		int slot;
+		if (ready_.pop(slot))
+		{
+			TRACE_SCOPE("record");
+			if (!failed())
+			{
+				draw(slots_[slot]);
+				if (write(slots_[slot]))
+				{
+					atomic_increment(&written_);
+				}
+				else
+				{
+					atomic_store(&failed_, 1);
+				}
+			}
+			free_.push(slot);
+		}
+		else if (stopping)
+		{
+			break;
+		}
+		else
+		{
+			Thread::sleep(RECORD_POLL);
+		}
+	}
+}
+
+/** \brief A function to draw a frame onto the canvas.
+ *
+ * Every object is drawn in full detail in the same order as the Window
+ * draws them.
+ * \param snap The frame.
+ */
+void Recorder::draw(const Snapshot &snap)
+{
+	View::current(&view_);
+	Canvas::current(&canvas_);
+	int line = (int)(view_.scale() + 0.5);
+	canvas_.line_style((line > 1) ? line : 0);
+	canvas_.clear(SKY_BLUE);
+	for (unsigned int i = 0; i < snap.missiles.size(); i++)
+	{
+		Missile::draw_missile(snap.missiles[i]);
+	}
+	for (unsigned int i = 0; i < snap.ufos.size(); i++)
+	{
+		UFO::draw_ufo(snap.ufos[i]);
+	}
+	for (unsigned int i = 0; i < snap.shells.size(); i++)
+	{
+		Shell::draw_shell(snap.shells[i]);
+	}
+	for (unsigned int i = 0; i < snap.shellexplosions.size(); i++)
+	{
+		ShellExplosion::draw_shellexplosion(snap.shellexplosions[i]);
+	}
+	canvas_.color(GRASS);
+	int ground = (int)view_.y(WORLD_HEIGHT - GROUND_HEIGHT);
+	canvas_.rectf(0, ground, view_.width(), view_.height() - ground);
+	for (unsigned int i = 0; i < snap.bases.size(); i++)
+	{
+		Base::draw_base(snap.bases[i]);
+	}
+	for (unsigned int i = 0; i < snap.guns.size(); i++)
+	{
+		Gun::draw_gun(snap.guns[i]);
+	}
+	canvas_.finish();
+	Canvas::current(0);
+	View::current(0);
+}
+
+/** \brief A function to write the canvas out as a frame.
+ *
+ * \param snap The frame, which gives the frame number for PPM file names.
+ * \return Returns false if the frame could not be written.
+ */
+bool Recorder::write(const Snapshot &snap)
+{
+	size_t size = canvas_.width()*canvas_.height()*3;
+	if (format_ == RECORD_RAW)
+	{
+		return fwrite(canvas_.pixels(), 1, size, stream_) == size;
+	}
+	sprintf(&filename_[0], path_.c_str(), snap.frame);
+	FILE *f = fopen(&filename_[0], "wb");
+	if (!f)
+	{
+		return false;
+	}
+	fprintf(f, "P6\n%d %d\n255\n", canvas_.width(), canvas_.height());
+	bool ok = (fwrite(canvas_.pixels(), 1, size, f) == size);
+	return (fclose(f) == 0) && ok;
+}
@@ -0,0 +1,74 @@
+/** \file Recorder.h
+ * \brief Header file for Recorder class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef RECORDER_H
+#define RECORDER_H
+
+#include <stdio.h>
+
+#include "enum.h"
+#include "thread.h"
+#include "SpscQueue.h"
+#include "Snapshot.h"
+#include "TileCanvas.h"
+#include "View.h"
+
+/** \brief The Recorder class.
+ *
+ * The Recorder class writes every frame a World simulates to disk, drawn
+ * with a TileCanvas so no display is needed. The World captures each frame
+ * into one of RECORD_QUEUE_SIZE Snapshot slots and a thread of the
+ * Recorder's own draws and writes it, so the simulation never waits on the
+ * disk. Large frames can be drawn on several threads. If every slot is
+ * waiting to be written the frame is dropped and counted, unless the
+ * Recorder was opened to wait for a slot instead.
+ *
+ * Frames are written either as one binary PPM file each, named by a
+ * printf() pattern given the frame number, or one after another to a
+ * single file of raw 8 bit RGB pixels with no header, which tools such as
+ * ffmpeg read as "rawvideo". The HUD and messages are not drawn.
+ */
+class Recorder
+{
+public:
+	Recorder();
+	virtual ~Recorder();
+
+	virtual bool open(const char *path, int format, double scale, bool wait, int threads = 1);
+	virtual void close();
+	virtual bool recording();
+	virtual int width();
+	virtual int height();
+	virtual Snapshot* frame();
+	virtual void submit();
+	virtual unsigned long written();
+	virtual unsigned long dropped();
+	virtual bool failed();
+protected:
+	virtual void run();
+	virtual void draw(const Snapshot &snap);
+	virtual bool write(const Snapshot &snap);
+private:
+	static void thread_main(void *recorder);
+	string path_;
+	int format_;
+	bool wait_;
+	FILE *stream_;              ///< the raw stream, 0 when writing PPM files
+	vector<char> filename_;
+	View view_;
+	TileCanvas canvas_;
+	Snapshot slots_[RECORD_QUEUE_SIZE];
+	SpscQueue<int, RECORD_QUEUE_SIZE> free_;  ///< slots the simulation can fill
+	SpscQueue<int, RECORD_QUEUE_SIZE> ready_; ///< slots waiting to be written
+	int current_;               ///< slot handed out by frame(), -1 if none
+	Thread thread_;
+	volatile long running_;
+	volatile long written_;
+	volatile long dropped_;
+	volatile long failed_;
+};
+
+#endif
@@ -0,0 +1,190 @@
+/** \file SaveState.cpp
+ * \brief Code implementation for SaveState class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "SaveState.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#include "MappedFile.h"
+#include "alloc.h"
+#include "random.h"
+#include "Base.h"
+#include "Gun.h"
+#include "Missile.h"
+#include "UFO.h"
+#include "Shell.h"
+#include "ShellExplosion.h"
+
+/** \brief A function to save every object in the registries.
+ *
+ * \param records The vector to fill with one record per object, in the
+ *	order described by ObjectRecord.
+ */
+void SaveState::capture(vector<ObjectRecord> &records)
+{
+	const vector<PlayerItem*> &playeritems = PlayerItem::playeritems();
+	const vector<Projectile*> &projectiles = Projectile::projectiles();
+	const vector<Explosion*> &explosions = Explosion::explosions();
+	ObjectRecord r;
+	memset(&r, 0, sizeof(r));
+	records.assign(playeritems.size() + projectiles.size() + explosions.size(), r);
+	unsigned int n = 0;
+	for (unsigned int i = 0; i < playeritems.size(); i++)
+	{
+		playeritems[i]->save(records[n++]);
+	}
+	for (unsigned int i = 0; i < projectiles.size(); i++)
+	{
+		projectiles[i]->save(records[n++]);
+	}
+	for (unsigned int i = 0; i < explosions.size(); i++)
+	{
+		explosions[i]->save(records[n++]);
+	}
+}
+
+/** \brief A function to recreate objects from their records.
+ *
+ * The objects are added to the current registries in record order.
+ * \param records The records.
+ * \param count The number of records.
+ * \return Returns false if a record has an unknown type, in which case the
+ *	objects before it have been created.
+ */
+bool SaveState::restore(const ObjectRecord *records, unsigned int count)
+{
+	ALLOC_TAG("restore");
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const ObjectRecord &r = records[i];
+		GameObject *obj = 0;
+		switch (r.type)
+		{
+			case OBJECT_BASE:
+				obj = new Base(r.x, r.y);
+				break;
+			case OBJECT_GUN:
+				obj = new Gun(r.x, r.y, r.barrel_width);
+				break;
+			case OBJECT_MISSILE:
+				obj = new Missile(r.start_x, r.start_y, r.target_x, r.target_y, r.velocity);
+				break;
+			case OBJECT_UFO:
+				obj = new UFO(r.start_x, r.start_y, r.target_x, r.target_y, r.velocity);
+				break;
+			case OBJECT_SHELL:
+				obj = new Shell(r.start_x, r.start_y, r.target_x, r.target_y, r.radius);
+				break;
+			case OBJECT_SHELLEXPLOSION:
+				obj = new ShellExplosion(r.x, r.y, r.max_radius);
+				break;
+			default:
+				return false;
+		}
+		obj->load(r);
+	}
+	return true;
+}
+
+/** \brief A function to write a saved game.
+ *
+ * The game scalars (gamestate, score, level, frame, time, the spawn
+ * schedule and the shot and kill counts) are taken from header; the rest of
+ * the header is filled in here along with the objects and the random number
+ * generator state.
+ * \param filename The file to write.
+ * \param header The header to save.
+ * \return Returns true if the file was written.
+ */
+bool SaveState::write(const char *filename, const SaveHeader &header)
+{
+	vector<ObjectRecord> records;
+	capture(records);
+
+	SaveHeader h = header;
+	memcpy(h.magic, SAVE_MAGIC, 4);
+	h.version = SAVE_VERSION;
+	h.byte_order = SAVE_BYTE_ORDER;
+	h.header_size = sizeof(SaveHeader);
+	h.record_size = sizeof(ObjectRecord);
+	h.record_count = records.size();
+	h.records_offset = sizeof(SaveHeader);
+	h.rand_state = game_rand_state();
+
+	FILE *f = fopen(filename, "wb");
+	if (!f)
+	{
+		return false;
+	}
+	bool ok = (fwrite(&h, sizeof(h), 1, f) == 1);
+	if (ok && !records.empty())
+	{
+		ok = (fwrite(&records[0], sizeof(ObjectRecord), records.size(), f) == records.size());
+	}
+	return (fclose(f) == 0) && ok;
+}
+
+/** \brief A function to check a mapped saved game.
+ *
+ * \param file The mapped file.
+ * \return Returns the header of the file, or 0 if the file is not a saved
+ *	game this build can read.
+ */
+const SaveHeader* SaveState::check(MappedFile &file)
+{
+	if (file.size() < sizeof(SaveHeader))
+	{
+		return 0;
+	}
+	const char *base = (const char*)file.data();
+	const SaveHeader *h = (const SaveHeader*)base;
+	if ((memcmp(h->magic, SAVE_MAGIC, 4) != 0) || (h->version != SAVE_VERSION) || (h->byte_order != SAVE_BYTE_ORDER)
+		|| (h->header_size != sizeof(SaveHeader)) || (h->record_size != sizeof(ObjectRecord))
+		|| (h->records_offset % sizeof(double) != 0) || (h->records_offset > file.size())
+		|| ((file.size() - h->records_offset)/sizeof(ObjectRecord) < h->record_count))
+	{
+		return 0;
+	}
+	const ObjectRecord *records = (const ObjectRecord*)(base + h->records_offset);
+	for (unsigned int i = 0; i < h->record_count; i++)
+	{
+		if ((records[i].type <= OBJECT_NONE) || (records[i].type >= OBJECT_TYPES))
+		{
+			return 0;
+		}
+	}
+	return h;
+}
+
+/** \brief A function to map a saved game into memory and check it.
+ *
+ * Nothing is created, so a bad file leaves the game untouched. The file
+ * stays mapped until file is closed, and read() restores from the same
+ * mapping, so a file put in its place after the check is never loaded.
+ * \param file The MappedFile to map it with.
+ * \param filename The file to open.
+ * \return Returns the header of the file, or 0 if the file is not a saved
+ *	game this build can read.
+ */
+const SaveHeader* SaveState::open(MappedFile &file, const char *filename)
+{
+	return file.open(filename) ? check(file) : 0;
+}
+
+/** \brief A function to recreate the objects of a saved game.
+ *
+ * The records are used in place, straight from the mapping. The registries
+ * should be empty beforehand. The random number generator state is restored
+ * too.
+ * \param header The header open() returned, whose file is still mapped.
+ */
+void SaveState::read(const SaveHeader *header)
+{
+	const ObjectRecord *records = (const ObjectRecord*)((const char*)header + header->records_offset);
+	restore(records, header->record_count);
+	game_rand_state(header->rand_state);
+}
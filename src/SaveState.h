@@ -0,0 +1,96 @@
+/** \file SaveState.h
+ * \brief Header file for SaveState class and the saved game file format
+ *
+ * A saved game is a SaveHeader followed by record_count ObjectRecords, all
+ * in native byte order. Every field has a fixed size and offset so the file
+ * can be mapped into memory and used in place.
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef SAVESTATE_H
+#define SAVESTATE_H
+
+#include "enum.h"
+
+class MappedFile;
+
+#define SAVE_MAGIC "FSDS"
+#define SAVE_VERSION 4
+#define SAVE_BYTE_ORDER 0x01020304u
+
+/** \brief Object types stored in ObjectRecord::type.
+ */
+enum {OBJECT_NONE = 0, OBJECT_BASE, OBJECT_GUN, OBJECT_MISSILE, OBJECT_UFO, OBJECT_SHELL, OBJECT_SHELLEXPLOSION, OBJECT_TYPES};
+
+/** \brief The header at the start of a saved game.
+ */
+struct SaveHeader
+{
+	char magic[4];              ///< SAVE_MAGIC, not null terminated
+	unsigned int version;       ///< SAVE_VERSION
+	unsigned int byte_order;    ///< SAVE_BYTE_ORDER as written by the saving machine
+	unsigned int header_size;   ///< sizeof(SaveHeader)
+	unsigned int record_size;   ///< sizeof(ObjectRecord)
+	unsigned int record_count;  ///< number of ObjectRecords
+	unsigned int records_offset; ///< offset in bytes of the first ObjectRecord
+	int gamestate;
+	int score;
+	int level;
+	unsigned int frame;
+	unsigned int rand_state;    ///< state of the game's random number generator
+	int spawn_level;            ///< level the spawn times were drawn for, 0 if not drawn yet
+	unsigned int shells_fired;
+	unsigned int missiles_killed;
+	int reserved;
+	double time;                ///< seconds of game time played
+	double next_ufo;            ///< game time of the next UFO spawn
+	double next_missile;        ///< game time of the next missile spawn
+	double scenario_start;      ///< game time the game, and any Scenario, was started at
+};
+
+/** \brief The saved state of one GameObject.
+ *
+ * Fields that do not apply to the object's type are zero. Records are stored
+ * player items first, then projectiles, then explosions, each in registry
+ * order, so recreating them in file order restores every registry's order.
+ */
+struct ObjectRecord
+{
+	int type;                   ///< one of the OBJECT_ values
+	int level;                  ///< UFO level its next shot was drawn for
+	double x;
+	double y;
+	double radius;
+	double start_x;             ///< Projectile start location
+	double start_y;
+	double target_x;            ///< Projectile target, or Gun aim point
+	double target_y;
+	double velocity;            ///< Projectile velocity
+	double barrel_width;        ///< Gun barrel width
+	double blast_radius;        ///< Shell blast radius
+	double timealive;           ///< Explosion age
+	double max_radius;          ///< ShellExplosion final radius
+	double next_event;          ///< UFO seconds until its next shot
+};
+
+/** \brief The SaveState class.
+ *
+ * The SaveState class writes every object in the registries to a saved game
+ * file and recreates them from one. Each class stores and restores its own
+ * fields through GameObject::save() and GameObject::load(). capture() and
+ * restore() do the same in memory, which World::clone() uses.
+ */
+class SaveState
+{
+public:
+	static void capture(vector<ObjectRecord> &records);
+	static bool restore(const ObjectRecord *records, unsigned int count);
+	static bool write(const char *filename, const SaveHeader &header);
+	static const SaveHeader* open(MappedFile &file, const char *filename);
+	static void read(const SaveHeader *header);
+private:
+	static const SaveHeader* check(MappedFile &file);
+};
+
+#endif
@@ -0,0 +1,272 @@
+/** \file Scenario.cpp
+ * \brief Code implementation for Scenario class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "Scenario.h"
+
+#include <string.h>
+
+#include "SaveState.h"
+
+/** \brief Constructor for Scenario.
+ *
+ * The new Scenario has no file until open() or create() is called.
+ */
+Scenario::Scenario()
+{
+	file_ = 0;
+	writing_ = false;
+	memset(&header_, 0, sizeof(header_));
+	chunk_next_ = 0;
+	chunk_first_ = 0;
+	read_ = 0;
+	last_time_ = 0;
+}
+
+/** \brief Destructor for Scenario.
+ *
+ * The destructor closes the file, finishing it if it is being written.
+ */
+Scenario::~Scenario()
+{
+	close();
+}
+
+/** \brief A function to open a scenario to play.
+ *
+ * Only the header is read here; the spawns are read as next() needs them.
+ * Any file already open is closed first.
+ * \param filename The file to open.
+ * \return Returns false if the file cannot be opened or is not a scenario
+ *	this build can read.
+ */
+bool Scenario::open(const char *filename)
+{
+	close();
+	file_ = fopen(filename, "rb");
+	if (!file_)
+	{
+		return false;
+	}
+	if ((fread(&header_, sizeof(header_), 1, file_) != 1) || (memcmp(header_.magic, SCENARIO_MAGIC, 4) != 0)
+		|| (header_.version != SCENARIO_VERSION) || (header_.byte_order != SCENARIO_BYTE_ORDER)
+		|| (header_.header_size != sizeof(ScenarioHeader)) || (header_.record_size != sizeof(SpawnRecord)))
+	{
+		close();
+		return false;
+	}
+	filename_ = filename;
+	chunk_.reserve(SCENARIO_CHUNK);
+	return rewind();
+}
+
+/** \brief A function to open the scenario another Scenario is playing.
+ *
+ * The file is opened again, so the two are read separately, and this one
+ * carries on from the spawn the other would give next.
+ * \param other The Scenario to copy, opened to play.
+ * \return Returns false if other is not open to play or its file can no
+ *	longer be opened.
+ */
+bool Scenario::open(Scenario &other)
+{
+	if (!other.file_ || other.writing_)
+	{
+		return false;
+	}
+	string filename = other.filename_;
+	unsigned int position = other.chunk_first_ + other.chunk_next_;
+	if (!open(filename.c_str()))
+	{
+		return false;
+	}
+	position = (position < header_.record_count) ? position : header_.record_count;
+	if (fseek(file_, (long)(header_.header_size + position*sizeof(SpawnRecord)), SEEK_SET) != 0)
+	{
+		close();
+		return false;
+	}
+	chunk_first_ = position;
+	read_ = position;
+	return true;
+}
+
+/** \brief A function to start writing a scenario.
+ *
+ * Any file already open is closed first. The spawns are added with write()
+ * and the file is finished by close().
+ * \param filename The file to write.
+ * \return Returns false if the file cannot be written.
+ */
+bool Scenario::create(const char *filename)
+{
+	close();
+	file_ = fopen(filename, "wb");
+	if (!file_)
+	{
+		return false;
+	}
+	writing_ = true;
+	memcpy(header_.magic, SCENARIO_MAGIC, 4);
+	header_.version = SCENARIO_VERSION;
+	header_.byte_order = SCENARIO_BYTE_ORDER;
+	header_.header_size = sizeof(ScenarioHeader);
+	header_.record_size = sizeof(SpawnRecord);
+	header_.record_count = 0;
+	last_time_ = 0;
+	if (fwrite(&header_, sizeof(header_), 1, file_) != 1)
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+/** \brief A function to close the file.
+ *
+ * A scenario being written is finished by filling in the number of spawns.
+ * \return Returns false if a scenario being written could not be finished.
+ */
+bool Scenario::close()
+{
+	bool ok = true;
+	if (file_)
+	{
+		if (writing_)
+		{
+			ok = (fseek(file_, 0, SEEK_SET) == 0) && (fwrite(&header_, sizeof(header_), 1, file_) == 1);
+		}
+		ok = (fclose(file_) == 0) && ok;
+	}
+	file_ = 0;
+	filename_.clear();
+	writing_ = false;
+	memset(&header_, 0, sizeof(header_));
+	chunk_.clear();
+	chunk_next_ = 0;
+	chunk_first_ = 0;
+	read_ = 0;
+	return ok;
+}
+
+/** \brief A function to add a spawn to a scenario being written.
+ *
+ * \param r The spawn, which must not be earlier than the last one.
+ * \return Returns false if the spawn is out of order, of the wrong type or
+ *	could not be written.
+ */
+bool Scenario::write(const SpawnRecord &r)
+{
+	if (!file_ || !writing_ || (r.time < last_time_) || ((r.type != OBJECT_MISSILE) && (r.type != OBJECT_UFO))
+		|| (header_.record_count == 0xffffffffu))
+	{
+		return false;
+	}
+	if (fwrite(&r, sizeof(r), 1, file_) != 1)
+	{
+		return false;
+	}
+	last_time_ = r.time;
+	header_.record_count++;
+	return true;
+}
+
+/** \brief A function to play the scenario again from the start.
+ *
+ * \return Returns false if no scenario is open to play.
+ */
+bool Scenario::rewind()
+{
+	if (!file_ || writing_ || (fseek(file_, header_.header_size, SEEK_SET) != 0))
+	{
+		return false;
+	}
+	chunk_.clear();
+	chunk_next_ = 0;
+	chunk_first_ = 0;
+	read_ = 0;
+	return true;
+}
+
+/** \brief A function to play the scenario from a given time.
+ *
+ * The scenario is rewound and every spawn due by time is skipped, as if
+ * next() had already given them.
+ * \param time The game time in seconds since the game started.
+ * \return Returns false if no scenario is open to play.
+ */
+bool Scenario::seek(double time)
+{
+	if (!rewind())
+	{
+		return false;
+	}
+	SpawnRecord r;
+	while (next(time, r))
+	{
+	}
+	return true;
+}
+
+/** \brief A function to take the next spawn that is due.
+ *
+ * \param time The game time in seconds since the game started.
+ * \param r Set to the spawn.
+ * \return Returns false if the next spawn is later than time, or there are
+ *	none left.
+ */
+bool Scenario::next(double time, SpawnRecord &r)
+{
+	if ((chunk_next_ >= chunk_.size()) && !fill())
+	{
+		return false;
+	}
+	if (chunk_[chunk_next_].time > time)
+	{
+		return false;
+	}
+	r = chunk_[chunk_next_];
+	chunk_next_++;
+	return true;
+}
+
+/** \brief A function to return the number of spawns in the scenario.
+ *
+ * \return Returns the number of spawns written or to be played.
+ */
+unsigned int Scenario::count()
+{
+	return header_.record_count;
+}
+
+/** \brief A function to read the next chunk of spawns.
+ *
+ * A short read or a spawn of an unknown type ends the scenario there.
+ * \return Returns false if there are no spawns left.
+ */
+bool Scenario::fill()
+{
+	chunk_.clear();
+	chunk_next_ = 0;
+	chunk_first_ = read_;
+	if (!file_ || writing_ || (read_ >= header_.record_count))
+	{
+		return false;
+	}
+	unsigned int n = header_.record_count - read_;
+	n = (n < SCENARIO_CHUNK) ? n : SCENARIO_CHUNK;
+	chunk_.resize(n);
+	unsigned int got = fread(&chunk_[0], sizeof(SpawnRecord), n, file_);
+	for (unsigned int i = 0; i < got; i++)
+	{
+		if ((chunk_[i].type != OBJECT_MISSILE) && (chunk_[i].type != OBJECT_UFO))
+		{
+			got = i;
+		}
+	}
+	chunk_.resize(got);
+	read_ = (got == n) ? read_ + n : header_.record_count;
+	return !chunk_.empty();
+}
@@ -0,0 +1,85 @@
+/** \file Scenario.h
+ * \brief Header file for Scenario class and the scenario file format
+ *
+ * A scenario is a ScenarioHeader followed by record_count SpawnRecords in
+ * order of time, all in native byte order, so it can be written and read
+ * one record at a time.
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef SCENARIO_H
+#define SCENARIO_H
+
+#include <stdio.h>
+
+#include "enum.h"
+
+#define SCENARIO_MAGIC "FSDW"
+#define SCENARIO_VERSION 1
+#define SCENARIO_BYTE_ORDER 0x01020304u
+
+/** \brief The header at the start of a scenario.
+ */
+struct ScenarioHeader
+{
+	char magic[4];              ///< SCENARIO_MAGIC, not null terminated
+	unsigned int version;       ///< SCENARIO_VERSION
+	unsigned int byte_order;    ///< SCENARIO_BYTE_ORDER as written by the writing machine
+	unsigned int header_size;   ///< sizeof(ScenarioHeader), where the first SpawnRecord starts
+	unsigned int record_size;   ///< sizeof(SpawnRecord)
+	unsigned int record_count;  ///< number of SpawnRecords
+};
+
+/** \brief One timed spawn of a scenario.
+ */
+struct SpawnRecord
+{
+	double time;                ///< seconds of game time after the game starts
+	int type;                   ///< OBJECT_MISSILE or OBJECT_UFO
+	int reserved;
+	double start_x;
+	double start_y;
+	double target_x;
+	double target_y;
+	double velocity;
+};
+
+/** \brief The Scenario class.
+ *
+ * The Scenario class writes and plays back scripted waves of enemies. While
+ * a World plays a Scenario every Missile and UFO comes from it instead of
+ * from random rolls, so a game is the same on any build whatever its random
+ * numbers. The file is streamed SCENARIO_CHUNK spawns at a time, each chunk
+ * read before the first of its spawns is due, so scenarios of any length
+ * are played in a fixed amount of memory.
+ */
+class Scenario
+{
+public:
+	Scenario();
+	virtual ~Scenario();
+
+	virtual bool open(const char *filename);
+	virtual bool open(Scenario &other);
+	virtual bool create(const char *filename);
+	virtual bool close();
+	virtual bool write(const SpawnRecord &r);
+	virtual bool rewind();
+	virtual bool seek(double time);
+	virtual bool next(double time, SpawnRecord &r);
+	virtual unsigned int count();
+private:
+	bool fill();
+	FILE *file_;
+	string filename_;
+	bool writing_;
+	ScenarioHeader header_;
+	vector<SpawnRecord> chunk_;
+	unsigned int chunk_next_; ///< index in chunk_ of the next spawn
+	unsigned int chunk_first_; ///< index in the file of chunk_[0]
+	unsigned int read_;       ///< spawns read from the file so far
+	double last_time_;        ///< time of the last spawn written
+};
+
+#endif
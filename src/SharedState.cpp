@@ -0,0 +1,312 @@
+/** \file SharedState.cpp
+ * \brief Code implementation for SharedState class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "SharedState.h"
+
+#include <string.h>
+
+#ifndef WIN32
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <errno.h>
+#include <unistd.h>
+#endif
+
+/** \brief A function to add one kind of object to a shared frame.
+ *
+ * \param f The frame.
+ * \param kind The SHARED_ value of the objects.
+ * \param states The drawing states of the objects.
+ * \param count The number of entities in the frame, added to.
+ * \param total The number of objects in the snapshot, added to.
+ */
+template <class T>
+static void add(SharedFrame &f, int kind, const vector<T> &states, int &count, int &total)
+{
+	for (unsigned int i = 0; i < states.size(); i++, total++)
+	{
+		if (count < SHARED_ENTITIES)
+		{
+			SharedEntity &e = f.entities[count++];
+			e.kind = kind;
+			e.x = (float)states[i].x;
+			e.y = (float)states[i].y;
+			e.radius = (float)states[i].radius;
+		}
+	}
+}
+
+/** \brief Constructor for SharedState.
+ */
+SharedState::SharedState()
+{
+	owner_ = false;
+	header_ = 0;
+#ifdef WIN32
+	mapping_ = 0;
+#else
+	fd_ = -1;
+#endif
+}
+
+/** \brief Destructor for SharedState.
+ *
+ * The destructor closes the shared memory if it is open.
+ */
+SharedState::~SharedState()
+{
+	close();
+}
+
+/** \brief A function to create the shared memory and start publishing to it.
+ *
+ * A block of the same name is only taken over if the game that created it
+ * has closed it, so a second game can never write over a live one. A block
+ * left by a game that was killed must be removed (from /dev/shm on most
+ * POSIX systems) before its name can be used again.
+ * \param name The name of the block. On POSIX systems a leading / is added
+ *	if it is missing.
+ * \return Returns true if the block was created.
+ */
+bool SharedState::create(const char *name)
+{
+	close();
+	bool existed;
+	if (!map(name, true, existed))
+	{
+		return false;
+	}
+	if (existed && ((header_->magic != SHARED_MAGIC) || (header_->version != SHARED_VERSION)
+		|| (header_->header_size != sizeof(SharedHeader)) || (atomic_load(&header_->closed) == 0)))
+	{
+		owner_ = false; // so close() leaves it alone
+		close();
+		return false;
+	}
+	memset(header_, 0, sizeof(SharedHeader));
+	header_->magic = SHARED_MAGIC;
+	header_->version = SHARED_VERSION;
+	header_->slots = SHARED_SLOTS;
+	header_->entities = SHARED_ENTITIES;
+	header_->header_size = sizeof(SharedHeader);
+	header_->frame_size = sizeof(SharedFrame);
+	return true;
+}
+
+/** \brief A function to open shared memory a game is publishing to, for reading.
+ *
+ * \param name The name the game created the block with.
+ * \return Returns true if the block exists and has the layout of this build.
+ */
+bool SharedState::attach(const char *name)
+{
+	close();
+	bool existed;
+	if (!map(name, false, existed))
+	{
+		return false;
+	}
+	if ((header_->magic != SHARED_MAGIC) || (header_->version != SHARED_VERSION)
+		|| (header_->slots != SHARED_SLOTS) || (header_->entities != SHARED_ENTITIES)
+		|| (header_->header_size != sizeof(SharedHeader)) || (header_->frame_size != sizeof(SharedFrame)))
+	{
+		close();
+		return false;
+	}
+	return true;
+}
+
+/** \brief A function to map the block into memory.
+ *
+ * Readers map it writable too, as the atomic reads on Windows need that.
+ * \param name The name of the block.
+ * \param owner Whether to create the block if it does not exist, rather
+ *	than only open an existing one.
+ * \param existed Set to whether the block already existed.
+ * \return Returns true if the block was mapped.
+ */
+bool SharedState::map(const char *name, bool owner, bool &existed)
+{
+	existed = !owner;
+#ifdef WIN32
+	name_ = (name[0] == '/') ? name + 1 : name;
+	if (owner)
+	{
+		mapping_ = CreateFileMappingA(INVALID_HANDLE_VALUE, NULL, PAGE_READWRITE, 0, sizeof(SharedHeader), name_.c_str());
+		existed = (GetLastError() == ERROR_ALREADY_EXISTS);
+	}
+	else
+	{
+		mapping_ = OpenFileMappingA(FILE_MAP_ALL_ACCESS, FALSE, name_.c_str());
+	}
+	if (!mapping_)
+	{
+		return false;
+	}
+	header_ = (SharedHeader*)MapViewOfFile(mapping_, FILE_MAP_ALL_ACCESS, 0, 0, sizeof(SharedHeader));
+	if (!header_)
+	{
+		CloseHandle(mapping_);
+		mapping_ = 0;
+		return false;
+	}
+#else
+	name_ = (name[0] == '/') ? string(name) : "/" + string(name);
+	fd_ = owner ? shm_open(name_.c_str(), O_RDWR | O_CREAT | O_EXCL, 0644) : -1;
+	if ((fd_ < 0) && (!owner || (errno == EEXIST)))
+	{
+		existed = true;
+		fd_ = shm_open(name_.c_str(), O_RDWR, 0644);
+	}
+	if (fd_ < 0)
+	{
+		return false;
+	}
+	struct stat info;
+	if ((!existed && (ftruncate(fd_, sizeof(SharedHeader)) != 0))
+		|| (fstat(fd_, &info) != 0) || (info.st_size < (off_t)sizeof(SharedHeader)))
+	{
+		::close(fd_);
+		fd_ = -1;
+		return false;
+	}
+	void *p = mmap(0, sizeof(SharedHeader), PROT_READ | PROT_WRITE, MAP_SHARED, fd_, 0);
+	if (p == MAP_FAILED)
+	{
+		::close(fd_);
+		fd_ = -1;
+		return false;
+	}
+	header_ = (SharedHeader*)p;
+#endif
+	owner_ = owner;
+	return true;
+}
+
+/** \brief A function to close the shared memory.
+ *
+ * If this created the block, readers are told the game has stopped
+ * publishing and the block is removed once they have all closed it too.
+ */
+void SharedState::close()
+{
+	if (!header_)
+	{
+		return;
+	}
+	if (owner_)
+	{
+		atomic_store(&header_->closed, 1);
+	}
+#ifdef WIN32
+	UnmapViewOfFile(header_);
+	CloseHandle(mapping_);
+	mapping_ = 0;
+#else
+	munmap(header_, sizeof(SharedHeader));
+	::close(fd_);
+	fd_ = -1;
+	if (owner_)
+	{
+		shm_unlink(name_.c_str());
+	}
+#endif
+	header_ = 0;
+	owner_ = false;
+}
+
+/** \brief A function to return whether frames are being published.
+ *
+ * \return Returns true if this created the shared memory and has not closed it.
+ */
+bool SharedState::publishing()
+{
+	return header_ && owner_;
+}
+
+/** \brief A function to write a frame to the shared memory.
+ *
+ * The frame goes in the slot after the latest, which readers are then
+ * pointed at. Only one thread may publish.
+ * \param snap The frame.
+ */
+void SharedState::publish(const Snapshot &snap)
+{
+	if (!publishing())
+	{
+		return;
+	}
+	int n = header_->published;
+	SharedFrame &f = header_->frames[(unsigned int)n % SHARED_SLOTS];
+	atomic_increment(&f.sequence);
+	f.frame = (unsigned int)snap.frame;
+	f.gamestate = snap.gamestate;
+	f.score = snap.score;
+	f.level = snap.level;
+	int count = 0;
+	int total = 0;
+	add(f, SHARED_BASE, snap.bases, count, total);
+	add(f, SHARED_GUN, snap.guns, count, total);
+	add(f, SHARED_MISSILE, snap.missiles, count, total);
+	add(f, SHARED_UFO, snap.ufos, count, total);
+	add(f, SHARED_SHELL, snap.shells, count, total);
+	add(f, SHARED_EXPLOSION, snap.shellexplosions, count, total);
+	f.count = count;
+	f.dropped = total - count;
+	atomic_increment(&f.sequence);
+	atomic_store(&header_->published, n + 1);
+}
+
+/** \brief A function to start reading the latest frame.
+ *
+ * The frame is read where it is in the shared memory. Nothing read from it
+ * can be trusted until end_read() says the frame was not overwritten.
+ * \param sequence Set to the frame's sequence number, to pass to end_read().
+ * \return Returns the frame, or 0 if there is none yet or it is being
+ *	written, in which case try again.
+ */
+const SharedFrame* SharedState::begin_read(int &sequence)
+{
+	if (!header_)
+	{
+		return 0;
+	}
+	int n = atomic_load(&header_->published);
+	if (n == 0)
+	{
+		return 0;
+	}
+	SharedFrame &f = header_->frames[(unsigned int)(n - 1) % SHARED_SLOTS];
+	sequence = atomic_load(&f.sequence);
+	if (sequence & 1)
+	{
+		return 0;
+	}
+	return &f;
+}
+
+/** \brief A function to finish reading a frame.
+ *
+ * \param frame The frame begin_read() returned.
+ * \param sequence The sequence number begin_read() gave.
+ * \return Returns true if the frame was not written to while it was read,
+ *	so what was read is consistent.
+ */
+bool SharedState::end_read(const SharedFrame *frame, int sequence)
+{
+	memory_barrier();
+	return atomic_load(const_cast<volatile int*>(&frame->sequence)) == sequence;
+}
+
+/** \brief A function to return whether the game has stopped publishing.
+ *
+ * \return Returns true if the block is not open or its creator has closed it.
+ */
+bool SharedState::closed()
+{
+	return !header_ || (atomic_load(&header_->closed) != 0);
+}
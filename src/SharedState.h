@@ -0,0 +1,98 @@
+/** \file SharedState.h
+ * \brief Header file for SharedState class
+ *
+ * The layout of the shared memory is given here too, so that other programs
+ * can read it by including this file alone. Every field is 32 bits wide, so
+ * 32 and 64 bit programs agree on it.
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef SHAREDSTATE_H
+#define SHAREDSTATE_H
+
+#include "enum.h"
+#include "thread.h"
+#include "Snapshot.h"
+
+/** \brief An object in a shared frame.
+ */
+struct SharedEntity
+{
+	int kind;     ///< one of the SHARED_ values
+	float x;      ///< world units
+	float y;
+	float radius;
+};
+
+/** \brief One frame of the game in shared memory.
+ */
+struct SharedFrame
+{
+	volatile int sequence;  ///< odd while the frame is being written
+	unsigned int frame;
+	int gamestate;
+	int score;
+	int level;
+	int count;              ///< entities written
+	int dropped;            ///< entities that did not fit
+	SharedEntity entities[SHARED_ENTITIES];
+};
+
+/** \brief The whole of the shared memory.
+ */
+struct SharedHeader
+{
+	int magic;                 ///< SHARED_MAGIC
+	int version;               ///< SHARED_VERSION
+	int slots;                 ///< SHARED_SLOTS
+	int entities;              ///< SHARED_ENTITIES
+	unsigned int header_size;  ///< sizeof(SharedHeader)
+	unsigned int frame_size;   ///< sizeof(SharedFrame)
+	volatile int published;    ///< frames written, the latest is in slot (published - 1) % slots
+	volatile int closed;       ///< set when the game stops publishing
+	SharedFrame frames[SHARED_SLOTS];
+};
+
+/** \brief The SharedState class.
+ *
+ * The SharedState class publishes every frame a World simulates into a
+ * named block of shared memory, so other processes such as viewers, bots
+ * and dashboards can watch a game without slowing it down. The block is a
+ * ring of SHARED_SLOTS frames and nothing is locked: the game never waits
+ * for a reader, and readers check they were not overtaken instead.
+ *
+ * Each frame carries a sequence number that is odd while it is being
+ * written. A reader takes the latest frame from begin_read(), reads it in
+ * place, then asks end_read() whether the sequence number is unchanged; if
+ * not, the game wrote over the frame meanwhile and the reader tries again.
+ *
+ * The block is POSIX shared memory, or a named file mapping on Windows. The
+ * SharedState that creates it removes it again on close().
+ */
+class SharedState
+{
+public:
+	SharedState();
+	virtual ~SharedState();
+
+	virtual bool create(const char *name);
+	virtual bool attach(const char *name);
+	virtual void close();
+	virtual bool publishing();
+	virtual void publish(const Snapshot &snap);
+	virtual const SharedFrame* begin_read(int &sequence);
+	virtual bool end_read(const SharedFrame *frame, int sequence);
+	virtual bool closed();
+private:
+	bool map(const char *name, bool owner, bool &existed);
+	string name_;
+	bool owner_;           ///< whether this created the block
+	SharedHeader *header_; ///< 0 if not open
+#ifdef WIN32
+	HANDLE mapping_;
+#else
+	int fd_;
+#endif
+};
+
+#endif
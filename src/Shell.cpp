@@ -5,28 +5,22 @@
  * \date May 2007
  */
 #include "Shell.h"
-#include "ShellExplosion.h"
-
-#include <Fl/fl_draw.h>
-
-/** \brief Global vector of pointers to all Shell objects.
- *
- * This vector stores pointers to all Shell objects. It is self-managed.
- * When a Shell object is created, it adds itself to the vector and when
- * it is destroyed it removes itself from the vector.
- */
-vector<Shell*> Shell::shells_;
+#include "WorldState.h"
+#include "SaveState.h"
+#include "View.h"
+#include "Canvas.h"
+#include "CommandBuffer.h"
 
 /** \brief Constructor for Shell.
  *
- * The constructor adds the Shell object to the global vector of shells.
+ * The constructor adds the Shell object to the current world's vector of shells.
  * To create an object, use "new Shell(...)" and the object can be 
  * accessed via the Shell::shells() function.
  */
 Shell::Shell(double startx, double starty, double endx, double endy, double radius) : Projectile(startx, starty, endx, endy, radius, SHELL_VELOCITY)
 {
 	shell_blast_radius_ = radius*SHELL_BLAST_FACTOR;
-	shells_.push_back(this);
+	WorldState::current().shells.push_back(this);
 }
 
 /** \brief Destructor for Shell.
@@ -36,12 +30,13 @@ Shell::Shell(double startx, double starty, double endx, double endy, double radi
  */
 Shell::~Shell()
 {
+	vector<Shell*> &shells = WorldState::current().shells;
 	vector<Shell*>::iterator it;
-	for (it = shells_.begin(); it != shells_.end(); it++)
+	for (it = shells.begin(); it != shells.end(); it++)
 	{
 		if ((*it) == this)
 		{
-			shells_.erase(it);
+			shells.erase(it);
 			break;
 		}
 	}
@@ -56,43 +51,68 @@ Shell::~Shell()
  */
 const vector<Shell*>& Shell::shells()
 {
-	return shells_;
+	return WorldState::current().shells;
 }
 
 /** \brief A function to generate explosions on death.
  *
  * This function should be called whenever a shell is deleted during the game.
  * This is not called in the destructor as it would cause problems on cleanup.
- * The function generates a ShellExplosion at the current location of the Shell.
+ * The function records a ShellExplosion at the current location of the Shell
+ * in the CommandBuffer, along with the flash it makes.
  */
 void Shell::on_death()
 {
-	new ShellExplosion(x(), y(), shell_blast_radius_);
+	CommandBuffer::spawn_shellexplosion(x(), y(), shell_blast_radius_);
+	CommandBuffer::effect(EFFECT_FLASH, x(), y(), shell_blast_radius_);
 }
 
-/** \brief The interface to draw the Shell.
+/** \brief The interface to capture the Shell for drawing.
  *
- * This protected draw() function calls the private draw_shell() function
- * to draw the object
+ * This protected capture() function adds the drawing state of the Shell
+ * to the snapshot.
+ * \param snap The snapshot being filled in.
  */
-void Shell::draw()
+void Shell::capture(Snapshot &snap)
 {
-	draw_shell();
+	ShellState s;
+	s.handle = handle();
+	s.x = x();
+	s.y = y();
+	s.radius = radius();
+	s.target_x = target_x();
+	s.target_y = target_y();
+	s.blast_radius = shell_blast_radius_;
+	snap.shells.push_back(s);
 }
 
 /** \brief The specialised drawing function for Shell.
  *
- * The draw_shell() function uses the FLTK routines to draw the Shell in
- * the form of a ball.
+ * The draw_shell() function uses the FLTK routines to draw a captured Shell
+ * in the form of a ball.
+ * \param s The drawing state of the Shell.
  */
-void Shell::draw_shell()
+void Shell::draw_shell(const ShellState &s)
 {
-	fl_color(GREY);
-	fl_pie((int)(x()-radius()), (int)(y()-radius()), (int)(radius()*2), (int)(radius()*2), 0, 360);
+	const View &v = View::current();
+	Canvas &canvas = Canvas::current();
+	canvas.color(GREY);
+	canvas.pie((int)v.x(s.x-s.radius), (int)v.y(s.y-s.radius), (int)v.size(s.radius*2), (int)v.size(s.radius*2), 0, 360);
 #ifdef DEBUG
-	fl_color(FL_RED);
-	fl_circle(target_x(), target_y(), shell_blast_radius_);
-	fl_color(FL_GRAY);
-	fl_circle(target_x(), target_y(), radius());
+	canvas.color(FL_RED);
+	canvas.circle(v.x(s.target_x), v.y(s.target_y), v.size(s.blast_radius));
+	canvas.color(FL_GRAY);
+	canvas.circle(v.x(s.target_x), v.y(s.target_y), v.size(s.radius));
 #endif
 }
+
+/** \brief A function to save the Shell's state.
+ *
+ * \param r The record to save into.
+ */
+void Shell::save(ObjectRecord &r)
+{
+	Projectile::save(r);
+	r.type = OBJECT_SHELL;
+	r.blast_radius = shell_blast_radius_;
+}
@@ -8,6 +8,7 @@
 #define SHELL_H
 
 #include "Projectile.h"
+#include "Snapshot.h"
 
 /** \brief The Shell class.
  *
@@ -21,13 +22,15 @@ public:
 	Shell(double startx, double starty, double endx, double endy, double radius);
 	virtual ~Shell();
 
+	friend class World;
+
 	static const vector<Shell*>& shells();
 	virtual void on_death();
+	static void draw_shell(const ShellState &s);
+	virtual void save(ObjectRecord &r);
 protected:
-	virtual void draw();
+	void capture(Snapshot &snap);
 private:
-	static vector<Shell*> shells_;
-	virtual void draw_shell();
 	double shell_blast_radius_;
 };
 
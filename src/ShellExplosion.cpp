@@ -5,43 +5,44 @@
  * \date May 2007
  */
 #include "ShellExplosion.h"
+#include "WorldState.h"
+#include "SaveState.h"
 #include "EnemyItem.h"
+#include "CommandBuffer.h"
+#include "KillMask.h"
+#include "View.h"
+#include "Canvas.h"
 
-#include <Fl/fl_draw.h>
-
-/** \brief Global vector of pointers to all ShellExplosion objects.
- *
- * This vector stores pointers to all ShellExplosion objects. It is self-managed.
- * When a ShellExplosion object is created, it adds itself to the vector and when
- * it is destroyed it removes itself from the vector.
- */
-vector<ShellExplosion*> ShellExplosion::shellexplosions_;
+#include <math.h>
 
 /** \brief Constructor for ShellExplosion.
  *
- * The constructor adds the ShellExplosion object to the global vector of shells.
+ * The constructor adds the ShellExplosion object to the current world's vector of shells.
  * To create an object, use "new ShellExplosion(...)" and the object can be 
  * accessed via the ShellExplosion::shellexplosions() function.
  */
 ShellExplosion::ShellExplosion(double x, double y, double r) : Explosion(x, y, r)
 {
 	max_radius_ = r;
-	shellexplosions_.push_back(this);
+	mask_mark_ = -1;
+	WorldState::current().shellexplosions.push_back(this);
 }
 
 /** \brief Destructor for ShellExplosion.
  *
  * The destructor searches through the vector for the 'this' item and
- * removes it from the vector.
+ * removes it from the vector, and takes it off the world's KillMask.
  */
 ShellExplosion::~ShellExplosion()
 {
+	WorldState::current().kill_mask.remove(this);
+	vector<ShellExplosion*> &shellexplosions = WorldState::current().shellexplosions;
 	vector<ShellExplosion*>::iterator it;
-	for (it = shellexplosions_.begin(); it != shellexplosions_.end(); it++)
+	for (it = shellexplosions.begin(); it != shellexplosions.end(); it++)
 	{
 		if ((*it) == this)
 		{
-			shellexplosions_.erase(it);
+			shellexplosions.erase(it);
 			break;
 		}
 	}
@@ -56,46 +57,129 @@ ShellExplosion::~ShellExplosion()
  */
 const vector<ShellExplosion*>& ShellExplosion::shellexplosions()
 {
-	return shellexplosions_;
+	return WorldState::current().shellexplosions;
 }
 
-/** \brief The interface to draw the ShellExplosion.
+/** \brief The interface to capture the ShellExplosion for drawing.
  *
- * This protected draw() function calls the private draw_shellexplosion() function
- * to draw the object
+ * This protected capture() function adds the drawing state of the ShellExplosion
+ * to the snapshot.
+ * \param snap The snapshot being filled in.
  */
-void ShellExplosion::draw()
+void ShellExplosion::capture(Snapshot &snap)
 {
-	draw_shellexplosion();
+	ShellExplosionState s;
+	s.handle = handle();
+	s.x = x();
+	s.y = y();
+	s.radius = radius();
+	s.timealive = timealive();
+	snap.shellexplosions.push_back(s);
 }
 
 /** \brief The specialised drawing function for ShellExplosion.
  *
- * The draw_shell() function uses the FLTK routines to draw the explosion in
- * the form of an expanding fireball. The initial shockwave is invisible, so do
+ * The draw_shell() function uses the FLTK routines to draw a captured explosion
+ * in the form of an expanding fireball. The initial shockwave is invisible, so do
  * not draw if within initial period.
+ * \param s The drawing state of the ShellExplosion.
+ * \param fill Optional: Draw only the outline of the fireball if false, defaults to true.
  */
-void ShellExplosion::draw_shellexplosion()
+void ShellExplosion::draw_shellexplosion(const ShellExplosionState &s, bool fill)
 {
-	if (timealive() > SE_INITIAL_PERIOD)
+	const View &v = View::current();
+	Canvas &canvas = Canvas::current();
+	if (s.timealive > SE_INITIAL_PERIOD)
 	{
-		fl_color(FL_RED);
-		fl_pie((int)(x() - radius()), (int)(y() - radius()), (int)(radius()*2), (int)(radius()*2), 0, 360);
+		canvas.color(FL_RED);
+		if (fill)
+		{
+			canvas.pie((int)v.x(s.x - s.radius), (int)v.y(s.y - s.radius), (int)v.size(s.radius*2), (int)v.size(s.radius*2), 0, 360);
+		}
+		else
+		{
+			canvas.arc((int)v.x(s.x - s.radius), (int)v.y(s.y - s.radius), (int)v.size(s.radius*2), (int)v.size(s.radius*2), 0, 360);
+		}
 	}
 }
 
-/** \brief The collision detection function that destroys EnemyItem objects.
+/** \brief Scratch grid used by draw_merged(), kept between frames.
+ */
+static vector<unsigned char> merge_cells;
+
+/** \brief A drawing function for many overlapping ShellExplosions.
  *
- * The collision detecion function increments the radius of the fireball and then destroys
- * all EnemyItem objects that touch the explosion. Score is incremented by 1 for each item
- * that the explosion destroys.
- * \param scr Optional: The current score of the game, defaults to zero if unspecified.
- * \return Returns the new score.
+ * The draw_merged() function marks every cell of a coarse grid whose centre
+ * is inside a visible explosion, then draws each horizontal run of marked
+ * cells as one rectangle. Overlapping explosions merge into a single shape
+ * and the cost depends on the screen area covered rather than the number
+ * of explosions.
+ * \param s The drawing states of all the ShellExplosions.
  */
-int ShellExplosion::collision_detect(int scr)
+void ShellExplosion::draw_merged(const vector<ShellExplosionState> &s)
 {
-	int score = scr;
+	const View &v = View::current();
+	Canvas &canvas = Canvas::current();
+	const int cell = LOD_EXPLOSION_CELL;
+	const int cols = (WORLD_WIDTH + cell - 1)/cell;
+	const int rows = (WORLD_HEIGHT + cell - 1)/cell;
+	merge_cells.assign(cols*rows, 0);
+	for (unsigned int i = 0; i < s.size(); i++)
+	{
+		if (s[i].timealive <= SE_INITIAL_PERIOD)
+		{
+			continue;
+		}
+		int row_min = (int)((s[i].y - s[i].radius)/cell);
+		int row_max = (int)((s[i].y + s[i].radius)/cell);
+		for (int r = row_min < 0 ? 0 : row_min; (r <= row_max) && (r < rows); r++)
+		{
+			double dy = (r + 0.5)*cell - s[i].y;
+			double half = s[i].radius*s[i].radius - dy*dy;
+			if (half < 0)
+			{
+				continue;
+			}
+			half = sqrt(half);
+			int c_min = (int)ceil((s[i].x - half)/cell - 0.5);
+			int c_max = (int)floor((s[i].x + half)/cell - 0.5);
+			for (int c = c_min < 0 ? 0 : c_min; (c <= c_max) && (c < cols); c++)
+			{
+				merge_cells[r*cols + c] = 1;
+			}
+		}
+	}
+	canvas.color(FL_RED);
+	for (int r = 0; r < rows; r++)
+	{
+		int c = 0;
+		while (c < cols)
+		{
+			if (merge_cells[r*cols + c] == 0)
+			{
+				c++;
+				continue;
+			}
+			int start = c;
+			while ((c < cols) && (merge_cells[r*cols + c] != 0))
+			{
+				c++;
+			}
+			// both edges are rounded so neighbouring runs and rows meet exactly
+			int left = (int)floor(v.x(start*cell));
+			int top = (int)floor(v.y(r*cell));
+			canvas.rectf(left, top, (int)floor(v.x(c*cell)) - left, (int)floor(v.y((r + 1)*cell)) - top);
+		}
+	}
+}
 
+/** \brief A function to grow the fireball.
+ *
+ * The radius is the full blast radius during the initial shockwave, then grows
+ * from nothing back to the full radius over the first second.
+ */
+void ShellExplosion::grow()
+{
 	if ((timealive() < 1) && (timealive() > SE_INITIAL_PERIOD))
 	{
 		radius(max_radius_*timealive());
@@ -104,21 +188,104 @@ int ShellExplosion::collision_detect(int scr)
 	{
 		radius(max_radius_);
 	}
+}
+
+/** \brief A function to destroy an EnemyItem caught in an explosion.
+ *
+ * \param e The enemy.
+ * \param score The current score of the game.
+ * \return Returns the new score.
+ */
+int ShellExplosion::kill(EnemyItem *e, int score)
+{
+	e->on_shot_down();
+	e->on_death();
+	CommandBuffer::destroy(e);
+	return score + 1;
+}
+
+/** \brief The collision detection function that destroys EnemyItem objects.
+ *
+ * The collision detecion function increments the radius of the fireball and then destroys
+ * all EnemyItem objects that touch the explosion through the CommandBuffer. Score is
+ * incremented by 1 for each item that the explosion destroys. Items already destroyed
+ * this update are ignored.
+ * \param scr Optional: The current score of the game, defaults to zero if unspecified.
+ * \return Returns the new score.
+ */
+int ShellExplosion::collision_detect(int scr)
+{
+	int score = scr;
 
+	grow();
 	for (int i = 0; i < (int)EnemyItem::enemyitems().size(); i++)
 	{
-		double x_diff = EnemyItem::enemyitems()[i]->x() - x();
-		double y_diff = EnemyItem::enemyitems()[i]->y() - y();
-		if (x_diff*x_diff + y_diff*y_diff <= (radius()+EnemyItem::enemyitems()[i]->radius())*(radius()+EnemyItem::enemyitems()[i]->radius()))
+		if (EnemyItem::enemyitems()[i]->dead())
+		{
+			continue;
+		}
+		if (touching(EnemyItem::enemyitems()[i]))
 		{
 #ifdef DEBUG
 			cout << "shell interacted with enemy item " << i << endl;
 #endif
-			EnemyItem::enemyitems()[i]->on_death();
-			delete EnemyItem::enemyitems()[i];
-			score = score + 1;
-			i--;
+			score = kill(EnemyItem::enemyitems()[i], score);
 		}
 	}
 	return score;
 }
+
+/** \brief The collision detection function for every ShellExplosion at once.
+ *
+ * This function does the same as calling collision_detect() on every live
+ * ShellExplosion, but each explosion is grown and its mark on the current
+ * world's KillMask brought up to date, dead ones being taken off, and then
+ * each EnemyItem is looked up on the mask once, so the cost depends on the
+ * number of enemies rather than on the number of enemies times the number
+ * of explosions. The same items are destroyed, although not in the same
+ * order.
+ * \param scr Optional: The current score of the game, defaults to zero if unspecified.
+ * \return Returns the new score.
+ */
+int ShellExplosion::collision_detect_all(int scr)
+{
+	int score = scr;
+	KillMask &mask = WorldState::current().kill_mask;
+	const vector<ShellExplosion*> &shellexplosions = ShellExplosion::shellexplosions();
+	if (shellexplosions.empty())
+	{
+		return score;
+	}
+	for (unsigned int i = 0; i < shellexplosions.size(); i++)
+	{
+		if (shellexplosions[i]->dead())
+		{
+			mask.remove(shellexplosions[i]);
+		}
+		else
+		{
+			shellexplosions[i]->grow();
+			mask.add(shellexplosions[i]);
+		}
+	}
+	for (unsigned int i = 0; i < EnemyItem::enemyitems().size(); i++)
+	{
+		EnemyItem *e = EnemyItem::enemyitems()[i];
+		if (!e->dead() && mask.hit(e))
+		{
+			score = kill(e, score);
+		}
+	}
+	return score;
+}
+
+/** \brief A function to save the ShellExplosion's state.
+ *
+ * \param r The record to save into.
+ */
+void ShellExplosion::save(ObjectRecord &r)
+{
+	Explosion::save(r);
+	r.type = OBJECT_SHELLEXPLOSION;
+	r.max_radius = max_radius_;
+}
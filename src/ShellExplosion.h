@@ -8,6 +8,9 @@
 #define SHELLEXPLOSION_H
 
 #include "Explosion.h"
+#include "Snapshot.h"
+
+class EnemyItem;
 
 /** \brief The Shell class.
  *
@@ -23,14 +26,22 @@ public:
 	ShellExplosion(double x, double y, double radius);
 	virtual ~ShellExplosion();
 
+	friend class World;
+	friend class KillMask;
+
 	static const vector<ShellExplosion*>& shellexplosions();
 	virtual int collision_detect(int scr = 0);
+	static int collision_detect_all(int scr = 0);
+	static void draw_shellexplosion(const ShellExplosionState &s, bool fill = true);
+	static void draw_merged(const vector<ShellExplosionState> &s);
+	virtual void save(ObjectRecord &r);
 protected:
-	void draw();
+	void capture(Snapshot &snap);
 private:
-	static vector<ShellExplosion*> shellexplosions_;
-	void draw_shellexplosion();
+	virtual void grow();
+	static int kill(EnemyItem *e, int score);
 	double max_radius_;
+	int mask_mark_; ///< index of its mark on the world's KillMask, -1 if not marked
 };
 
 #endif
@@ -0,0 +1,42 @@
+/** \file Snapshot.cpp
+ * \brief Code implementation for Snapshot class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "Snapshot.h"
+
+/** \brief Constructor for Snapshot.
+ *
+ * The constructor creates an empty snapshot of a game that has not started.
+ */
+Snapshot::Snapshot()
+{
+	gamestate = INITIALISE;
+	score = 0;
+	level = 1;
+	frame = 0;
+	animate_time = 0;
+}
+
+/** \brief Destructor for Snapshot.
+ *
+ * The destructor does nothing fancy.
+ */
+Snapshot::~Snapshot()
+{
+}
+
+/** \brief A function to empty the snapshot.
+ *
+ * All objects are removed but the storage is kept for the next frame.
+ */
+void Snapshot::clear()
+{
+	bases.clear();
+	guns.clear();
+	missiles.clear();
+	ufos.clear();
+	shells.clear();
+	shellexplosions.clear();
+}
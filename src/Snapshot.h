@@ -0,0 +1,123 @@
+/** \file Snapshot.h
+ * \brief Header file for Snapshot class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef SNAPSHOT_H
+#define SNAPSHOT_H
+
+#include "enum.h"
+#include "Handle.h"
+
+/** \brief Drawing state of a Base.
+ */
+struct BaseState
+{
+	Handle handle;
+	double x;
+	double y;
+	double radius;
+};
+
+/** \brief Drawing state of a Gun.
+ */
+struct GunState
+{
+	Handle handle;
+	double x;
+	double y;
+	double radius;
+	double theta;
+	double barrel_width;
+};
+
+/** \brief Drawing state of a Missile.
+ */
+struct MissileState
+{
+	Handle handle;
+	double x;
+	double y;
+	double radius;
+	double start_x;
+	double start_y;
+};
+
+/** \brief Drawing state of a UFO.
+ */
+struct UFOState
+{
+	Handle handle;
+	double x;
+	double y;
+	double radius;
+};
+
+/** \brief Drawing state of a Shell.
+ */
+struct ShellState
+{
+	Handle handle;
+	double x;
+	double y;
+	double radius;
+	double target_x;
+	double target_y;
+	double blast_radius;
+};
+
+/** \brief Drawing state of a ShellExplosion.
+ */
+struct ShellExplosionState
+{
+	Handle handle;
+	double x;
+	double y;
+	double radius;
+	double timealive;
+};
+
+/** \brief A visual effect the game reports, such as an explosion or impact.
+ *
+ * Effects change nothing in the game; they are passed to the Window to be
+ * drawn as particles.
+ */
+struct EffectState
+{
+	int kind;    ///< one of the EFFECT_ values
+	double x;
+	double y;
+	double size; ///< radius of what caused the effect
+};
+
+/** \brief The Snapshot class.
+ *
+ * A Snapshot is a copy of everything needed to draw one frame of the game.
+ * The simulation thread fills one in after every update and the Window draws
+ * from it, so drawing never touches the live game objects. Each record carries
+ * the Handle of its object so it can be matched up between frames. The vectors are
+ * cleared rather than freed between frames so their storage is reused.
+ */
+class Snapshot
+{
+public:
+	Snapshot();
+	virtual ~Snapshot();
+
+	virtual void clear();
+
+	vector<BaseState> bases;
+	vector<GunState> guns;
+	vector<MissileState> missiles;
+	vector<UFOState> ufos;
+	vector<ShellState> shells;
+	vector<ShellExplosionState> shellexplosions;
+	int gamestate;
+	int score;
+	int level;
+	unsigned long frame;
+	double animate_time;
+};
+
+#endif
@@ -0,0 +1,476 @@
+/** \file SoftCanvas.cpp
+ * \brief Code implementation for SoftCanvas class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "SoftCanvas.h"
+
+#include <math.h>
+#include <stdlib.h>
+#include <algorithm>
+
+/** \brief Constructor for SoftCanvas.
+ *
+ * The new SoftCanvas is empty until resize() is called.
+ */
+SoftCanvas::SoftCanvas()
+{
+	width_ = 0;
+	height_ = 0;
+	rgb_[0] = 0;
+	rgb_[1] = 0;
+	rgb_[2] = 0;
+	line_width_ = 0;
+	image_ = 0;
+	clip_left_ = 0;
+	clip_top_ = 0;
+	clip_right_ = 0;
+	clip_bottom_ = 0;
+}
+
+/** \brief Destructor for SoftCanvas.
+ */
+SoftCanvas::~SoftCanvas()
+{
+}
+
+/** \brief A function to change the size of the image.
+ *
+ * The contents are undefined until drawn over. The SoftCanvas draws onto
+ * its own image from then on, and clipping is turned off.
+ * \param width The width in pixels.
+ * \param height The height in pixels.
+ */
+void SoftCanvas::resize(int width, int height)
+{
+	width_ = (width > 0) ? width : 0;
+	height_ = (height > 0) ? height : 0;
+	pixels_.resize(width_*height_*3);
+	image_ = pixels_.empty() ? 0 : &pixels_[0];
+	clip(0, 0, width_, height_);
+}
+
+/** \brief A function to return the width of the image.
+ *
+ * \return Returns the width in pixels.
+ */
+int SoftCanvas::width() const
+{
+	return width_;
+}
+
+/** \brief A function to return the height of the image.
+ *
+ * \return Returns the height in pixels.
+ */
+int SoftCanvas::height() const
+{
+	return height_;
+}
+
+/** \brief A function to return the image.
+ *
+ * \return Returns the red, green and blue bytes of each pixel, top row first.
+ */
+const unsigned char* SoftCanvas::pixels() const
+{
+	return image_;
+}
+
+/** \brief A function to fill the whole image with one colour.
+ *
+ * The colour also becomes the current colour.
+ * \param c The colour.
+ */
+void SoftCanvas::clear(Fl_Color c)
+{
+	color(c);
+	rectf(0, 0, width_, height_);
+}
+
+/** \brief A function to only draw inside a rectangle.
+ *
+ * \param x The left of the rectangle.
+ * \param y The top of the rectangle.
+ * \param w The width of the rectangle, which is clipped to the image.
+ * \param h The height of the rectangle.
+ */
+void SoftCanvas::clip(int x, int y, int w, int h)
+{
+	clip_left_ = (x > 0) ? x : 0;
+	clip_top_ = (y > 0) ? y : 0;
+	clip_right_ = (x + w < width_) ? x + w : width_;
+	clip_bottom_ = (y + h < height_) ? y + h : height_;
+}
+
+/** \brief A function to draw onto another SoftCanvas's image.
+ *
+ * Clipping is turned off. The other SoftCanvas must not be resized while
+ * this one draws onto its image.
+ * \param other The SoftCanvas whose image to draw onto.
+ */
+void SoftCanvas::share(SoftCanvas &other)
+{
+	width_ = other.width_;
+	height_ = other.height_;
+	image_ = other.image_;
+	clip(0, 0, width_, height_);
+}
+
+/** \brief A function to finish drawing the image.
+ *
+ * A SoftCanvas draws straight away, so there is nothing to do, but
+ * subclasses may draw later and must be finished before pixels() is used.
+ */
+void SoftCanvas::finish()
+{
+}
+
+/** \brief A function to set the colour of everything drawn after it.
+ *
+ * \param c The colour, looked up in the FLTK colour map.
+ */
+void SoftCanvas::color(Fl_Color c)
+{
+	Fl::get_color(c, rgb_[0], rgb_[1], rgb_[2]);
+}
+
+/** \brief A function to set the width of lines drawn after it.
+ *
+ * \param width The width in pixels, 0 for one pixel.
+ */
+void SoftCanvas::line_style(int width)
+{
+	line_width_ = width;
+}
+
+/** \brief A function to fill a rectangle.
+ */
+void SoftCanvas::rectf(int x, int y, int w, int h)
+{
+	int top = (y > clip_top_) ? y : clip_top_;
+	int bottom = (y + h < clip_bottom_) ? y + h : clip_bottom_;
+	for (int row = top; row < bottom; row++)
+	{
+		span(row, x, x + w);
+	}
+}
+
+/** \brief A function to draw the outline of a rectangle.
+ *
+ * As with FLTK, the outline is drawn just inside the rectangle.
+ */
+void SoftCanvas::rect(int x, int y, int w, int h)
+{
+	if ((w <= 0) || (h <= 0))
+	{
+		return;
+	}
+	line(x, y, x + w - 1, y);
+	line(x + w - 1, y, x + w - 1, y + h - 1);
+	line(x + w - 1, y + h - 1, x, y + h - 1);
+	line(x, y + h - 1, x, y);
+}
+
+/** \brief A function to draw a line.
+ *
+ * The line is stepped one pixel at a time along its longer axis, and each
+ * step is drawn as a square as wide as the line.
+ */
+void SoftCanvas::line(int x, int y, int x1, int y1)
+{
+	int dx = abs(x1 - x);
+	int dy = -abs(y1 - y);
+	int sx = (x < x1) ? 1 : -1;
+	int sy = (y < y1) ? 1 : -1;
+	int error = dx + dy;
+	int size = (line_width_ > 1) ? line_width_ : 1;
+	for (;;)
+	{
+		rectf(x - size/2, y - size/2, size, size);
+		if ((x == x1) && (y == y1))
+		{
+			break;
+		}
+		int e2 = 2*error;
+		if (e2 >= dy)
+		{
+			error = error + dy;
+			x = x + sx;
+		}
+		if (e2 <= dx)
+		{
+			error = error + dx;
+			y = y + sy;
+		}
+	}
+}
+
+/** \brief A function to draw a single pixel.
+ */
+void SoftCanvas::point(int x, int y)
+{
+	span(y, x, x + 1);
+}
+
+/** \brief A function to draw the outline of a circle.
+ */
+void SoftCanvas::circle(double x, double y, double r)
+{
+	outline(x, y, r, r, 0, 360);
+}
+
+/** \brief A function to fill part of an ellipse.
+ *
+ * Each row is filled between the edges of the ellipse, which only depend on
+ * its size and are cached. Unless the whole ellipse is filled, each pixel's
+ * angle is also checked.
+ */
+void SoftCanvas::pie(int x, int y, int w, int h, double a1, double a2)
+{
+	if ((w <= 0) || (h <= 0))
+	{
+		return;
+	}
+	const vector<int> &spans = pie_spans(w, h);
+	double rx = w/2.0;
+	double ry = h/2.0;
+	bool whole = (a2 - a1 >= 360);
+	int top = (y > clip_top_) ? y : clip_top_;
+	int bottom = (y + h < clip_bottom_) ? y + h : clip_bottom_;
+	for (int row = top; row < bottom; row++)
+	{
+		int left = spans[2*(row - y)];
+		int right = spans[2*(row - y) + 1];
+		if (whole)
+		{
+			span(row, x + left, x + right);
+			continue;
+		}
+		double dy = (row - y + 0.5 - ry)/ry;
+		for (int col = left; col < right; col++)
+		{
+			double angle = atan2(-dy, (col + 0.5 - rx)/rx)*180/M_PI;
+			while (angle < a1)
+			{
+				angle = angle + 360;
+			}
+			while (angle >= a1 + 360)
+			{
+				angle = angle - 360;
+			}
+			if (angle <= a2)
+			{
+				span(row, x + col, x + col + 1);
+			}
+		}
+	}
+}
+
+/** \brief A function to draw part of the outline of an ellipse.
+ *
+ * The arguments are the same as for pie().
+ */
+void SoftCanvas::arc(int x, int y, int w, int h, double a1, double a2)
+{
+	outline(x + w/2.0, y + h/2.0, w/2.0, h/2.0, a1, a2);
+}
+
+/** \brief A function to start a filled polygon.
+ */
+void SoftCanvas::begin_polygon()
+{
+	vertices_.clear();
+}
+
+/** \brief A function to start a closed outline.
+ */
+void SoftCanvas::begin_loop()
+{
+	vertices_.clear();
+}
+
+/** \brief A function to start a batch of single pixels.
+ */
+void SoftCanvas::begin_points()
+{
+	vertices_.clear();
+}
+
+/** \brief A function to add a vertex to the current shape.
+ */
+void SoftCanvas::vertex(double x, double y)
+{
+	vertices_.push_back(x);
+	vertices_.push_back(y);
+}
+
+/** \brief A function to draw the closed outline of the vertices given.
+ *
+ * The vertices are kept, so as with FLTK an end_polygon() straight after
+ * fills the same shape.
+ */
+void SoftCanvas::end_loop()
+{
+	int n = vertices_.size()/2;
+	for (int i = 0; i < n; i++)
+	{
+		int j = (i + 1) % n;
+		line((int)floor(vertices_[2*i] + 0.5), (int)floor(vertices_[2*i + 1] + 0.5),
+			(int)floor(vertices_[2*j] + 0.5), (int)floor(vertices_[2*j + 1] + 0.5));
+	}
+}
+
+/** \brief A function to draw a pixel at each of the vertices given.
+ */
+void SoftCanvas::end_points()
+{
+	for (unsigned int i = 0; i + 1 < vertices_.size(); i = i + 2)
+	{
+		point((int)floor(vertices_[i] + 0.5), (int)floor(vertices_[i + 1] + 0.5));
+	}
+}
+
+/** \brief A function to fill the polygon of the vertices given.
+ *
+ * Each row is filled between pairs of the points where it crosses the
+ * edges of the polygon, so shapes that cross themselves are filled by the
+ * even-odd rule.
+ */
+void SoftCanvas::end_polygon()
+{
+	int n = vertices_.size()/2;
+	if (n < 3)
+	{
+		return;
+	}
+	double top = vertices_[1];
+	double bottom = vertices_[1];
+	for (int i = 1; i < n; i++)
+	{
+		top = (vertices_[2*i + 1] < top) ? vertices_[2*i + 1] : top;
+		bottom = (vertices_[2*i + 1] > bottom) ? vertices_[2*i + 1] : bottom;
+	}
+	int first = (int)floor(top);
+	int last = (int)ceil(bottom);
+	first = (first > clip_top_) ? first : clip_top_;
+	last = (last < clip_bottom_) ? last : clip_bottom_;
+	for (int row = first; row < last; row++)
+	{
+		double y = row + 0.5;
+		crossings_.clear();
+		for (int i = 0; i < n; i++)
+		{
+			int j = (i + 1) % n;
+			double y0 = vertices_[2*i + 1];
+			double y1 = vertices_[2*j + 1];
+			if (((y0 <= y) && (y < y1)) || ((y1 <= y) && (y < y0)))
+			{
+				double x0 = vertices_[2*i];
+				double x1 = vertices_[2*j];
+				crossings_.push_back(x0 + (y - y0)*(x1 - x0)/(y1 - y0));
+			}
+		}
+		std::sort(crossings_.begin(), crossings_.end());
+		for (unsigned int i = 0; i + 1 < crossings_.size(); i = i + 2)
+		{
+			span(row, (int)ceil(crossings_[i] - 0.5), (int)floor(crossings_[i + 1] - 0.5) + 1);
+		}
+	}
+}
+
+/** \brief A function to fill part of a row with the current colour.
+ *
+ * \param y The row.
+ * \param x0 The first pixel to fill.
+ * \param x1 One past the last pixel to fill.
+ */
+void SoftCanvas::span(int y, int x0, int x1)
+{
+	if ((y < clip_top_) || (y >= clip_bottom_))
+	{
+		return;
+	}
+	x0 = (x0 > clip_left_) ? x0 : clip_left_;
+	x1 = (x1 < clip_right_) ? x1 : clip_right_;
+	if (x0 >= x1)
+	{
+		return;
+	}
+	unsigned char *p = image_ + (y*width_ + x0)*3;
+	for (int x = x0; x < x1; x++)
+	{
+		p[0] = rgb_[0];
+		p[1] = rgb_[1];
+		p[2] = rgb_[2];
+		p = p + 3;
+	}
+}
+
+/** \brief A function to draw part of the outline of an ellipse.
+ *
+ * The outline is drawn as straight lines about two pixels long.
+ * \param cx The x co-ordinate of the centre.
+ * \param cy The y co-ordinate of the centre.
+ * \param rx The radius across.
+ * \param ry The radius down.
+ * \param a1 The angle to start at, in degrees anticlockwise from 3 o'clock.
+ * \param a2 The angle to end at.
+ */
+void SoftCanvas::outline(double cx, double cy, double rx, double ry, double a1, double a2)
+{
+	double r = (rx > ry) ? rx : ry;
+	int steps = (int)(r*(a2 - a1)*M_PI/360) + 4;
+	int px = (int)floor(cx + rx*cos(a1*M_PI/180) + 0.5);
+	int py = (int)floor(cy - ry*sin(a1*M_PI/180) + 0.5);
+	for (int i = 1; i <= steps; i++)
+	{
+		double a = (a1 + (a2 - a1)*i/steps)*M_PI/180;
+		int x = (int)floor(cx + rx*cos(a) + 0.5);
+		int y = (int)floor(cy - ry*sin(a) + 0.5);
+		line(px, py, x, y);
+		px = x;
+		py = y;
+	}
+}
+
+/** \brief A function to return the row spans of a pie.
+ *
+ * \param w The width of the pie.
+ * \param h The height of the pie.
+ * \return Returns the first pixel and one past the last pixel filled on each
+ *	row, relative to the pie's top left corner. Rows the pie does not reach
+ *	are empty.
+ */
+const vector<int>& SoftCanvas::pie_spans(int w, int h)
+{
+	std::pair<int, int> size(w, h);
+	std::map<std::pair<int, int>, vector<int> >::iterator found = spans_.find(size);
+	if (found != spans_.end())
+	{
+		return found->second;
+	}
+	if (spans_.size() >= SPAN_CACHE_SIZE)
+	{
+		spans_.clear();
+	}
+	vector<int> &spans = spans_[size];
+	spans.resize(2*h);
+	double rx = w/2.0;
+	double ry = h/2.0;
+	for (int row = 0; row < h; row++)
+	{
+		double dy = (row + 0.5 - ry)/ry;
+		if (dy*dy > 1)
+		{
+			spans[2*row] = 0;
+			spans[2*row + 1] = 0;
+			continue;
+		}
+		double half = rx*sqrt(1 - dy*dy);
+		spans[2*row] = (int)ceil(rx - half - 0.5);
+		spans[2*row + 1] = (int)floor(rx + half - 0.5) + 1;
+	}
+	return spans;
+}
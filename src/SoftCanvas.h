@@ -0,0 +1,77 @@
+/** \file SoftCanvas.h
+ * \brief Header file for SoftCanvas class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef SOFTCANVAS_H
+#define SOFTCANVAS_H
+
+#include <map>
+
+#include "Canvas.h"
+
+/** \brief The SoftCanvas class, inherits from Canvas
+ *
+ * The SoftCanvas class draws into an image in memory without FLTK, so it
+ * works without a display and on any thread. The image is width() by
+ * height() pixels of 8 bit red, green and blue, top row first. Shapes are
+ * filled where they cover the centre of a pixel and are not antialiased.
+ *
+ * Drawing can be clipped to a rectangle, and a SoftCanvas can draw onto
+ * another's image instead of its own, so several can draw different parts
+ * of one image at once. Clipping never changes which pixels a shape covers,
+ * only which of them are drawn. The row spans of each size of pie are
+ * cached, since explosions are drawn at the same few sizes over and over.
+ */
+class SoftCanvas : public Canvas
+{
+public:
+	SoftCanvas();
+	virtual ~SoftCanvas();
+
+	virtual void resize(int width, int height);
+	virtual int width() const;
+	virtual int height() const;
+	virtual const unsigned char* pixels() const;
+	virtual void clear(Fl_Color c);
+	virtual void clip(int x, int y, int w, int h);
+	virtual void share(SoftCanvas &other);
+	virtual void finish();
+
+	virtual void color(Fl_Color c);
+	virtual void line_style(int width);
+	virtual void rectf(int x, int y, int w, int h);
+	virtual void rect(int x, int y, int w, int h);
+	virtual void line(int x, int y, int x1, int y1);
+	virtual void point(int x, int y);
+	virtual void circle(double x, double y, double r);
+	virtual void pie(int x, int y, int w, int h, double a1, double a2);
+	virtual void arc(int x, int y, int w, int h, double a1, double a2);
+	virtual void begin_polygon();
+	virtual void begin_loop();
+	virtual void begin_points();
+	virtual void vertex(double x, double y);
+	virtual void end_loop();
+	virtual void end_points();
+	virtual void end_polygon();
+private:
+	void span(int y, int x0, int x1);
+	void outline(double cx, double cy, double rx, double ry, double a1, double a2);
+	const vector<int>& pie_spans(int w, int h);
+	int width_;
+	int height_;
+	vector<unsigned char> pixels_;
+	unsigned char *image_; ///< pixels_, or another SoftCanvas's image
+	int clip_left_;
+	int clip_top_;
+	int clip_right_;       ///< one past the last column drawn
+	int clip_bottom_;      ///< one past the last row drawn
+	unsigned char rgb_[3];
+	int line_width_;
+	vector<double> vertices_; ///< x and y of each vertex given since the last begin_ function
+	vector<double> crossings_;
+	std::map<std::pair<int, int>, vector<int> > spans_; ///< left and right of each row of a pie, by size
+};
+
+#endif
@@ -0,0 +1,263 @@
+/** \file SpatialSort.cpp
+ * \brief Code implementation for SpatialSort class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "SpatialSort.h"
+
+#include <math.h>
+#include <string.h>
+#include <algorithm>
+#include <new>
+
+#include "WorldState.h"
+#include "Missile.h"
+#include "UFO.h"
+
+#define MORTON_BITS 10 // bits of each co-ordinate in a code
+#define MORTON_MAX ((1 << MORTON_BITS) - 1)
+
+/** \brief A function to spread the bits of a number out to every other bit.
+ *
+ * \param v The number, of at most MORTON_BITS bits.
+ * \return Returns v with a zero bit inserted above each of its bits.
+ */
+static unsigned int spread(unsigned int v)
+{
+	v = (v | (v << 8)) & 0x00ff00ffu;
+	v = (v | (v << 4)) & 0x0f0f0f0fu;
+	v = (v | (v << 2)) & 0x33333333u;
+	v = (v | (v << 1)) & 0x55555555u;
+	return v;
+}
+
+/** \brief Constructor for SpatialSort.
+ *
+ * Room is reserved for WORLD_RESERVE enemies, so sorting does not allocate
+ * during play.
+ */
+SpatialSort::SpatialSort()
+{
+	keys_.reserve(WORLD_RESERVE);
+	order_.reserve(WORLD_RESERVE);
+	scratch_.reserve(WORLD_RESERVE);
+	sorted_.reserve(WORLD_RESERVE);
+	blocks_.reserve(WORLD_RESERVE);
+	bytes_.reserve(WORLD_RESERVE*((sizeof(Missile) > sizeof(UFO)) ? sizeof(Missile) : sizeof(UFO)));
+	targets_.reserve(WORLD_RESERVE);
+	next_ = 0;
+	slice_ = 0;
+	odd_ = false;
+}
+
+/** \brief Destructor for SpatialSort.
+ */
+SpatialSort::~SpatialSort()
+{
+}
+
+/** \brief A function to return the Morton code of a position.
+ *
+ * The bits of the position's column and row on the grid are interleaved,
+ * so positions in the same square of the grid at any scale have codes in
+ * one unbroken range. Positions off the grid are moved to its edge.
+ * \param x The x co-ordinate, in world units.
+ * \param y The y co-ordinate, in world units.
+ * \return Returns the code, of 2*MORTON_BITS bits.
+ */
+unsigned int SpatialSort::code(double x, double y)
+{
+	double col = floor(x/SPATIAL_SORT_CELL);
+	double row = floor(y/SPATIAL_SORT_CELL);
+	col = (col < 0) ? 0 : ((col > MORTON_MAX) ? MORTON_MAX : col);
+	row = (row < 0) ? 0 : ((row > MORTON_MAX) ? MORTON_MAX : row);
+	return spread((unsigned int)col) | (spread((unsigned int)row) << 1);
+}
+
+/** \brief A function to sort the enemies of the current WorldState by position.
+ *
+ * The registry is radix sorted by code, one pass per MORTON_BITS bits, and
+ * each pass keeps the order of equal keys, so enemies in the same cell stay
+ * in the order they were in. Nothing may be looping over the registries or
+ * holding pointers to enemies.
+ *
+ * The objects themselves are not moved here but by step() over the
+ * SPATIAL_SORT_STEPS updates that follow, as moving them all at once would
+ * make this one update far slower than the rest. Each round of moves
+ * starts half a slice along from the last, so objects are exchanged
+ * between neighbouring slices. Enemies move little between sorts and new
+ * ones are added at the end, so while fewer than one in
+ * SPATIAL_SORT_DISORDER neighbouring pairs of enemies is out of order the
+ * registry is left as it is and only the objects are moved.
+ */
+void SpatialSort::sort()
+{
+	WorldState &w = WorldState::current();
+	vector<EnemyItem*> &enemies = w.enemyitems;
+	unsigned int n = enemies.size();
+	if (n < 2)
+	{
+		return;
+	}
+	slice_ = (n + SPATIAL_SORT_STEPS - 1)/SPATIAL_SORT_STEPS;
+	next_ = odd_ ? -(slice_/2) : 0;
+	odd_ = !odd_;
+	keys_.resize(n);
+	order_.resize(n);
+	scratch_.resize(n);
+	unsigned int disordered = 0;
+	for (unsigned int i = 0; i < n; i++)
+	{
+		keys_[i] = code(enemies[i]->x(), enemies[i]->y());
+		order_[i] = i;
+		if ((i > 0) && (keys_[i] < keys_[i - 1]))
+		{
+			disordered++;
+		}
+	}
+	if (disordered*SPATIAL_SORT_DISORDER < n - 1)
+	{
+		return; // near enough in order, so only the objects are moved
+	}
+	for (int shift = 0; shift < 2*MORTON_BITS; shift += MORTON_BITS)
+	{
+		unsigned int start[MORTON_MAX + 2];
+		memset(start, 0, sizeof(start));
+		for (unsigned int i = 0; i < n; i++)
+		{
+			start[((keys_[order_[i]] >> shift) & MORTON_MAX) + 1]++;
+		}
+		for (int b = 0; b <= MORTON_MAX; b++)
+		{
+			start[b + 1] += start[b];
+		}
+		for (unsigned int i = 0; i < n; i++)
+		{
+			scratch_[start[(keys_[order_[i]] >> shift) & MORTON_MAX]++] = order_[i];
+		}
+		order_.swap(scratch_);
+	}
+	sorted_.resize(n);
+	for (unsigned int i = 0; i < n; i++)
+	{
+		sorted_[i] = enemies[order_[i]];
+	}
+	enemies.swap(sorted_);
+}
+
+/** \brief A function to move the objects of the next slice of the enemies into order.
+ *
+ * Called on the updates after a sort(), this moves the Missile and UFO
+ * objects of the next slice of the EnemyItem registry, until the whole
+ * registry has been covered. Like sort(), nothing may be looping over the
+ * registries or holding pointers to enemies.
+ */
+void SpatialSort::step()
+{
+	int n = WorldState::current().enemyitems.size();
+	if ((slice_ == 0) || (next_ >= n))
+	{
+		return;
+	}
+	int first = (next_ < 0) ? 0 : next_;
+	int last = (next_ + slice_ > n) ? n : next_ + slice_;
+	relocate(WorldState::current().missiles, first, last);
+	relocate(WorldState::current().ufos, first, last);
+	next_ += slice_;
+}
+
+/** \brief A function to move objects of one class in a slice of the enemies into order.
+ *
+ * The objects in the slice keep the blocks of memory they have between them,
+ * but the lowest address goes to whichever of them comes first in the
+ * EnemyItem registry, and so on. Each is copied aside and then assigned to
+ * its new block, which holds an object of the same class. The copies are
+ * made and dropped without running the constructor or destructor, which
+ * would issue or free a Handle. The new addresses are looked up by Handle
+ * index, so the registries are pointed at them while every object is still
+ * in place, and then the HandleTable is.
+ * \param objects The registry of every object of the class, which must all
+ *	be in the EnemyItem registry too.
+ * \param first The index in the EnemyItem registry of the start of the slice.
+ * \param last The index in the EnemyItem registry just past the slice.
+ */
+template <class T> void SpatialSort::relocate(vector<T*> &objects, int first, int last)
+{
+	WorldState &w = WorldState::current();
+	const vector<EnemyItem*> &enemies = w.enemyitems;
+	if (objects.size() < 2)
+	{
+		return;
+	}
+	for (unsigned int i = 0; i < objects.size(); i++)
+	{
+		if (objects[i]->handle() == NULL_HANDLE)
+		{
+			return; // the HandleTable was full, so it cannot be looked up
+		}
+	}
+	if (targets_.size() < w.handle_slots.size())
+	{
+		targets_.resize(w.handle_slots.size(), (GameObject*)0);
+	}
+	for (unsigned int i = 0; i < objects.size(); i++)
+	{
+		targets_[HandleTable::index(objects[i]->handle())] = objects[i]; // marks it as one of the class
+	}
+	blocks_.clear();
+	for (int i = first; i < last; i++)
+	{
+		if (targets_[HandleTable::index(enemies[i]->handle())] == enemies[i])
+		{
+			blocks_.push_back(enemies[i]);
+		}
+	}
+	unsigned int n = blocks_.size();
+	if (n >= 2)
+	{
+		std::sort(blocks_.begin(), blocks_.end());
+		bytes_.resize(n*sizeof(T));
+		unsigned int moved = 0;
+		for (int i = first; (i < last) && (moved < n); i++)
+		{
+			GameObject *&target = targets_[HandleTable::index(enemies[i]->handle())];
+			if (target == enemies[i])
+			{
+				::new (&bytes_[moved*sizeof(T)]) T(*static_cast<T*>(enemies[i]));
+				target = blocks_[moved];
+				moved++;
+			}
+		}
+		remap(objects, 0, objects.size());
+		remap(w.enemyitems, first, last);
+		remap(w.projectiles, 0, w.projectiles.size());
+		for (unsigned int i = 0; i < n; i++)
+		{
+			*static_cast<T*>(blocks_[i]) = *(T*)&bytes_[i*sizeof(T)];
+			HandleTable::move(blocks_[i]->handle(), blocks_[i]);
+		}
+	}
+	for (unsigned int i = 0; i < objects.size(); i++)
+	{
+		targets_[HandleTable::index(objects[i]->handle())] = 0;
+	}
+}
+
+/** \brief A function to point part of a registry at the new addresses of the objects being moved.
+ *
+ * \param registry The registry, whose other objects are left alone.
+ * \param first The index of the first entry to look at.
+ * \param last The index just past the last entry to look at.
+ */
+template <class T> void SpatialSort::remap(vector<T*> &registry, int first, int last)
+{
+	for (int i = first; i < last; i++)
+	{
+		GameObject *target = targets_[HandleTable::index(registry[i]->handle())];
+		if (target)
+		{
+			registry[i] = static_cast<T*>(target);
+		}
+	}
+}
@@ -0,0 +1,57 @@
+/** \file SpatialSort.h
+ * \brief Header file for SpatialSort class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef SPATIALSORT_H
+#define SPATIALSORT_H
+
+#include "enum.h"
+
+class GameObject;
+class EnemyItem;
+
+/** \brief The SpatialSort class.
+ *
+ * The SpatialSort class keeps enemies that are close in the world close in
+ * memory. sort() orders the EnemyItem registry by the Morton (Z-order) code
+ * of each enemy's position on a grid of SPATIAL_SORT_CELL unit cells, and
+ * then step() moves the Missile and UFO objects themselves a slice at a
+ * time over the following updates so they lie in memory in that order.
+ * The registry is left as it is while it is still nearly in order. The
+ * collision queries walk the EnemyItem registry, so afterwards they visit
+ * neighbouring enemies one after another and read the objects and the
+ * KillMask in order, however much the objects have been created and
+ * destroyed since the game started.
+ *
+ * Only the order of the EnemyItem registry changes, which only the
+ * collision queries use and which does not change what they find. Every
+ * other registry keeps its order and every Handle still refers to the same
+ * object, so the game is exactly the same.
+ */
+class SpatialSort
+{
+public:
+	SpatialSort();
+	virtual ~SpatialSort();
+
+	virtual void sort();
+	virtual void step();
+	static unsigned int code(double x, double y);
+private:
+	template <class T> void relocate(vector<T*> &objects, int first, int last);
+	template <class T> void remap(vector<T*> &registry, int first, int last);
+	vector<unsigned int> keys_;    ///< Morton code of each enemy, by registry index
+	vector<unsigned int> order_;   ///< registry indices in order of key
+	vector<unsigned int> scratch_;
+	vector<EnemyItem*> sorted_;
+	vector<GameObject*> blocks_;   ///< the objects being moved, in order of address
+	vector<char> bytes_;           ///< copies of the objects being moved, in their new order
+	vector<GameObject*> targets_;  ///< new address of each object being moved, by Handle index
+	int next_;                     ///< registry index of the next slice step() moves, negative if it starts short
+	int slice_;                    ///< enemies in each slice, 0 before the first sort()
+	bool odd_;                     ///< the next round of moves starts half a slice along
+};
+
+#endif
@@ -0,0 +1,79 @@
+/** \file SpscQueue.h
+ * \brief Header file for SpscQueue class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef SPSCQUEUE_H
+#define SPSCQUEUE_H
+
+#include "thread.h"
+
+/** \brief The SpscQueue class.
+ *
+ * The SpscQueue class is a fixed size ring buffer that passes items from one
+ * producer thread to one consumer thread without locking. N is the capacity
+ * and must be a power of two.
+ */
+template <class T, int N>
+class SpscQueue
+{
+public:
+	SpscQueue();
+
+	bool push(const T &item);
+	bool pop(T &item);
+private:
+	T items_[N];
+	volatile long head_; // next item to pop, only written by the consumer
+	volatile long tail_; // next free slot, only written by the producer
+};
+
+/** \brief Constructor for SpscQueue.
+ */
+template <class T, int N>
+SpscQueue<T, N>::SpscQueue()
+{
+	head_ = 0;
+	tail_ = 0;
+}
+
+/** \brief A function to add an item to the queue.
+ *
+ * Only the producer thread may call this function.
+ * \param item The item to add.
+ * \return Returns false if the queue was full and the item was dropped.
+ */
+template <class T, int N>
+bool SpscQueue<T, N>::push(const T &item)
+{
+	unsigned long tail = (unsigned long)atomic_load(&tail_);
+	if (tail - (unsigned long)atomic_load(&head_) >= (unsigned long)N)
+	{
+		return false;
+	}
+	items_[tail & (N-1)] = item;
+	atomic_store(&tail_, (long)(tail + 1));
+	return true;
+}
+
+/** \brief A function to remove the oldest item from the queue.
+ *
+ * Only the consumer thread may call this function.
+ * \param item The item to copy the oldest item into.
+ * \return Returns false if the queue was empty.
+ */
+template <class T, int N>
+bool SpscQueue<T, N>::pop(T &item)
+{
+	unsigned long head = (unsigned long)atomic_load(&head_);
+	if (head == (unsigned long)atomic_load(&tail_))
+	{
+		return false;
+	}
+	item = items_[head & (N-1)];
+	atomic_store(&head_, (long)(head + 1));
+	return true;
+}
+
+#endif
@@ -0,0 +1,547 @@
+/** \file TileCanvas.cpp
+ * \brief Code implementation for TileCanvas class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "TileCanvas.h"
+
+#include <math.h>
+
+/** \brief A function to round a vertex co-ordinate to a pixel as the shapes do.
+ *
+ * Co-ordinates far outside any image are clamped so they fit in an int.
+ */
+static int pixel(double v)
+{
+	v = (v > 1e8) ? 1e8 : v;
+	v = (v < -1e8) ? -1e8 : v;
+	return (int)floor(v + 0.5);
+}
+
+/** \brief Constructor for TileCanvas.
+ *
+ * The new TileCanvas draws on one thread, like a SoftCanvas.
+ */
+TileCanvas::TileCanvas()
+{
+	threads_ = 1;
+	pen_color_ = FL_BLACK;
+	pen_width_ = 0;
+	shape_start_ = 0;
+	tiles_across_ = 0;
+	next_tile_ = 0;
+	stopping_ = false;
+}
+
+/** \brief Destructor for TileCanvas.
+ */
+TileCanvas::~TileCanvas()
+{
+	stop_workers();
+}
+
+/** \brief A function to set the number of threads to draw with.
+ *
+ * Anything already recorded is drawn first.
+ * \param n The number of threads, including the caller of finish(). With 1
+ *	shapes are drawn straight away as by a SoftCanvas.
+ */
+void TileCanvas::threads(int n)
+{
+	finish();
+	n = (n > 1) ? n : 1;
+	if (n != threads_)
+	{
+		stop_workers();
+		threads_ = n;
+	}
+}
+
+/** \brief A function to return the number of threads drawn with.
+ *
+ * \return Returns the number of threads.
+ */
+int TileCanvas::threads()
+{
+	return threads_;
+}
+
+/** \brief A function to draw everything recorded since the last finish().
+ *
+ * This returns once the image is complete.
+ */
+void TileCanvas::finish()
+{
+	if (shapes_.empty())
+	{
+		return;
+	}
+	tiles_across_ = (width() + TILE_SIZE - 1)/TILE_SIZE;
+	int down = (height() + TILE_SIZE - 1)/TILE_SIZE;
+	tiles_.resize(tiles_across_*down);
+	for (unsigned int i = 0; i < tiles_.size(); i++)
+	{
+		tiles_[i].clear();
+	}
+	for (unsigned int i = 0; i < shapes_.size(); i++)
+	{
+		const Shape &s = shapes_[i];
+		for (int ty = s.top/TILE_SIZE; ty <= (s.bottom - 1)/TILE_SIZE; ty++)
+		{
+			for (int tx = s.left/TILE_SIZE; tx <= (s.right - 1)/TILE_SIZE; tx++)
+			{
+				tiles_[ty*tiles_across_ + tx].push_back(i);
+			}
+		}
+	}
+
+	while ((int)workers_.size() < threads_)
+	{
+		Worker *w = new Worker;
+		w->owner = this;
+		workers_.push_back(w);
+		if (workers_.size() > 1)
+		{
+			w->thread.start(worker_main, w);
+		}
+	}
+	atomic_store(&next_tile_, 0);
+	for (int i = 0; i < threads_; i++)
+	{
+		workers_[i]->canvas.share(*this);
+	}
+	// the posts order the writes above before the threads read them
+	for (int i = 1; i < threads_; i++)
+	{
+		if (workers_[i]->thread.running())
+		{
+			workers_[i]->wake.post();
+		}
+	}
+	// tiles are taken as they are reached, so this is right even if a thread did not start
+	draw_tiles(workers_[0]->canvas);
+	for (int i = 1; i < threads_; i++)
+	{
+		if (workers_[i]->thread.running())
+		{
+			done_.wait();
+		}
+	}
+	shapes_.clear();
+	shape_vertices_.clear();
+	shape_start_ = 0;
+}
+
+/** \brief A function to stop and join the threads started by finish().
+ */
+void TileCanvas::stop_workers()
+{
+	stopping_ = true;
+	for (unsigned int i = 1; i < workers_.size(); i++)
+	{
+		if (workers_[i]->thread.running())
+		{
+			workers_[i]->wake.post();
+			workers_[i]->thread.join();
+		}
+	}
+	for (unsigned int i = 0; i < workers_.size(); i++)
+	{
+		delete workers_[i];
+	}
+	workers_.clear();
+	stopping_ = false;
+}
+
+/** \brief Entry point for the threads started by finish().
+ *
+ * The thread draws tiles each time it is woken, until it is told to stop.
+ * \param worker Pointer to the thread's Worker.
+ */
+void TileCanvas::worker_main(void *worker)
+{
+	Worker *w = (Worker*)worker;
+	TileCanvas *owner = w->owner;
+	while (true)
+	{
+		w->wake.wait();
+		if (owner->stopping_)
+		{
+			return;
+		}
+		owner->draw_tiles(w->canvas);
+		owner->done_.post();
+	}
+}
+
+/** \brief A function to draw tiles until there are none left.
+ *
+ * \param canvas The SoftCanvas to draw with, sharing this one's image.
+ */
+void TileCanvas::draw_tiles(SoftCanvas &canvas)
+{
+	long count = (long)tiles_.size();
+	long tile;
+	while ((tile = atomic_increment(&next_tile_) - 1) < count)
+	{
+		int tx = (int)(tile % tiles_across_);
+		int ty = (int)(tile / tiles_across_);
+		canvas.clip(tx*TILE_SIZE, ty*TILE_SIZE, TILE_SIZE, TILE_SIZE);
+		const vector<unsigned int> &list = tiles_[tile];
+		for (unsigned int i = 0; i < list.size(); i++)
+		{
+			draw_shape(canvas, shapes_[list[i]]);
+		}
+	}
+	canvas.clip(0, 0, canvas.width(), canvas.height());
+}
+
+/** \brief A function to draw a recorded shape.
+ *
+ * \param canvas The SoftCanvas to draw with.
+ * \param s The shape.
+ */
+void TileCanvas::draw_shape(SoftCanvas &canvas, const Shape &s)
+{
+	canvas.color(s.color);
+	canvas.line_style(s.line_width);
+	switch (s.kind)
+	{
+	case SHAPE_RECTF:
+		canvas.rectf(s.i[0], s.i[1], s.i[2], s.i[3]);
+		break;
+	case SHAPE_RECT:
+		canvas.rect(s.i[0], s.i[1], s.i[2], s.i[3]);
+		break;
+	case SHAPE_LINE:
+		canvas.line(s.i[0], s.i[1], s.i[2], s.i[3]);
+		break;
+	case SHAPE_POINT:
+		canvas.point(s.i[0], s.i[1]);
+		break;
+	case SHAPE_CIRCLE:
+		canvas.circle(s.d[0], s.d[1], s.d[2]);
+		break;
+	case SHAPE_PIE:
+		canvas.pie(s.i[0], s.i[1], s.i[2], s.i[3], s.d[0], s.d[1]);
+		break;
+	case SHAPE_ARC:
+		canvas.arc(s.i[0], s.i[1], s.i[2], s.i[3], s.d[0], s.d[1]);
+		break;
+	case SHAPE_LOOP:
+		canvas.begin_loop();
+		break;
+	case SHAPE_POINTS:
+		canvas.begin_points();
+		break;
+	case SHAPE_POLYGON:
+		canvas.begin_polygon();
+		break;
+	}
+	if ((s.kind == SHAPE_LOOP) || (s.kind == SHAPE_POINTS) || (s.kind == SHAPE_POLYGON))
+	{
+		for (unsigned int i = s.first; i < s.first + s.count; i++)
+		{
+			canvas.vertex(shape_vertices_[2*i], shape_vertices_[2*i + 1]);
+		}
+		if (s.kind == SHAPE_LOOP)
+		{
+			canvas.end_loop();
+		}
+		else if (s.kind == SHAPE_POINTS)
+		{
+			canvas.end_points();
+		}
+		else
+		{
+			canvas.end_polygon();
+		}
+	}
+}
+
+/** \brief A function to return whether shapes are being recorded.
+ *
+ * \return Returns true if more than one thread draws.
+ */
+bool TileCanvas::recording()
+{
+	return threads_ > 1;
+}
+
+/** \brief A function to record a shape.
+ *
+ * The shape is given the current colour and line width. Shapes that cannot
+ * touch the image are dropped.
+ * \param s The shape, with its kind and arguments filled in.
+ * \param left The leftmost column the shape may touch.
+ * \param top The top row the shape may touch.
+ * \param right One past the rightmost column the shape may touch.
+ * \param bottom One past the bottom row the shape may touch.
+ */
+void TileCanvas::add(Shape &s, int left, int top, int right, int bottom)
+{
+	s.color = pen_color_;
+	s.line_width = pen_width_;
+	s.left = (left > 0) ? left : 0;
+	s.top = (top > 0) ? top : 0;
+	s.right = (right < width()) ? right : width();
+	s.bottom = (bottom < height()) ? bottom : height();
+	if ((s.left < s.right) && (s.top < s.bottom))
+	{
+		shapes_.push_back(s);
+	}
+}
+
+/** \brief A function to record the shape of the vertices given since the last begin_ function.
+ *
+ * \param kind SHAPE_LOOP, SHAPE_POINTS or SHAPE_POLYGON.
+ */
+void TileCanvas::add_vertices(int kind)
+{
+	Shape s;
+	s.kind = kind;
+	s.first = shape_start_;
+	s.count = shape_vertices_.size()/2 - shape_start_;
+	if (s.count == 0)
+	{
+		return;
+	}
+	int left = pixel(shape_vertices_[2*s.first]);
+	int top = pixel(shape_vertices_[2*s.first + 1]);
+	int right = left;
+	int bottom = top;
+	for (unsigned int i = s.first + 1; i < s.first + s.count; i++)
+	{
+		int x = pixel(shape_vertices_[2*i]);
+		int y = pixel(shape_vertices_[2*i + 1]);
+		left = (x < left) ? x : left;
+		right = (x > right) ? x : right;
+		top = (y < top) ? y : top;
+		bottom = (y > bottom) ? y : bottom;
+	}
+	// a pixel of slack covers the rounding of polygon edges, and lines are thicker
+	int pad = (kind == SHAPE_LOOP) ? ((pen_width_ > 1) ? pen_width_ : 1) + 1 : 1;
+	add(s, left - pad, top - pad, right + pad + 1, bottom + pad + 1);
+}
+
+/** \brief A function to set the colour of everything drawn after it.
+ */
+void TileCanvas::color(Fl_Color c)
+{
+	pen_color_ = c;
+	SoftCanvas::color(c);
+}
+
+/** \brief A function to set the width of lines drawn after it.
+ */
+void TileCanvas::line_style(int width)
+{
+	pen_width_ = width;
+	SoftCanvas::line_style(width);
+}
+
+/** \brief A function to fill a rectangle.
+ */
+void TileCanvas::rectf(int x, int y, int w, int h)
+{
+	if (!recording())
+	{
+		SoftCanvas::rectf(x, y, w, h);
+		return;
+	}
+	Shape s;
+	s.kind = SHAPE_RECTF;
+	s.i[0] = x;
+	s.i[1] = y;
+	s.i[2] = w;
+	s.i[3] = h;
+	add(s, x, y, x + w, y + h);
+}
+
+/** \brief A function to draw the outline of a rectangle.
+ */
+void TileCanvas::rect(int x, int y, int w, int h)
+{
+	if (!recording())
+	{
+		SoftCanvas::rect(x, y, w, h);
+		return;
+	}
+	Shape s;
+	s.kind = SHAPE_RECT;
+	s.i[0] = x;
+	s.i[1] = y;
+	s.i[2] = w;
+	s.i[3] = h;
+	int pad = ((pen_width_ > 1) ? pen_width_ : 1) + 1;
+	add(s, x - pad, y - pad, x + w + pad, y + h + pad);
+}
+
+/** \brief A function to draw a line.
+ */
+void TileCanvas::line(int x, int y, int x1, int y1)
+{
+	if (!recording())
+	{
+		SoftCanvas::line(x, y, x1, y1);
+		return;
+	}
+	Shape s;
+	s.kind = SHAPE_LINE;
+	s.i[0] = x;
+	s.i[1] = y;
+	s.i[2] = x1;
+	s.i[3] = y1;
+	int pad = ((pen_width_ > 1) ? pen_width_ : 1) + 1;
+	add(s, ((x < x1) ? x : x1) - pad, ((y < y1) ? y : y1) - pad, ((x > x1) ? x : x1) + pad + 1, ((y > y1) ? y : y1) + pad + 1);
+}
+
+/** \brief A function to draw a single pixel.
+ */
+void TileCanvas::point(int x, int y)
+{
+	if (!recording())
+	{
+		SoftCanvas::point(x, y);
+		return;
+	}
+	Shape s;
+	s.kind = SHAPE_POINT;
+	s.i[0] = x;
+	s.i[1] = y;
+	add(s, x, y, x + 1, y + 1);
+}
+
+/** \brief A function to draw the outline of a circle.
+ */
+void TileCanvas::circle(double x, double y, double r)
+{
+	if (!recording())
+	{
+		SoftCanvas::circle(x, y, r);
+		return;
+	}
+	Shape s;
+	s.kind = SHAPE_CIRCLE;
+	s.d[0] = x;
+	s.d[1] = y;
+	s.d[2] = r;
+	r = fabs(r);
+	int pad = ((pen_width_ > 1) ? pen_width_ : 1) + 1;
+	add(s, pixel(x - r) - pad, pixel(y - r) - pad, pixel(x + r) + pad + 1, pixel(y + r) + pad + 1);
+}
+
+/** \brief A function to fill part of an ellipse.
+ */
+void TileCanvas::pie(int x, int y, int w, int h, double a1, double a2)
+{
+	if (!recording())
+	{
+		SoftCanvas::pie(x, y, w, h, a1, a2);
+		return;
+	}
+	Shape s;
+	s.kind = SHAPE_PIE;
+	s.i[0] = x;
+	s.i[1] = y;
+	s.i[2] = w;
+	s.i[3] = h;
+	s.d[0] = a1;
+	s.d[1] = a2;
+	add(s, x, y, x + w, y + h);
+}
+
+/** \brief A function to draw part of the outline of an ellipse.
+ */
+void TileCanvas::arc(int x, int y, int w, int h, double a1, double a2)
+{
+	if (!recording())
+	{
+		SoftCanvas::arc(x, y, w, h, a1, a2);
+		return;
+	}
+	Shape s;
+	s.kind = SHAPE_ARC;
+	s.i[0] = x;
+	s.i[1] = y;
+	s.i[2] = w;
+	s.i[3] = h;
+	s.d[0] = a1;
+	s.d[1] = a2;
+	int pad = ((pen_width_ > 1) ? pen_width_ : 1) + 1;
+	add(s, x - pad, y - pad, x + w + pad + 1, y + h + pad + 1);
+}
+
+/** \brief A function to start a filled polygon.
+ */
+void TileCanvas::begin_polygon()
+{
+	SoftCanvas::begin_polygon();
+	shape_start_ = shape_vertices_.size()/2;
+}
+
+/** \brief A function to start a closed outline.
+ */
+void TileCanvas::begin_loop()
+{
+	SoftCanvas::begin_loop();
+	shape_start_ = shape_vertices_.size()/2;
+}
+
+/** \brief A function to start a batch of single pixels.
+ */
+void TileCanvas::begin_points()
+{
+	SoftCanvas::begin_points();
+	shape_start_ = shape_vertices_.size()/2;
+}
+
+/** \brief A function to add a vertex to the current shape.
+ */
+void TileCanvas::vertex(double x, double y)
+{
+	if (!recording())
+	{
+		SoftCanvas::vertex(x, y);
+		return;
+	}
+	shape_vertices_.push_back(x);
+	shape_vertices_.push_back(y);
+}
+
+/** \brief A function to draw the closed outline of the vertices given.
+ */
+void TileCanvas::end_loop()
+{
+	if (!recording())
+	{
+		SoftCanvas::end_loop();
+		return;
+	}
+	add_vertices(SHAPE_LOOP);
+}
+
+/** \brief A function to draw a pixel at each of the vertices given.
+ */
+void TileCanvas::end_points()
+{
+	if (!recording())
+	{
+		SoftCanvas::end_points();
+		return;
+	}
+	add_vertices(SHAPE_POINTS);
+}
+
+/** \brief A function to fill the polygon of the vertices given.
+ */
+void TileCanvas::end_polygon()
+{
+	if (!recording())
+	{
+		SoftCanvas::end_polygon();
+		return;
+	}
+	add_vertices(SHAPE_POLYGON);
+}
@@ -0,0 +1,106 @@
+/** \file TileCanvas.h
+ * \brief Header file for TileCanvas class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef TILECANVAS_H
+#define TILECANVAS_H
+
+#include "SoftCanvas.h"
+#include "thread.h"
+
+/** \brief The TileCanvas class, inherits from SoftCanvas
+ *
+ * The TileCanvas class draws the same image as a SoftCanvas, but can use
+ * several threads to do it. With more than one thread, the shapes drawn are
+ * only recorded, with the colour and line width they were drawn with. When
+ * finish() is called the image is split into TILE_SIZE squares, each shape
+ * is listed against every square it may touch, and the threads then take a
+ * square at a time and draw its shapes in order, clipped to it. Clipping
+ * never changes which pixels a shape covers, so the image is exactly what
+ * one thread would have drawn.
+ *
+ * The calling thread is one of the threads. The others are started by the
+ * first finish() and then wait to be woken by each one after, until the
+ * thread count changes or the TileCanvas is destroyed. Each thread keeps its
+ * own SoftCanvas between frames, so their caches stay warm.
+ */
+class TileCanvas : public SoftCanvas
+{
+public:
+	TileCanvas();
+	virtual ~TileCanvas();
+
+	virtual void threads(int n);
+	virtual int threads();
+	virtual void finish();
+
+	virtual void color(Fl_Color c);
+	virtual void line_style(int width);
+	virtual void rectf(int x, int y, int w, int h);
+	virtual void rect(int x, int y, int w, int h);
+	virtual void line(int x, int y, int x1, int y1);
+	virtual void point(int x, int y);
+	virtual void circle(double x, double y, double r);
+	virtual void pie(int x, int y, int w, int h, double a1, double a2);
+	virtual void arc(int x, int y, int w, int h, double a1, double a2);
+	virtual void begin_polygon();
+	virtual void begin_loop();
+	virtual void begin_points();
+	virtual void vertex(double x, double y);
+	virtual void end_loop();
+	virtual void end_points();
+	virtual void end_polygon();
+private:
+	/** \brief The kinds of shape that are recorded.
+	 */
+	enum {SHAPE_RECTF = 0, SHAPE_RECT, SHAPE_LINE, SHAPE_POINT, SHAPE_CIRCLE, SHAPE_PIE, SHAPE_ARC,
+		SHAPE_LOOP, SHAPE_POINTS, SHAPE_POLYGON};
+	/** \brief A recorded shape.
+	 */
+	struct Shape
+	{
+		int kind;
+		Fl_Color color;
+		int line_width;
+		int i[4];            ///< integer arguments
+		double d[3];         ///< floating point arguments
+		unsigned int first;  ///< index of the first vertex in shape_vertices_
+		unsigned int count;  ///< number of vertices
+		int left;            ///< pixels the shape may touch
+		int top;
+		int right;
+		int bottom;
+	};
+	/** \brief A thread that draws tiles.
+	 */
+	struct Worker
+	{
+		TileCanvas *owner;
+		SoftCanvas canvas;
+		Thread thread;
+		Semaphore wake;  ///< posted when there are tiles to draw or the thread should stop
+	};
+	bool recording();
+	void add(Shape &s, int left, int top, int right, int bottom);
+	void add_vertices(int kind);
+	void draw_tiles(SoftCanvas &canvas);
+	void draw_shape(SoftCanvas &canvas, const Shape &s);
+	void stop_workers();
+	static void worker_main(void *worker);
+	int threads_;
+	Fl_Color pen_color_;
+	int pen_width_;
+	vector<Shape> shapes_;
+	vector<double> shape_vertices_; ///< x and y of the vertices of every recorded shape
+	unsigned int shape_start_;  ///< first vertex given since the last begin_ function
+	vector< vector<unsigned int> > tiles_; ///< the shapes that may touch each tile, in order
+	int tiles_across_;
+	volatile long next_tile_;
+	vector<Worker*> workers_;
+	Semaphore done_;      ///< posted by a thread when it runs out of tiles
+	bool stopping_;
+};
+
+#endif
@@ -0,0 +1,235 @@
+/** \file TrailLayer.cpp
+ * \brief Code implementation for TrailLayer class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "TrailLayer.h"
+
+#include <Fl/fl_draw.h>
+#include <math.h>
+
+#include "Missile.h"
+
+/** \brief Constructor for TrailLayer.
+ *
+ * The offscreen buffer is created by the first draw().
+ */
+TrailLayer::TrailLayer()
+{
+	layer_ = 0;
+	width_ = 0;
+	height_ = 0;
+	line_ = 0;
+	valid_ = false;
+	updates_ = 0;
+}
+
+/** \brief Destructor for TrailLayer.
+ *
+ * The destructor frees the offscreen buffer.
+ */
+TrailLayer::~TrailLayer()
+{
+	if (layer_)
+	{
+		fl_delete_offscreen(layer_);
+	}
+}
+
+/** \brief A function to make the next draw() redraw the layer in full.
+ *
+ * The Window calls this whenever it draws a frame without the layer, since
+ * the trails may have changed in any way before it is next used.
+ */
+void TrailLayer::invalidate()
+{
+	valid_ = false;
+}
+
+/** \brief A function to bring the layer up to date and copy it to the current surface.
+ *
+ * The layer is drawn through the current View, and takes the place of
+ * filling the sky. Missiles without a Handle cannot be followed between
+ * frames and are left for the caller to draw.
+ * \param snap The snapshot being drawn.
+ */
+void TrailLayer::draw(const Snapshot &snap)
+{
+	const View &v = View::current();
+	int line = (int)(v.scale() + 0.5);
+	line = (line > 1) ? line : 0;
+	if (layer_ && ((width_ != v.width()) || (height_ != v.height())))
+	{
+		fl_delete_offscreen(layer_);
+		layer_ = 0;
+	}
+	if (!layer_)
+	{
+		layer_ = fl_create_offscreen(v.width(), v.height());
+		width_ = v.width();
+		height_ = v.height();
+		valid_ = false;
+	}
+	if (line != line_)
+	{
+		line_ = line;
+		valid_ = false;
+	}
+	fl_begin_offscreen(layer_);
+	fl_line_style(FL_SOLID, line_);
+	if (valid_)
+	{
+		updates_++;
+		for (unsigned int i = 0; (i < snap.missiles.size()) && valid_; i++)
+		{
+			const MissileState &m = snap.missiles[i];
+			if (m.handle == NULL_HANDLE)
+			{
+				continue;
+			}
+			unsigned int index = HandleTable::index(m.handle);
+			if (index >= trails_.size())
+			{
+				Trail unused = {NULL_HANDLE, 0, 0, 0, 0, 0};
+				trails_.resize(index + 1, unused);
+			}
+			Trail &t = trails_[index];
+			if (t.handle != m.handle)
+			{
+				// a slot's Missile only changes once the old one is gone
+				Trail old = t;
+				if (old.handle == NULL_HANDLE)
+				{
+					active_.push_back(index);
+				}
+				t.handle = m.handle;
+				t.start_x = m.start_x;
+				t.start_y = m.start_y;
+				t.x = m.start_x;
+				t.y = m.start_y;
+				if (old.handle != NULL_HANDLE)
+				{
+					erase(old);
+				}
+			}
+			else if ((t.start_x != m.start_x) || (t.start_y != m.start_y))
+			{
+				valid_ = false; // the game was replaced, by loading one for example
+			}
+			Missile::draw_trail(t.x, t.y, m.x, m.y);
+			t.x = m.x;
+			t.y = m.y;
+			t.seen = updates_;
+		}
+	}
+	if (valid_)
+	{
+		dead_.clear();
+		for (unsigned int i = 0; i < active_.size(); i++)
+		{
+			Trail &t = trails_[active_[i]];
+			if (t.seen != updates_)
+			{
+				dead_.push_back(t);
+				t.handle = NULL_HANDLE;
+				active_[i] = active_.back();
+				active_.pop_back();
+				i--;
+			}
+		}
+		for (unsigned int i = 0; i < dead_.size(); i++)
+		{
+			erase(dead_[i]);
+		}
+	}
+	else
+	{
+		rebuild(snap);
+	}
+	fl_end_offscreen();
+	fl_copy_offscreen(0, 0, width_, height_, layer_, 0, 0);
+}
+
+/** \brief A function to redraw the layer in full.
+ *
+ * \param snap The snapshot being drawn.
+ */
+void TrailLayer::rebuild(const Snapshot &snap)
+{
+	fl_color(SKY_BLUE);
+	fl_rectf(0, 0, width_, height_);
+	for (unsigned int i = 0; i < active_.size(); i++)
+	{
+		trails_[active_[i]].handle = NULL_HANDLE;
+	}
+	active_.clear();
+	updates_++;
+	for (unsigned int i = 0; i < snap.missiles.size(); i++)
+	{
+		const MissileState &m = snap.missiles[i];
+		if (m.handle == NULL_HANDLE)
+		{
+			continue;
+		}
+		unsigned int index = HandleTable::index(m.handle);
+		if (index >= trails_.size())
+		{
+			Trail unused = {NULL_HANDLE, 0, 0, 0, 0, 0};
+			trails_.resize(index + 1, unused);
+		}
+		Trail t = {m.handle, m.start_x, m.start_y, m.x, m.y, updates_};
+		trails_[index] = t;
+		active_.push_back(index);
+		Missile::draw_trail(m.start_x, m.start_y, m.x, m.y);
+	}
+	valid_ = true;
+}
+
+/** \brief A function to remove a trail from the layer.
+ *
+ * The trail's rectangle is filled with sky and the trails still on the layer
+ * that cross it are drawn again, clipped to it.
+ * \param trail The trail, which must already be off the active list.
+ */
+void TrailLayer::erase(const Trail &trail)
+{
+	int left, top, right, bottom;
+	bounds(trail, left, top, right, bottom);
+	fl_push_clip(left, top, right - left, bottom - top);
+	fl_color(SKY_BLUE);
+	fl_rectf(left, top, right - left, bottom - top);
+	for (unsigned int i = 0; i < active_.size(); i++)
+	{
+		const Trail &other = trails_[active_[i]];
+		int l, t, r, b;
+		bounds(other, l, t, r, b);
+		if ((l < right) && (r > left) && (t < bottom) && (b > top))
+		{
+			Missile::draw_trail(other.start_x, other.start_y, other.x, other.y);
+		}
+	}
+	fl_pop_clip();
+}
+
+/** \brief A function to find the pixels a trail may cover.
+ *
+ * \param t The trail.
+ * \param left Set to the leftmost column.
+ * \param top Set to the top row.
+ * \param right Set to one past the rightmost column.
+ * \param bottom Set to one past the bottom row.
+ */
+void TrailLayer::bounds(const Trail &t, int &left, int &top, int &right, int &bottom)
+{
+	const View &v = View::current();
+	int pad = line_/2 + 2;
+	double x0 = v.x(t.start_x);
+	double x1 = v.x(t.x);
+	double y0 = v.y(t.start_y);
+	double y1 = v.y(t.y);
+	left = (int)floor((x0 < x1) ? x0 : x1) - pad;
+	right = (int)floor((x0 > x1) ? x0 : x1) + pad + 1;
+	top = (int)floor((y0 < y1) ? y0 : y1) - pad;
+	bottom = (int)floor((y0 > y1) ? y0 : y1) + pad + 1;
+}
@@ -0,0 +1,63 @@
+/** \file TrailLayer.h
+ * \brief Header file for TrailLayer class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef TRAILLAYER_H
+#define TRAILLAYER_H
+
+#include <Fl/x.H>
+
+#include "enum.h"
+#include "Snapshot.h"
+#include "View.h"
+
+/** \brief The TrailLayer class.
+ *
+ * The TrailLayer class keeps the sky and every Missile's trail in an
+ * offscreen buffer that lasts between frames, so a trail is not redrawn
+ * from its start every frame. Each frame only the piece of each trail flown
+ * since the last frame drawn is added. When a Missile disappears its trail
+ * is erased once by filling its rectangle with sky and redrawing any other
+ * trails that cross it. Trails are matched up between frames by Handle.
+ *
+ * Drawing a frame therefore costs about as much as the missiles moved,
+ * rather than how far they have flown. Anything that changes the layer
+ * some other way, such as a new size or a loaded game, redraws it in full.
+ */
+class TrailLayer
+{
+public:
+	TrailLayer();
+	virtual ~TrailLayer();
+
+	virtual void invalidate();
+	virtual void draw(const Snapshot &snap);
+private:
+	/** \brief A trail on the layer.
+	 */
+	struct Trail
+	{
+		Handle handle;   ///< NULL_HANDLE if the slot is unused
+		double start_x;
+		double start_y;
+		double x;        ///< where the trail has been drawn to
+		double y;
+		unsigned long seen; ///< the last update the Missile was in
+	};
+	void rebuild(const Snapshot &snap);
+	void erase(const Trail &t);
+	void bounds(const Trail &t, int &left, int &top, int &right, int &bottom);
+	Fl_Offscreen layer_;
+	int width_;
+	int height_;
+	int line_;           ///< line width the trails are drawn with
+	bool valid_;
+	vector<Trail> trails_;        ///< indexed by handle index
+	vector<unsigned int> active_; ///< indices of the trails on the layer
+	vector<Trail> dead_;          ///< trails to erase this update
+	unsigned long updates_;
+};
+
+#endif
@@ -0,0 +1,98 @@
+/** \file TripleBuffer.h
+ * \brief Header file for TripleBuffer class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef TRIPLEBUFFER_H
+#define TRIPLEBUFFER_H
+
+#include "thread.h"
+
+/** \brief The TripleBuffer class.
+ *
+ * The TripleBuffer class passes whole objects from one writer thread to one
+ * reader thread without locking. The writer fills write_buffer() and calls
+ * publish(), the reader calls read() to get the most recently published
+ * object. Neither side ever waits for the other; if the writer publishes
+ * faster than the reader reads, the intermediate objects are skipped.
+ *
+ * The three buffers are never freed or reallocated, so an object's storage
+ * (e.g. vector capacity) is reused from one frame to the next.
+ */
+template <class T>
+class TripleBuffer
+{
+public:
+	TripleBuffer();
+
+	T& write_buffer();
+	void publish();
+	bool updated();
+	const T& read();
+private:
+	enum { INDEX_MASK = 3, DIRTY = 4 };
+	T buffers_[3];
+	volatile long middle_; // index of the middle buffer, plus DIRTY if it is newer than front
+	int back_;
+	int front_;
+};
+
+/** \brief Constructor for TripleBuffer.
+ */
+template <class T>
+TripleBuffer<T>::TripleBuffer()
+{
+	back_ = 0;
+	middle_ = 1;
+	front_ = 2;
+}
+
+/** \brief A function to access the buffer the writer fills.
+ *
+ * Only the writer thread may call this function.
+ * \return Returns the back buffer, which still holds whatever was last written to it.
+ */
+template <class T>
+T& TripleBuffer<T>::write_buffer()
+{
+	return buffers_[back_];
+}
+
+/** \brief A function to hand the back buffer to the reader.
+ *
+ * Only the writer thread may call this function.
+ */
+template <class T>
+void TripleBuffer<T>::publish()
+{
+	back_ = atomic_exchange(&middle_, back_ | DIRTY) & INDEX_MASK;
+}
+
+/** \brief A function to check if there is a newer object than the last read.
+ *
+ * \return Returns true if read() would return a different object.
+ */
+template <class T>
+bool TripleBuffer<T>::updated()
+{
+	return (atomic_load(&middle_) & DIRTY) != 0;
+}
+
+/** \brief A function to get the most recently published object.
+ *
+ * Only the reader thread may call this function. The returned object stays
+ * valid and unchanged until the next call to read().
+ * \return Returns the front buffer.
+ */
+template <class T>
+const T& TripleBuffer<T>::read()
+{
+	if (updated())
+	{
+		front_ = atomic_exchange(&middle_, front_) & INDEX_MASK;
+	}
+	return buffers_[front_];
+}
+
+#endif
@@ -5,28 +5,26 @@
  * \date May 2007
  */
 #include "UFO.h"
+#include "WorldState.h"
+#include "SaveState.h"
+#include "View.h"
+#include "Canvas.h"
 #include "Missile.h"
 #include "PlayerItem.h"
-
-#include <Fl/fl_draw.h>
-
-/** \brief Global vector of pointers to all UFO objects.
- *
- * This vector stores pointers to all UFO objects. It is self-managed.
- * When a UFO object is created, it adds itself to the vector and when
- * it is destroyed it removes itself from the vector.
- */
-vector<UFO*> UFO::ufos_;
+#include "CommandBuffer.h"
+#include "random.h"
 
 /** \brief Constructor for UFO.
  *
- * The constructor adds the UFO object to the global vector of shells.
+ * The constructor adds the UFO object to the current world's vector of shells.
  * To create an object, use "new UFO(...)" and the object can be 
  * accessed via the UFO::ufos() function.
  */
 UFO::UFO(double startx, double starty, double endx, double endy, double vel) : EnemyItem(startx, starty, endx, endy, UFO_RADIUS, vel)
 {
-	ufos_.push_back(this);
+	WorldState::current().ufos.push_back(this);
+	fire_in_ = 0;
+	fire_level_ = 0;
 }
 
 /** \brief Destructor for UFO.
@@ -36,12 +34,13 @@ UFO::UFO(double startx, double starty, double endx, double endy, double vel) : E
  */
 UFO::~UFO()
 {
+	vector<UFO*> &ufos = WorldState::current().ufos;
 	vector<UFO*>::iterator it;
-	for (it = ufos_.begin(); it != ufos_.end(); it++)
+	for (it = ufos.begin(); it != ufos.end(); it++)
 	{
 		if ((*it) == this)
 		{
-			ufos_.erase(it);
+			ufos.erase(it);
 			break;
 		}
 	}
@@ -56,13 +55,16 @@ UFO::~UFO()
  */
 const vector<UFO*>& UFO::ufos()
 {
-	return ufos_;
+	return WorldState::current().ufos;
 }
 
 /** \brief The animate function for the UFO.
  *
  * This function extends the projectile animate() function call to allow for firing of
- * Missile objects.
+ * Missile objects. The UFO fires as a Poisson process: the time until its next
+ * shot is drawn in advance and counted down, so it fires as often at any update
+ * rate. New missiles are recorded in the CommandBuffer. UFOs do not fire
+ * when the enemies are scripted, as the Scenario has their shots.
  * \param t is the amount of time in seconds that has passed since last
 		animation call.
  * \param level Optional: Current level, defaults to 1.
@@ -70,55 +72,108 @@ const vector<UFO*>& UFO::ufos()
  */
 int UFO::animate(double t, int level)
 {
+	const GameParams &p = WorldState::current().params;
 	if (Projectile::animate(t))
 	{
 		return 1;
 	}
-	else if ((rand() % (int)(UFO_FIRE_RATE/LEVEL_SCALE) == 0) && (Missile::missiles().size() < MAX_MISSILES))
+	if (WorldState::current().scripted)
+	{
+		return 0; // the scenario spawns its shots
+	}
+	if (fire_level_ != level)
+	{
+		// the wait is memoryless, so drawing it again at the new level's rate is exact
+		fire_in_ = game_rand_exponential(p.interval(p.ufo_fire_rate, level));
+		fire_level_ = level;
+	}
+	fire_in_ = fire_in_ - t;
+	while (fire_in_ <= 0)
 	{
-		if ((PlayerItem::playeritems().size() != 0) && (x() < WIN_WIDTH))
+		if ((Missile::missiles().size() + CommandBuffer::pending(SPAWN_MISSILE) < p.max_missiles)
+			&& (PlayerItem::playeritems().size() != 0) && (x() < WORLD_WIDTH))
 		{
-			int index = rand() % PlayerItem::playeritems().size();
+			int index = game_rand() % PlayerItem::playeritems().size();
 			PlayerItem *target = PlayerItem::playeritems()[index];
-			new Missile(x(), y(), target->x(), target->y(), MISSILE_VELOCITY*LEVEL_SCALE);
+			CommandBuffer::spawn_missile(x(), y(), target->x(), target->y(), MISSILE_VELOCITY*p.level_scale(level));
 		}
+		fire_in_ = fire_in_ + game_rand_exponential(p.interval(p.ufo_fire_rate, level));
 	}
 	return 0;
 }
 
-/** \brief The interface to draw the UFO.
+/** \brief The interface to capture the UFO for drawing.
  *
- * This protected draw() function calls the private draw_ufo() function
- * to draw the object
+ * This protected capture() function adds the drawing state of the UFO
+ * to the snapshot.
+ * \param snap The snapshot being filled in.
  */
-void UFO::draw()
+void UFO::capture(Snapshot &snap)
 {
-	draw_ufo();
+	UFOState s;
+	s.handle = handle();
+	s.x = x();
+	s.y = y();
+	s.radius = radius();
+	snap.ufos.push_back(s);
 }
 
 /** \brief The specialised drawing function for UFO.
  *
- * The draw_ufo() function uses the FLTK routines to draw the UFO in
- * the form of a flying saucer.
+ * The draw_ufo() function uses the FLTK routines to draw a captured UFO in
+ * the form of a flying saucer. At lower detail the saucer is drawn as a
+ * single rectangle.
+ * \param s The drawing state of the UFO.
+ * \param detail Optional: DETAIL_FULL, DETAIL_REDUCED or DETAIL_MINIMAL, defaults to DETAIL_FULL.
  */
-void UFO::draw_ufo()
+void UFO::draw_ufo(const UFOState &s, int detail)
 {
-	fl_color(FL_BLACK);
-	fl_begin_polygon();
-	fl_begin_loop();
-	fl_vertex(x(), y());
-	fl_vertex(x() - 10, y());
-	fl_vertex(x() - 20, y() + 10);
-	fl_vertex(x() - 10, y() + 20);
-	fl_vertex(x() + 10, y() + 20);
-	fl_vertex(x() + 20, y() + 10);
-	fl_vertex(x() + 10, y());
-	fl_end_loop();
-	fl_end_polygon();
-	fl_color(FL_GRAY);
-	fl_pie((int)(x() - 10), (int)(y() - 10), 20, 20, 0, 180);
+	const View &v = View::current();
+	Canvas &canvas = Canvas::current();
+	canvas.color(FL_BLACK);
+	if (detail != DETAIL_FULL)
+	{
+		canvas.rectf((int)v.x(s.x - 20), (int)v.y(s.y), (int)v.size(40), (int)v.size(20));
+		return;
+	}
+	canvas.begin_polygon();
+	canvas.begin_loop();
+	canvas.vertex(v.x(s.x), v.y(s.y));
+	canvas.vertex(v.x(s.x - 10), v.y(s.y));
+	canvas.vertex(v.x(s.x - 20), v.y(s.y + 10));
+	canvas.vertex(v.x(s.x - 10), v.y(s.y + 20));
+	canvas.vertex(v.x(s.x + 10), v.y(s.y + 20));
+	canvas.vertex(v.x(s.x + 20), v.y(s.y + 10));
+	canvas.vertex(v.x(s.x + 10), v.y(s.y));
+	canvas.end_loop();
+	canvas.end_polygon();
+	canvas.color(FL_GRAY);
+	canvas.pie((int)v.x(s.x - 10), (int)v.y(s.y - 10), (int)v.size(20), (int)v.size(20), 0, 180);
 #ifdef DEBUG
-	fl_color(FL_RED);
-	fl_circle(x(), y(), radius());
+	canvas.color(FL_RED);
+	canvas.circle(v.x(s.x), v.y(s.y), v.size(s.radius));
 #endif
 }
+
+/** \brief A function to save the UFO's state.
+ *
+ * \param r The record to save into.
+ */
+void UFO::save(ObjectRecord &r)
+{
+	EnemyItem::save(r);
+	r.type = OBJECT_UFO;
+	r.level = fire_level_;
+	r.next_event = fire_in_;
+}
+
+/** \brief A function to restore the UFO's state.
+ *
+ * \param r The record to restore from.
+ */
+void UFO::load(const ObjectRecord &r)
+{
+	EnemyItem::load(r);
+	fire_level_ = r.level;
+	fire_in_ = r.next_event;
+}
@@ -8,27 +8,37 @@
 #define UFO_H
 
 #include "EnemyItem.h"
+#include "Snapshot.h"
 
 /** \brief The UFO class.
  *
  * The UFO class is an EnemyItem that flys across the screen randomly shooting
- * Missile objects. The UFO was supposed to generate powerup objects when shot,
+ * Missile objects at random times, on average every GameParams::ufo_fire_rate
+ * updates. The UFO was supposed to generate powerup objects when shot,
  * however the powerup class has not been implemented. The UFO class allows acces
  * to a list of all the UFOs and the UFOs alone.
+ *
+ * A UFO must stay trivially copyable apart from its vtable, as a Missile
+ * must, because SpatialSort::relocate() moves UFOs the same way.
  */
 class UFO : public EnemyItem
 {
 public:
 	UFO(double startx, double starty, double endx, double endy, double vel);
 	virtual ~UFO();
+
+	friend class World;
 	
 	static const vector<UFO*>& ufos();
-	virtual int animate(double t, int level = 1);
+	int animate(double t, int level = 1);
+	static void draw_ufo(const UFOState &s, int detail = DETAIL_FULL);
+	virtual void save(ObjectRecord &r);
+	virtual void load(const ObjectRecord &r);
 protected:
-	virtual void draw();
+	void capture(Snapshot &snap);
 private:
-	static vector<UFO*> ufos_;
-	virtual void draw_ufo();
+	double fire_in_;  ///< seconds until the next missile is fired
+	int fire_level_;  ///< level fire_in_ was drawn for, 0 if not drawn yet
 };
 
 #endif
@@ -0,0 +1,62 @@
+/** \file View.cpp
+ * \brief Code implementation for View class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "View.h"
+
+#include "thread.h"
+
+/** \brief The View used when none has been chosen, one pixel per world unit.
+ */
+static View default_view;
+
+/** \brief The current View of this thread, 0 for default_view.
+ */
+static THREAD_LOCAL const View *current_view = 0;
+
+/** \brief Constructor for View.
+ *
+ * The new View maps one world unit to one pixel on a surface the size of
+ * the world.
+ */
+View::View()
+{
+	fit(WORLD_WIDTH, WORLD_HEIGHT);
+}
+
+/** \brief A function to fit the world to a surface.
+ *
+ * \param width The width of the surface in pixels.
+ * \param height The height of the surface in pixels.
+ */
+void View::fit(int width, int height)
+{
+	width_ = (width > 1) ? width : 1;
+	height_ = (height > 1) ? height : 1;
+	double sx = (double)width_/WORLD_WIDTH;
+	double sy = (double)height_/WORLD_HEIGHT;
+	scale_ = (sx < sy) ? sx : sy;
+	offset_x_ = (width_ - WORLD_WIDTH*scale_)/2;
+	offset_y_ = (height_ - WORLD_HEIGHT*scale_)/2;
+}
+
+/** \brief A function to return the current View.
+ *
+ * \return Returns the View the draw functions on this thread use.
+ */
+const View& View::current()
+{
+	return current_view ? *current_view : default_view;
+}
+
+/** \brief A function to choose the current View.
+ *
+ * \param view The View for the draw functions on this thread to use, or 0
+ *	for one pixel per world unit. It must stay alive while it is current.
+ */
+void View::current(const View *view)
+{
+	current_view = view;
+}
@@ -0,0 +1,123 @@
+/** \file View.h
+ * \brief Header file for View class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef VIEW_H
+#define VIEW_H
+
+#include "enum.h"
+
+/** \brief The View class.
+ *
+ * The View class maps world units onto the pixels of a drawing surface. The
+ * whole WORLD_WIDTH by WORLD_HEIGHT world is scaled by the same amount in
+ * both directions to fit the surface and centred on it. The draw functions
+ * take their positions and sizes in world units and convert them through
+ * the current View, which whatever is drawing sets first. Each thread has
+ * its own current View.
+ */
+class View
+{
+public:
+	View();
+
+	void fit(int width, int height);
+	int width() const;
+	int height() const;
+	double scale() const;
+	double x(double wx) const;
+	double y(double wy) const;
+	double size(double d) const;
+	double world_x(double px) const;
+	double world_y(double py) const;
+
+	static const View& current();
+	static void current(const View *view);
+private:
+	int width_;
+	int height_;
+	double scale_;
+	double offset_x_;
+	double offset_y_;
+};
+
+/** \brief A function to return the width of the surface.
+ *
+ * \return Returns the width in pixels.
+ */
+inline int View::width() const
+{
+	return width_;
+}
+
+/** \brief A function to return the height of the surface.
+ *
+ * \return Returns the height in pixels.
+ */
+inline int View::height() const
+{
+	return height_;
+}
+
+/** \brief A function to return the scale of the View.
+ *
+ * \return Returns the number of pixels in one world unit.
+ */
+inline double View::scale() const
+{
+	return scale_;
+}
+
+/** \brief A function to convert a world x co-ordinate to pixels.
+ *
+ * \param wx The x co-ordinate in world units.
+ * \return Returns the x co-ordinate in pixels.
+ */
+inline double View::x(double wx) const
+{
+	return offset_x_ + wx*scale_;
+}
+
+/** \brief A function to convert a world y co-ordinate to pixels.
+ *
+ * \param wy The y co-ordinate in world units.
+ * \return Returns the y co-ordinate in pixels.
+ */
+inline double View::y(double wy) const
+{
+	return offset_y_ + wy*scale_;
+}
+
+/** \brief A function to convert a length in world units to pixels.
+ *
+ * \param d The length in world units.
+ * \return Returns the length in pixels.
+ */
+inline double View::size(double d) const
+{
+	return d*scale_;
+}
+
+/** \brief A function to convert an x co-ordinate in pixels to world units.
+ *
+ * \param px The x co-ordinate in pixels.
+ * \return Returns the x co-ordinate in world units.
+ */
+inline double View::world_x(double px) const
+{
+	return (px - offset_x_)/scale_;
+}
+
+/** \brief A function to convert a y co-ordinate in pixels to world units.
+ *
+ * \param py The y co-ordinate in pixels.
+ * \return Returns the y co-ordinate in world units.
+ */
+inline double View::world_y(double py) const
+{
+	return (py - offset_y_)/scale_;
+}
+
+#endif
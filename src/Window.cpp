@@ -10,7 +10,7 @@
 #include <Fl/fl_draw.h>
 #include <Fl/Fl_Timer.H>
 #include <math.h>
-#include <time.h>
+#include <stdio.h>
 
 #ifdef WIN32
 #include <windows.h>
@@ -22,338 +22,538 @@
 #include "Missile.h"
 #include "UFO.h"
 #include "ShellExplosion.h"
+#include "timer.h"
+#include "trace.h"
+#include "alloc.h"
 
 /** \brief Constructor for Window
  *
- * The constructor seeds the random number generator, initialises some strings and
- * sets the gamestate to INITIALISE, as well as creating the Fl_Double_Window.
+ * The constructor starts the World, as well as
+ * creating the Fl_Double_Window. The window can be resized and draws at
+ * RENDER_SCALE times its own resolution.
  */
 Window::Window(int w, int h, const char *l = 0) : Fl_Double_Window(w, h, l)
 {
-	srand(time(NULL));
-	strlvl = "Level: ";
-	strscr = "Score: ";
-	gamestate = INITIALISE;
+	resizable(this);
+	size_range(WIN_WIDTH/4, WIN_HEIGHT/4);
+	scale = RENDER_SCALE;
+	render = 0;
+	render_width = 0;
+	render_height = 0;
+	background = 0;
+	background_width = 0;
+	background_height = 0;
+	background_valid = false;
+	background_hud = false;
+	hud_frames = 0;
+	particle_frame = 0;
+	world.start();
 }
 
 /** \brief Destructor for Window
  *
- * The destructor calls the cleanup routine.
+ * The destructor stops the World and frees the offscreen buffers.
  */
 Window::~Window()
 {
-	cleanup();
+	world.stop();
+	if (render)
+	{
+		fl_delete_offscreen(render);
+	}
+	if (background)
+	{
+		fl_delete_offscreen(background);
+	}
 }
 
-/* \brief A function to start the game.
+/** \brief A function to return the render resolution.
  *
- * This routine starts the game by initialising the score and level, spawning the
- * PlayerItem objects and setting the start time to current time.
+ * \return Returns the render resolution as a fraction of the window's.
  */
-void Window::start_game()
+double Window::render_scale()
 {
-	gamestate = NORMAL;
-	lasttime = get_time();
-	score = 0;
-	level = 1;
-	new Base(WIN_WIDTH/2 + SEPARATION/2, WIN_HEIGHT - GROUND_HEIGHT);
-	new Base(WIN_WIDTH/2 - SEPARATION/2, WIN_HEIGHT - GROUND_HEIGHT);
-	new Base(WIN_WIDTH/2 + 3*SEPARATION/2, WIN_HEIGHT - GROUND_HEIGHT);
-	new Base(WIN_WIDTH/2 - 3*SEPARATION/2, WIN_HEIGHT - GROUND_HEIGHT);
-	new Gun(WIN_WIDTH/2, WIN_HEIGHT-GROUND_HEIGHT, BARREL_WIDTH);
-	new Gun(WIN_WIDTH/2 + SEPARATION, WIN_HEIGHT-GROUND_HEIGHT, BARREL_WIDTH);
-	new Gun(WIN_WIDTH/2 - SEPARATION, WIN_HEIGHT-GROUND_HEIGHT, BARREL_WIDTH);
+	return scale;
 }
 
-/** \brief Cleanup function.
+/** \brief A function to set the render resolution.
  *
- * This function deletes all objects from the game.
+ * At 1 the game is drawn straight onto the window. Otherwise it is drawn
+ * offscreen at this fraction of the window's resolution, so 0.5 draws a
+ * quarter of the pixels, and then scaled to fill the window.
+ * \param s The render resolution as a fraction of the window's. Values that
+ *	are not positive are ignored.
  */
-void Window::cleanup()
+void Window::render_scale(double s)
 {
-	int i = 0;
-	while(PlayerItem::playeritems().size() > 0)
+	if (s > 0)
 	{
-		delete *PlayerItem::playeritems().begin();
-#ifdef DEBUG
-		cout << "deleted shootable " << i << endl;
-		i++;
-#endif
+		scale = s;
+		damage(FL_DAMAGE_ALL);
 	}
-	i = 0;
-	while(Projectile::projectiles().size() > 0)
+}
+
+/** \brief A function to return the frame time budget.
+ *
+ * \return Returns the budget in seconds.
+ */
+double Window::frame_budget()
+{
+	return governor.budget();
+}
+
+/** \brief A function to set the frame time budget.
+ *
+ * The Governor lowers the drawing quality while drawing and simulating a
+ * frame take longer than this, and raises it again when they are well under.
+ * \param budget The budget in seconds. Values that are not positive are
+ *	ignored.
+ */
+void Window::frame_budget(double budget)
+{
+	if (budget > 0)
 	{
-		delete *Projectile::projectiles().begin();
-#ifdef DEBUG
-		cout << "deleted projectile " << i << endl;
-		i++;
-#endif
-	}
-	i = 0;
-	while(Explosion::explosions().size() > 0)
-	{
-		delete *Explosion::explosions().begin();
-#ifdef DEBUG
-		cout << "deleted explosion " << i << endl;
-		i++;
-#endif
+		governor.budget(budget);
 	}
 }
 
+/** \brief A function to record every frame the game simulates.
+ *
+ * The simulation is paused while the Recorder is attached.
+ * \param recorder The Recorder, which must outlive the Window, or 0 to stop
+ *	recording.
+ */
+void Window::record(Recorder *recorder)
+{
+	world.stop();
+	world.record(recorder);
+	world.start();
+}
+
+/** \brief A function to publish every frame the game simulates to other processes.
+ *
+ * The simulation is paused while the SharedState is attached.
+ * \param shared The SharedState, which must outlive the Window, or 0 to stop
+ *	sharing.
+ */
+void Window::share(SharedState *shared)
+{
+	world.stop();
+	world.share(shared);
+	world.start();
+}
+
+/** \brief A function to script the enemies with a Scenario.
+ *
+ * The simulation is paused while the Scenario is attached.
+ * \param scenario The Scenario, which must outlive the Window, or 0 to spawn
+ *	enemies at random again.
+ */
+void Window::scenario(Scenario *scenario)
+{
+	world.stop();
+	world.scenario(scenario);
+	world.start();
+}
+
 /** \brief Drawing routine for the game.
  *
- * This routine draws the Window and calls the draw functions for all
- * the objects in the game. It also draws some messages to the screen
- * depending on the current state of the game.
+ * This routine draws the latest snapshot of the game, either straight onto
+ * the window or, if the render scale is not 1, onto an offscreen buffer
+ * that present() then scales to the window. The time taken is reported to
+ * the governor, whose quality setting decides which savings are used while
+ * the game is running.
  */
 void Window::draw()
 {
-	fl_color(SKY_BLUE);
-	fl_rectf(0, 0, WIN_WIDTH, WIN_HEIGHT);
+	TRACE_SCOPE("draw");
+	ALLOC_TAG("draw");
+	double drawstart = get_time();
+	const Snapshot &snap = world.snapshot();
+	{
+		TRACE_SCOPE("particles");
+		update_particles(snap);
+	}
+	output.fit(w(), h());
+	if (scale == 1)
+	{
+		view = output;
+		draw_scene(snap);
+	}
+	else
+	{
+		int width = (int)(w()*scale + 0.5);
+		int height = (int)(h()*scale + 0.5);
+		width = (width > 1) ? width : 1;
+		height = (height > 1) ? height : 1;
+		if (!render || (width != render_width) || (height != render_height))
+		{
+			if (render)
+			{
+				fl_delete_offscreen(render);
+			}
+			render = fl_create_offscreen(width, height);
+			render_width = width;
+			render_height = height;
+			render_pixels.resize(width*height*3);
+		}
+		view.fit(render_width, render_height);
+		fl_begin_offscreen(render);
+		draw_scene(snap);
+		fl_read_image(&render_pixels[0], 0, 0, render_width, render_height);
+		fl_end_offscreen();
+		TRACE_SCOPE("present");
+		present();
+	}
+	governor.frame(get_time() - drawstart, snap.animate_time);
+	ALLOC_FRAME();
+}
+
+/** \brief Scene drawing function.
+ *
+ * This function calls the draw functions for all the objects in a snapshot
+ * through the current view, and draws some messages depending on the state
+ * of the game. Lines are thickened to match the scale.
+ * \param snap The snapshot being drawn.
+ */
+void Window::draw_scene(const Snapshot &snap)
+{
+	View::current(&view);
+	int line = (int)(view.scale() + 0.5);
+	fl_line_style(FL_SOLID, (line > 1) ? line : 0);
+	int gamestate = snap.gamestate;
+	bool playing = (gamestate == NORMAL) || (gamestate == PAUSED);
+	int missile_detail = detail(snap.missiles.size(), LOD_MISSILE_TAILS, LOD_MISSILE_POINTS);
+	if (missile_detail < governor.trail_detail())
+	{
+		missile_detail = governor.trail_detail();
+	}
+	// whole trails are kept on the trail layer, which includes the sky
+	bool trail_layer = playing && (missile_detail == DETAIL_FULL);
+	bool hud_cached = false;
+	TRACE_BEGIN("background");
+	ALLOC_PHASE("background");
+	if (trail_layer)
+	{
+		TRACE_SCOPE("trails");
+		trails.draw(snap);
+	}
+	else if (playing && governor.background_cache())
+	{
+		draw_background(snap);
+		hud_cached = background_hud;
+	}
+	else
+	{
+		fl_color(SKY_BLUE);
+		fl_rectf(0, 0, view.width(), view.height());
+		background_valid = false;
+	}
+	if (!trail_layer)
+	{
+		trails.invalidate();
+	}
+	TRACE_END("background");
 
 	if (gamestate == INITIALISE)
 	{
-		int x = 0;
-		int y = 0;
-		strstatus = "Press Esc to start a new game.";
-		fl_color(FL_BLACK);
-		fl_font(FL_HELVETICA,30);
-		fl_measure(strstatus.c_str(), x, y);
-		fl_draw(strstatus.c_str(), (WIN_WIDTH-x)/2,(WIN_HEIGHT+y-30)/2);
-		strstatus = "Press Esc during the game to pause.";
-		x = 0;
-		y = 0;
-		fl_measure(strstatus.c_str(), x, y);
-		fl_draw(strstatus.c_str(), (WIN_WIDTH-x)/2,(WIN_HEIGHT+y+30)/2);
+		draw_message("Press Esc to start a new game.", -30);
+		draw_message("Press Esc during the game to pause.", 30);
 	}
 	else if (gamestate == GAMEOVER)
 	{
-		int x = 0;
-		int y = 0;
-		strstatus = "You Lose! Press Esc to start a new game.";
-		fl_color(FL_BLACK);
-		fl_font(FL_HELVETICA,30);
-		fl_measure(strstatus.c_str(), x, y);
-		fl_draw(strstatus.c_str(), (WIN_WIDTH-x)/2,(WIN_HEIGHT+y-30)/2);
-		oss.str("");
-		oss << "Score was " << score << ", died on level " << level << ".";
-		x = 0;
-		y = 0;
-		fl_measure(oss.str().c_str(), x, y);
-		fl_draw(oss.str().c_str(), (WIN_WIDTH-x)/2,(WIN_HEIGHT+y+30)/2);
+		draw_message("You Lose! Press Esc to start a new game.", -30);
+		char text[TEXT_LENGTH];
+		sprintf(text, "Score was %d, died on level %d.", snap.score, snap.level);
+		draw_message(text, 30);
 	}
 	else // normal game operation
 	{
-		for (unsigned int i = 0; i < Projectile::projectiles().size(); i++)
+		TRACE_BEGIN("missiles");
+		ALLOC_PHASE("missiles");
+		for (unsigned int i = 0; i < snap.missiles.size(); i++)
+		{
+			if (!trail_layer || (snap.missiles[i].handle == NULL_HANDLE))
+			{
+				Missile::draw_missile(snap.missiles[i], missile_detail);
+			}
+		}
+		TRACE_END("missiles");
+		TRACE_BEGIN("ufos");
+		ALLOC_PHASE("ufos");
+		int ufo_detail = detail(snap.ufos.size(), LOD_UFO_SIMPLE, LOD_UFO_SIMPLE);
+		for (unsigned int i = 0; i < snap.ufos.size(); i++)
+		{
+			UFO::draw_ufo(snap.ufos[i], ufo_detail);
+		}
+		TRACE_END("ufos");
+		TRACE_BEGIN("shells");
+		ALLOC_PHASE("shells");
+		for (unsigned int i = 0; i < snap.shells.size(); i++)
 		{
-			Projectile::projectiles()[i]->draw();
+			Shell::draw_shell(snap.shells[i]);
 		}
+		TRACE_END("shells");
 		
-		for (unsigned int i = 0; i < Explosion::explosions().size(); i++)
+		TRACE_BEGIN("explosions");
+		ALLOC_PHASE("explosions");
+		if (detail(snap.shellexplosions.size(), LOD_EXPLOSION_MERGE, LOD_EXPLOSION_MERGE) != DETAIL_FULL)
 		{
-			Explosion::explosions()[i]->draw();
+			ShellExplosion::draw_merged(snap.shellexplosions);
 		}
+		else
+		{
+			for (unsigned int i = 0; i < snap.shellexplosions.size(); i++)
+			{
+				ShellExplosion::draw_shellexplosion(snap.shellexplosions[i], governor.explosion_fill());
+			}
+		}
+		TRACE_END("explosions");
 		
+		TRACE_BEGIN("player items");
+		ALLOC_PHASE("player items");
 		fl_color(GRASS);
-		fl_rectf(0, WIN_HEIGHT-GROUND_HEIGHT, WIN_WIDTH, WIN_HEIGHT);
+		int ground = (int)view.y(WORLD_HEIGHT - GROUND_HEIGHT);
+		fl_rectf(0, ground, view.width(), view.height() - ground);
 
-		for (unsigned int i = 0; i < PlayerItem::playeritems().size(); i++)
+		for (unsigned int i = 0; i < snap.bases.size(); i++)
 		{
-			PlayerItem::playeritems()[i]->draw();
+			Base::draw_base(snap.bases[i]);
 		}
+		for (unsigned int i = 0; i < snap.guns.size(); i++)
+		{
+			Gun::draw_gun(snap.guns[i]);
+		}
+		TRACE_END("player items");
 
-		fl_color(FL_BLACK);
-		fl_font(FL_HELVETICA,20);
-		level = 1 + score / SCORE_NEXT_LEVEL;
-		oss.str("");
-		oss << strlvl << level;
-		fl_draw(oss.str().c_str(), 40,40);
-		oss.str("");
-		oss << strscr << score;
-		fl_draw(oss.str().c_str(), 40,60);
+		TRACE_BEGIN("particles");
+		ALLOC_PHASE("particles");
+		particles.draw();
+		TRACE_END("particles");
+
+		if (!hud_cached)
+		{
+			TRACE_SCOPE("hud");
+			ALLOC_PHASE("hud");
+			draw_hud(snap);
+		}
 
 		if (gamestate == PAUSED)
 		{
-			int x = 0;
-			int y = 0;
-			strstatus = "Paused... Press Esc to Continue.";
-			fl_color(FL_BLACK);
-			fl_font(FL_HELVETICA,30);
-			fl_measure(strstatus.c_str(), x, y);
-			fl_draw(strstatus.c_str(), (WIN_WIDTH-x)/2,(WIN_HEIGHT+y)/2);
+			draw_message("Paused... Press Esc to Continue.", 0);
 		}
 	}
+	fl_line_style(0);
+	View::current(0);
 }
 
-/** \brief Animation function for the game.
+/** \brief Message drawing function.
  *
- * This function calls the animate and collision routines for the various objects in the game.
+ * This function draws a line of text centred across the world.
+ * \param text The text to draw.
+ * \param offset How far below the middle of the world the text is centred,
+ *	in world units, times two.
  */
-void Window::animate()
+void Window::draw_message(const char *text, double offset)
 {
-	currenttime = get_time();
-	//Spawn UFO
-	if (rand() % (int)UFO_SPAWN_FACTOR/LEVEL_SCALE == 0)
-	{
-		new UFO(0, 100, WIN_WIDTH + 50, 100, UFO_VELOCITY*LEVEL_SCALE);
-	}
-	//Spawn Missile
-	if ((Missile::missiles().size() < MAX_MISSILES) && (rand() % (int)(MISSILE_SPAWN_FACTOR/LEVEL_SCALE) == 0))
+	int x = 0;
+	int y = 0;
+	fl_color(FL_BLACK);
+	fl_font(FL_HELVETICA, text_size(30));
+	fl_measure(text, x, y);
+	fl_draw(text, (int)(view.x(WORLD_WIDTH/2) - x/2), (int)(view.y(WORLD_HEIGHT/2) + (y + view.size(offset))/2));
+}
+
+/** \brief A function to scale a font size to the view.
+ *
+ * \param size The font size at one pixel per world unit.
+ * \return Returns the font size in pixels, at least 1.
+ */
+int Window::text_size(double size)
+{
+	int s = (int)(view.size(size) + 0.5);
+	return (s > 1) ? s : 1;
+}
+
+/** \brief A function to show the offscreen render in the window.
+ *
+ * The pixels read back from the render buffer are scaled to the window by
+ * picking the nearest pixel, then drawn as one image.
+ */
+void Window::present()
+{
+	int width = (w() > 1) ? w() : 1;
+	int height = (h() > 1) ? h() : 1;
+	window_pixels.resize(width*height*3);
+	unsigned char *dst = &window_pixels[0];
+	for (int y = 0; y < height; y++)
 	{
-		if (PlayerItem::playeritems().size() != 0)
+		const unsigned char *row = &render_pixels[(y*render_height/height)*render_width*3];
+		for (int x = 0; x < width; x++)
 		{
-			int index = rand() % PlayerItem::playeritems().size();
-			PlayerItem *target = PlayerItem::playeritems()[index];
-			new Missile((double)(rand() % WIN_WIDTH), 0.0, target->x(), target->y(), MISSILE_VELOCITY*LEVEL_SCALE);
+			const unsigned char *src = row + (x*render_width/width)*3;
+			dst[0] = src[0];
+			dst[1] = src[1];
+			dst[2] = src[2];
+			dst = dst + 3;
 		}
 	}
-	//UFO action
-	for (int i = 0; i < (int)UFO::ufos().size(); i++)
+	fl_draw_image(&window_pixels[0], 0, 0, width, height);
+}
+
+/** \brief Background drawing function.
+ *
+ * This function draws the sky from an offscreen cache instead of filling it.
+ * When the governor asks for a slow HUD the level and score are baked into
+ * the cache too, and the cache is only redrawn every few frames.
+ * \param snap The snapshot being drawn.
+ */
+void Window::draw_background(const Snapshot &snap)
+{
+	bool hud = governor.hud_interval() > 1;
+	hud_frames++;
+	if (background && ((background_width != view.width()) || (background_height != view.height())))
 	{
-		if (UFO::ufos()[i]->animate(currenttime - lasttime, level))
-		{
-			delete UFO::ufos()[i];
-			i--;
-		}
+		fl_delete_offscreen(background);
+		background = 0;
 	}
-	//Missile action
-	for (int i = 0; i < (int)Missile::missiles().size(); i++)
+	if (!background)
 	{
-		if ((Missile::missiles()[i]->collision_detect() == true) || (Missile::missiles()[i]->animate(currenttime - lasttime)))
-		{
-#ifdef DEBUG2
-			cout << "missile " << i << " action" << endl;
-#endif
-			Missile::missiles()[i]->on_death();
-			delete Missile::missiles()[i];
-			i--;
-		}
+		background = fl_create_offscreen(view.width(), view.height());
+		background_width = view.width();
+		background_height = view.height();
+		background_valid = false;
 	}
-	//Shell action
-	for (int i = 0; i < (int)Shell::shells().size(); i++)
+	if (!background_valid || (hud != background_hud) || (hud && (hud_frames >= governor.hud_interval())))
 	{
-		if (Shell::shells()[i]->animate(currenttime - lasttime))
+		fl_begin_offscreen(background);
+		fl_color(SKY_BLUE);
+		fl_rectf(0, 0, background_width, background_height);
+		if (hud)
 		{
-#ifdef DEBUG2
-			cout << "shell " << i << " action" << endl;
-#endif
-			Shell::shells()[i]->on_death();
-			delete Shell::shells()[i];
-			i--;
+			draw_hud(snap);
 		}
+		fl_end_offscreen();
+		background_valid = true;
+		background_hud = hud;
+		hud_frames = 0;
 	}
-	//Explosion animate
-	for (int i = 0; i < (int)Explosion::explosions().size(); i++)
+	fl_copy_offscreen(0, 0, background_width, background_height, background, 0, 0);
+}
+
+/** \brief HUD drawing function.
+ *
+ * This function draws the level and score.
+ * \param snap The snapshot being drawn.
+ */
+void Window::draw_hud(const Snapshot &snap)
+{
+	fl_color(FL_BLACK);
+	fl_font(FL_HELVETICA, text_size(20));
+	char text[TEXT_LENGTH];
+	sprintf(text, "Level: %d", snap.level);
+	fl_draw(text, (int)view.x(40), (int)view.y(40));
+	sprintf(text, "Score: %d", snap.score);
+	fl_draw(text, (int)view.x(40), (int)view.y(60));
+}
+
+/** \brief Level of detail function.
+ *
+ * This function picks how much detail to draw a type of object with. The
+ * number of objects is scaled by how crowded the surface being drawn is
+ * compared to one pixel per world unit before being compared with the
+ * thresholds, so drawing at a lower resolution uses less detail sooner.
+ * \param count The number of objects of the type in the snapshot.
+ * \param reduced The scaled count above which DETAIL_REDUCED is used.
+ * \param minimal The scaled count above which DETAIL_MINIMAL is used.
+ * \return Returns DETAIL_FULL, DETAIL_REDUCED or DETAIL_MINIMAL.
+ */
+int Window::detail(unsigned int count, int reduced, int minimal)
+{
+	double density = count/(view.scale()*view.scale());
+	if (density > minimal)
 	{
-		if (Explosion::explosions()[i]->animate(currenttime - lasttime))
-		{
-			delete Explosion::explosions()[i];
-			i--;
-		}
+		return DETAIL_MINIMAL;
 	}
-	//ShellExplosion collision
-	for (int i = 0; i < (int)ShellExplosion::shellexplosions().size(); i++)
+	if (density > reduced)
 	{
-		score = ShellExplosion::shellexplosions()[i]->collision_detect(score);
-		if (ShellExplosion::shellexplosions()[i]->timealive() > 1)
-		{
-			delete ShellExplosion::shellexplosions()[i];
-		}
+		return DETAIL_REDUCED;
 	}
-	lasttime = currenttime;
+	return DETAIL_FULL;
+}
+
+/** \brief A function to bring the particles up to the snapshot being drawn.
+ *
+ * The particles for the effects the World has reported are spawned, and the
+ * particles are moved on by the frames simulated since the last call. They
+ * are removed when no game is being played.
+ * \param snap The snapshot about to be drawn.
+ */
+void Window::update_particles(const Snapshot &snap)
+{
+	EffectState e;
+	while (world.next_effect(e))
+	{
+		particles.emit(e);
+	}
+	if ((snap.gamestate != NORMAL) && (snap.gamestate != PAUSED))
+	{
+		particles.clear();
+	}
+	else if (snap.frame > particle_frame)
+	{
+		particles.update((snap.frame - particle_frame)*TIMESTEP);
+	}
+	particle_frame = snap.frame;
 }
 
 /** \brief Hanler function for the game.
  *
  * This function handles the various events that FLTK generates as well as the
- * timer event generated in main.cpp. The Esc key is used as a rudimentary menu
- * system and the mouse controls the Gun objects.
+ * timer event generated in main.cpp. Key presses and mouse events are passed to
+ * the World through its input queue, the timer event flushes the latest mouse
+ * movement to the World and redraws the window if a new snapshot is ready.
  * \param e Event number
  * \return Returns 1 if event handled, otherwise return what Fl_Group::handle returned
  */
 int Window::handle(int e)
 {
+	TRACE_SCOPE("handle");
 	int ret = Fl_Group::handle(e);
 
-#ifdef DEBUG // toggle gun powerup with tab button in debug mode
-	if ((e == FL_KEYDOWN) && (Fl::event_key() == FL_Tab))
-	{
-		for (int i = 0; i < Gun::guns().size(); i++)
-		{
-			Gun::guns()[i]->barrel_width(30-Gun::guns()[i]->barrel_width());
-		}
-	}
-#endif
-
-	if ((e == FL_KEYDOWN) && (Fl::event_key() == FL_Escape))
-	{
-		switch (gamestate)
-		{
-			case INITIALISE: // start game
-				start_game();
-				break;
-			case NORMAL: // pause game
-				gamestate = PAUSED;
-				break;
-			case PAUSED: // unpause game
-				gamestate = NORMAL;
-				// reset last time because a large period of time may have passed in pause mode that shouldn't be counted
-				lasttime = get_time();
-				break;
-			case GAMEOVER: // restart game
-				cleanup();
-				start_game();
-				break;
-			default:
-				break;
-		}
-		damage(FL_DAMAGE_ALL);
-		return 1;
-	}
-
-	// if player has run out of guns or bases, game over
-	if (((Gun::guns().size() == 0) || (Base::bases().size() == 0)) && (gamestate == NORMAL))
+	switch (e)
 	{
-		gamestate = GAMEOVER;
-		cleanup();
-		damage(FL_DAMAGE_ALL);
-		return 1;
-	}
-	
-	if (gamestate == NORMAL) // handle mouse and timer events
-	{
-		switch (e)
-		{
-			case TIMER_CALLBACK:
-				animate();
-				damage(FL_DAMAGE_ALL);
-				return 1;
-			case FL_DRAG:
-				//do the same for move and drag
-			case FL_MOVE:
-				for (unsigned int i = 0; i < Gun::guns().size(); i++)
-				{
-					Gun::guns()[i]->target(Fl::event_x(), Fl::event_y());
-				}
-				damage(FL_DAMAGE_ALL);
-				return 1;
-			case FL_PUSH:
-				for (unsigned int i = 0; i < Gun::guns().size(); i++)
-				{
-					if ((Gun::guns()[i]->target_valid() == true) && (Shell::shells().size() < MAX_SHELLS))
-					{
-						double width = Gun::guns()[i]->barrel_width();
-						new Shell(Gun::guns()[i]->x(), Gun::guns()[i]->y(), Fl::event_x()+i*SCATTER_FACTOR(width), Fl::event_y()+i*SCATTER_FACTOR(width), width/2);
-					}
-				}
+		case TIMER_CALLBACK:
+			world.input().flush();
+			if (world.updated())
+			{
 				damage(FL_DAMAGE_ALL);
+			}
+			return 1;
+		case FL_KEYDOWN:
+#ifdef DEBUG // toggle gun powerup with tab button in debug mode
+			if (Fl::event_key() == FL_Tab)
+			{
+				world.input().push(e, Fl::event_key(), 0);
+			}
+#endif
+			if ((Fl::event_key() == FL_Escape) || (Fl::event_key() == FL_F + 5) || (Fl::event_key() == FL_F + 9))
+			{
+				world.input().push(e, Fl::event_key(), 0);
 				return 1;
-			default:
-				return ret;
-		}
-	}
-	else
-	{
-		return ret;
+			}
+			return ret;
+		case FL_DRAG:
+			//do the same for move, drag and push
+		case FL_MOVE:
+		case FL_PUSH:
+			// input is in world units, whatever the window size
+			if (!world.input().push(e, (int)floor(output.world_x(Fl::event_x()) + 0.5), (int)floor(output.world_y(Fl::event_y()) + 0.5)))
+			{
+				return ret; // the simulation is too far behind to take the click
+			}
+			return 1;
+		default:
+			return ret;
 	}
 }
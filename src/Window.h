@@ -8,13 +8,28 @@
 #define WINDOW_H
 
 #include <Fl/Fl_Double_Window.H>
+#include <Fl/x.H>
 
 #include "enum.h"
+#include "World.h"
+#include "Governor.h"
+#include "View.h"
+#include "TrailLayer.h"
+#include "ParticleSystem.h"
 
 /** \brief The Window class, inherits from Fl_Double_Window
  *
- * The Window class controls the flow of the game and handles things like
- * drawing routines and handling events.
+ * The Window class handles things like drawing routines and handling events.
+ * The game itself is run by a World on its own thread; the Window passes it
+ * input events and draws the snapshots it publishes. A Governor measures each
+ * frame and lowers the drawing quality when frames go over budget.
+ *
+ * The world is scaled to fit the window, which can be resized. It can also
+ * be drawn at a different resolution to the window and then scaled to it,
+ * so a slow machine can draw fewer pixels. Neither changes the game.
+ * Missile trails drawn in full are kept on a TrailLayer between frames.
+ * Explosions and impacts the World reports are drawn as particles, which
+ * only live in the Window.
  */
 class Window : public Fl_Double_Window
 {
@@ -23,21 +38,43 @@ public:
 	virtual ~Window();
 
 	int handle(int e);
+	virtual double render_scale();
+	virtual void render_scale(double scale);
+	virtual double frame_budget();
+	virtual void frame_budget(double budget);
+	virtual void record(Recorder *recorder);
+	virtual void share(SharedState *shared);
+	virtual void scenario(Scenario *scenario);
 protected:
 	virtual void draw();
-	virtual void animate();
-	virtual void start_game();
-	virtual void cleanup();
+	virtual void draw_scene(const Snapshot &snap);
+	virtual void draw_background(const Snapshot &snap);
+	virtual void draw_hud(const Snapshot &snap);
+	virtual void draw_message(const char *text, double offset);
+	virtual void present();
+	virtual int text_size(double size);
+	virtual int detail(unsigned int count, int reduced, int minimal);
+	virtual void update_particles(const Snapshot &snap);
 private:
-	int gamestate;
-	int score;
-	int level;
-	double lasttime;
-	double currenttime;
-	string strlvl;
-	string strscr;
-	string strstatus;
-	stringstream oss;
+	World world;
+	Governor governor;
+	View view;          ///< maps the world onto the surface being drawn
+	View output;        ///< maps the world onto the window, for input
+	double scale;       ///< render resolution as a fraction of the window's
+	Fl_Offscreen render;
+	int render_width;
+	int render_height;
+	vector<unsigned char> render_pixels;
+	vector<unsigned char> window_pixels;
+	Fl_Offscreen background;
+	int background_width;
+	int background_height;
+	bool background_valid;
+	bool background_hud;
+	int hud_frames;
+	TrailLayer trails;
+	ParticleSystem particles;
+	unsigned long particle_frame; ///< the frame the particles were moved to
 };
 
 #endif
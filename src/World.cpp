@@ -0,0 +1,977 @@
+/** \file World.cpp
+ * \brief Code implementation for World class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "World.h"
+
+#include <Fl/Fl.H>
+#include <stdlib.h>
+#include <time.h>
+#include <string.h>
+
+#include "timer.h"
+#include "Gun.h"
+#include "Base.h"
+#include "Shell.h"
+#include "Missile.h"
+#include "UFO.h"
+#include "ShellExplosion.h"
+#include "CommandBuffer.h"
+#include "random.h"
+#include "SaveState.h"
+#include "MappedFile.h"
+#include "Recorder.h"
+#include "SharedState.h"
+#include "Scenario.h"
+#include "Hash.h"
+#include "trace.h"
+#include "alloc.h"
+
+/** \brief Constructor for World
+ *
+ * The constructor seeds the random number generator and sets the gamestate
+ * to INITIALISE. The simulation thread is not started until start() is called.
+ */
+World::World()
+{
+	StateScope scope(&state_);
+	game_srand(::time(NULL));
+	running_ = 0;
+	recorder_ = 0;
+	shared_ = 0;
+	scenario_ = 0;
+	scenario_start_ = 0;
+	own_scenario_ = 0;
+	checksum_log_ = 0;
+	gamestate_ = INITIALISE;
+	score_ = 0;
+	level_ = 1;
+	frame_ = 0;
+	time_ = 0;
+	next_ufo_ = 0;
+	next_missile_ = 0;
+	spawn_level_ = 0;
+	animate_time_ = 0;
+}
+
+/** \brief Destructor for World
+ *
+ * The destructor stops the simulation thread and calls the cleanup routine.
+ */
+World::~World()
+{
+	stop();
+	StateScope scope(&state_);
+	cleanup();
+	delete own_scenario_;
+}
+
+/** \brief A function to start the simulation thread.
+ *
+ * An initial snapshot is published first so there is always something to draw.
+ */
+void World::start()
+{
+	if (thread_.running())
+	{
+		return;
+	}
+	{
+		StateScope scope(&state_);
+		publish();
+	}
+	atomic_store(&running_, 1);
+	thread_.start(thread_main, this);
+}
+
+/** \brief A function to stop the simulation thread.
+ *
+ * This function waits for the current update to finish before returning.
+ */
+void World::stop()
+{
+	atomic_store(&running_, 0);
+	thread_.join();
+}
+
+/** \brief A function to access the input queue.
+ *
+ * The Window pushes input events into this queue from the FLTK thread.
+ * \return Returns the input queue.
+ */
+InputQueue& World::input()
+{
+	return input_;
+}
+
+/** \brief A function to check if a new snapshot has been published.
+ *
+ * \return Returns true if snapshot() would return a newer snapshot than last time.
+ */
+bool World::updated()
+{
+	return snapshots_.updated();
+}
+
+/** \brief A function to read the latest snapshot.
+ *
+ * Only the drawing thread may call this function. The snapshot stays valid
+ * until the next call.
+ * \return Returns the most recently published snapshot.
+ */
+const Snapshot& World::snapshot()
+{
+	return snapshots_.read();
+}
+
+/** \brief A function to take the oldest visual effect waiting to be drawn.
+ *
+ * Only effects reported while the simulation thread runs are queued, and
+ * only one thread may take them.
+ * \param e Set to the effect.
+ * \return Returns false if there are none waiting.
+ */
+bool World::next_effect(EffectState &e)
+{
+	return effects_.pop(e);
+}
+
+/** \brief Entry point for the simulation thread.
+ *
+ * \param world Pointer to the World to run.
+ */
+void World::thread_main(void *world)
+{
+	((World*)world)->run();
+}
+
+/** \brief The simulation loop.
+ *
+ * The loop applies queued input, advances the game in fixed steps of
+ * TIMESTEP to catch up with real time and publishes a snapshot, then sleeps
+ * until the next step is due. If the simulation falls far behind (for example
+ * when the machine is suspended) the missed time is dropped rather than
+ * simulated in one burst.
+ */
+void World::run()
+{
+	StateScope scope(&state_);
+	TRACE_THREAD("simulation");
+	double lasttime = get_time();
+	double accumulator = 0;
+	while (atomic_load(&running_))
+	{
+		double currenttime = get_time();
+		TRACE_BEGIN("input");
+		process_input();
+		TRACE_END("input");
+		animate_time_ = 0;
+		if (gamestate_ == NORMAL)
+		{
+			accumulator = accumulator + currenttime - lasttime;
+			if (accumulator > MAX_CATCHUP*TIMESTEP)
+			{
+				accumulator = MAX_CATCHUP*TIMESTEP;
+			}
+			double animate_start = get_time();
+			while ((accumulator >= TIMESTEP) && (gamestate_ == NORMAL))
+			{
+				animate(TIMESTEP);
+				record_frame();
+				share_frame();
+				checksum_frame();
+				send_effects();
+				accumulator = accumulator - TIMESTEP;
+			}
+			animate_time_ = get_time() - animate_start;
+		}
+		else
+		{
+			// a large period of time may pass in other modes that shouldn't be counted
+			accumulator = 0;
+		}
+		lasttime = currenttime;
+		TRACE_BEGIN("publish");
+		publish();
+		TRACE_END("publish");
+		ALLOC_FRAME();
+		Thread::sleep(TIMESTEP - (get_time() - currenttime));
+	}
+}
+
+/* \brief A function to start the game.
+ *
+ * This routine starts the game by initialising the score and level and
+ * spawning the PlayerItem objects. Any Scenario is played from the start.
+ */
+void World::start_game()
+{
+	ALLOC_TAG("start game");
+	gamestate_ = NORMAL;
+	score_ = 0;
+	level_ = 1;
+	spawn_level_ = 0;
+	state_.shells_fired = 0;
+	state_.missiles_killed = 0;
+	scenario_start_ = time_;
+	if (scenario_)
+	{
+		scenario_->rewind();
+	}
+	new Base(WORLD_WIDTH/2 + SEPARATION/2, WORLD_HEIGHT - GROUND_HEIGHT);
+	new Base(WORLD_WIDTH/2 - SEPARATION/2, WORLD_HEIGHT - GROUND_HEIGHT);
+	new Base(WORLD_WIDTH/2 + 3*SEPARATION/2, WORLD_HEIGHT - GROUND_HEIGHT);
+	new Base(WORLD_WIDTH/2 - 3*SEPARATION/2, WORLD_HEIGHT - GROUND_HEIGHT);
+	new Gun(WORLD_WIDTH/2, WORLD_HEIGHT-GROUND_HEIGHT, BARREL_WIDTH);
+	new Gun(WORLD_WIDTH/2 + SEPARATION, WORLD_HEIGHT-GROUND_HEIGHT, BARREL_WIDTH);
+	new Gun(WORLD_WIDTH/2 - SEPARATION, WORLD_HEIGHT-GROUND_HEIGHT, BARREL_WIDTH);
+}
+
+/** \brief A function to draw the times of the next spawns.
+ *
+ * UFOs and missiles spawn as Poisson processes in game time, at the rates
+ * GameParams::interval() gives for the current level. The time of each next
+ * spawn is drawn in advance, so animate() only has to compare it with the
+ * clock, and the same number spawn on average whatever the update rate. The
+ * waits are memoryless, so drawing them again when the level changes is exact.
+ */
+void World::schedule()
+{
+	const GameParams &p = state_.params;
+	spawn_level_ = level_;
+	next_ufo_ = time_ + game_rand_exponential(p.interval(p.ufo_spawn_factor, level_));
+	next_missile_ = time_ + game_rand_exponential(p.interval(p.missile_spawn_factor, level_));
+}
+
+/** \brief Cleanup function.
+ *
+ * This function deletes all objects from the game, and any commands recorded
+ * for them this update, so nothing from the old game is applied afterwards.
+ */
+void World::cleanup()
+{
+	CommandBuffer::clear();
+	int i = 0;
+	while(PlayerItem::playeritems().size() > 0)
+	{
+		delete *PlayerItem::playeritems().begin();
+#ifdef DEBUG
+		cout << "deleted shootable " << i << endl;
+		i++;
+#endif
+	}
+	i = 0;
+	while(Projectile::projectiles().size() > 0)
+	{
+		delete *Projectile::projectiles().begin();
+#ifdef DEBUG
+		cout << "deleted projectile " << i << endl;
+		i++;
+#endif
+	}
+	i = 0;
+	while(Explosion::explosions().size() > 0)
+	{
+		delete *Explosion::explosions().begin();
+#ifdef DEBUG
+		cout << "deleted explosion " << i << endl;
+		i++;
+#endif
+	}
+}
+
+/** \brief A function to save the game.
+ *
+ * Only the simulation thread may call this function while it is running.
+ * \param filename The file to save to.
+ * \return Returns true if the game was saved.
+ */
+bool World::save(const char *filename)
+{
+	StateScope scope(&state_);
+	SaveHeader h;
+	save_header(h);
+	return SaveState::write(filename, h);
+}
+
+/** \brief A function to fill in the game's part of a saved game header.
+ *
+ * The fields describing the file are left zero.
+ * \param h The header.
+ */
+void World::save_header(SaveHeader &h)
+{
+	memset(&h, 0, sizeof(h));
+	h.gamestate = gamestate_;
+	h.score = score_;
+	h.level = level_;
+	h.frame = frame_;
+	h.rand_state = state_.rand_state;
+	h.time = time_;
+	h.next_ufo = next_ufo_;
+	h.next_missile = next_missile_;
+	h.scenario_start = scenario_start_;
+	h.spawn_level = spawn_level_;
+	h.shells_fired = (unsigned int)state_.shells_fired;
+	h.missiles_killed = (unsigned int)state_.missiles_killed;
+}
+
+/** \brief A function to copy out the whole state of the game.
+ *
+ * This is what a saved game would hold, for comparing games in detail.
+ * Only the simulation thread may call this function while it is running.
+ * \param header Set to the game's part of a saved game header.
+ * \param records Set to a record of every object, in registry order.
+ */
+void World::capture_state(SaveHeader &header, vector<ObjectRecord> &records)
+{
+	StateScope scope(&state_);
+	save_header(header);
+	SaveState::capture(records);
+}
+
+/** \brief A function to load a saved game.
+ *
+ * The file is mapped and checked once, and the current game is replaced from
+ * that same mapping only if it is a valid saved game. Any Scenario is moved
+ * to the loaded game's time, so it spawns exactly what the saved game had
+ * still to come. Only the simulation thread may call this function while it
+ * is running.
+ * \param filename The file to load from.
+ * \return Returns true if the game was loaded.
+ */
+bool World::load(const char *filename)
+{
+	StateScope scope(&state_);
+	MappedFile file;
+	const SaveHeader *h = SaveState::open(file, filename);
+	if (!h)
+	{
+		return false;
+	}
+	cleanup();
+	SaveState::read(h);
+	gamestate_ = h->gamestate;
+	score_ = h->score;
+	level_ = h->level;
+	frame_ = h->frame;
+	time_ = h->time;
+	next_ufo_ = h->next_ufo;
+	next_missile_ = h->next_missile;
+	spawn_level_ = h->spawn_level;
+	state_.shells_fired = h->shells_fired;
+	state_.missiles_killed = h->missiles_killed;
+	scenario_start_ = h->scenario_start;
+	if (scenario_)
+	{
+		scenario_->seek(time_ - scenario_start_);
+	}
+	return true;
+}
+
+/** \brief A function to copy the game.
+ *
+ * The copy has the same objects, scores, parameters and random number generator state, so
+ * stepping it gives exactly what the original would do with the same input.
+ * If a Scenario is attached the copy plays its own copy of it, from the same
+ * place. Its simulation thread is not started and its input queue is empty. Only the
+ * simulation thread may call this function while it is running.
+ * \return Returns the new World. The caller deletes it.
+ */
+World* World::clone()
+{
+	World *w = new World();
+	w->gamestate_ = gamestate_;
+	w->score_ = score_;
+	w->level_ = level_;
+	w->frame_ = frame_;
+	w->time_ = time_;
+	w->next_ufo_ = next_ufo_;
+	w->next_missile_ = next_missile_;
+	w->spawn_level_ = spawn_level_;
+	w->scenario_start_ = scenario_start_;
+	if (scenario_)
+	{
+		w->own_scenario_ = new Scenario;
+		if (w->own_scenario_->open(*scenario_))
+		{
+			w->scenario_ = w->own_scenario_;
+		}
+	}
+	vector<ObjectRecord> records;
+	{
+		StateScope scope(&state_);
+		SaveState::capture(records);
+	}
+	StateScope scope(&w->state_);
+	SaveState::restore(records.empty() ? 0 : &records[0], records.size());
+	w->state_.rand_state = state_.rand_state;
+	w->state_.params = state_.params;
+	w->state_.scripted = state_.scripted;
+	w->state_.shells_fired = state_.shells_fired;
+	w->state_.missiles_killed = state_.missiles_killed;
+	return w;
+}
+
+/** \brief A function to advance the game without the simulation thread.
+ *
+ * Each tick applies any queued input and then, unless the game is paused or
+ * over, advances the game by t. Nothing is published, but every tick the
+ * game advances is recorded, shared and checksummed as set up. The
+ * simulation thread must not be running.
+ * \param ticks The number of ticks to run.
+ * \param t Optional: Seconds of game time per tick, defaults to TIMESTEP.
+ */
+void World::step(int ticks, double t)
+{
+	StateScope scope(&state_);
+	for (int i = 0; i < ticks; i++)
+	{
+		process_input();
+		if (gamestate_ == NORMAL)
+		{
+			animate(t);
+			record_frame();
+			share_frame();
+			checksum_frame();
+		}
+		ALLOC_FRAME();
+	}
+}
+
+/** \brief A function to return the state of the game.
+ *
+ * \return Returns INITIALISE, NORMAL, PAUSED or GAMEOVER.
+ */
+int World::state()
+{
+	return gamestate_;
+}
+
+/** \brief A function to return the score.
+ *
+ * \return Returns the score.
+ */
+int World::score()
+{
+	return score_;
+}
+
+/** \brief A function to return the level.
+ *
+ * \return Returns the level.
+ */
+int World::level()
+{
+	return level_;
+}
+
+/** \brief A function to return the number of updates since the game started.
+ *
+ * \return Returns the frame number.
+ */
+unsigned long World::frame()
+{
+	return frame_;
+}
+
+/** \brief A function to return the game time.
+ *
+ * Like the frame number, the time only advances while the game is being played.
+ * \return Returns the number of seconds of game time played.
+ */
+double World::time()
+{
+	return time_;
+}
+
+/** \brief A function to return the number of shells fired this game.
+ *
+ * \return Returns the number of shells fired.
+ */
+unsigned long World::shells_fired()
+{
+	return state_.shells_fired;
+}
+
+/** \brief A function to return the number of missiles shot down this game.
+ *
+ * \return Returns the number of missiles destroyed by shell explosions.
+ */
+unsigned long World::missiles_killed()
+{
+	return state_.missiles_killed;
+}
+
+/** \brief A function to access the game parameters.
+ *
+ * The parameters may only be changed while the simulation thread is not
+ * running.
+ * \return Returns the parameters.
+ */
+GameParams& World::params()
+{
+	return state_.params;
+}
+
+/** \brief A function to seed the random number generator.
+ *
+ * Two Worlds with the same seed, parameters and input play the same game.
+ * The simulation thread must not be running.
+ * \param s The seed.
+ */
+void World::seed(unsigned int s)
+{
+	StateScope scope(&state_);
+	game_srand(s);
+}
+
+/** \brief A function to attach a Recorder.
+ *
+ * Every frame the game is advanced by from then on is passed to the
+ * Recorder, which must stay alive until it is detached or the World is
+ * stopped. The simulation thread must not be running.
+ * \param recorder The Recorder, or 0 to stop recording.
+ */
+void World::record(Recorder *recorder)
+{
+	recorder_ = recorder;
+}
+
+/** \brief A function to attach a SharedState.
+ *
+ * Every frame the game is advanced by from then on is published to the
+ * SharedState, which must stay alive until it is detached or the World is
+ * stopped. The simulation thread must not be running.
+ * \param shared The SharedState, created for publishing, or 0 to stop.
+ */
+void World::share(SharedState *shared)
+{
+	shared_ = shared;
+}
+
+/** \brief A function to attach a Scenario.
+ *
+ * While a Scenario is attached every UFO and Missile is spawned by it at
+ * the time it gives, counted from the start of the game, and UFOs do not
+ * fire by themselves; the random spawn rates and the max_missiles limit are
+ * not used. It is played from the start when a game starts, and from where
+ * it is now if attached during a game. A loaded game plays it on from the
+ * loaded game's time, and a clone() plays a copy of it from the same place. The simulation thread must not be running.
+ * \param scenario The Scenario, opened to play, which must stay alive until
+ *	it is detached or the World is stopped, or 0 to spawn at random again.
+ */
+void World::scenario(Scenario *scenario)
+{
+	scenario_ = scenario;
+	scenario_start_ = time_;
+	state_.scripted = (scenario != 0);
+}
+
+/** \brief A function to log a checksum of the game after every update.
+ *
+ * Each line of the log is the frame number and checksum() in hex. Two runs
+ * that should play the same game, such as different builds or thread
+ * counts, can be compared with fsd-sim --compare to find the first frame
+ * they differ on. The simulation thread must not be running.
+ * \param log The file to log to, which must stay open until it is detached
+ *	or the World is stopped, or 0 to stop logging.
+ */
+void World::log_checksums(FILE *log)
+{
+	checksum_log_ = log;
+}
+
+/** \brief A function to return a checksum of the whole game.
+ *
+ * Everything that decides how the game carries on is hashed: the game
+ * state, score, level, frame, game time and spawn times, the random number
+ * generator, the statistics and every object as it would be saved, in
+ * registry order. Only the simulation thread may call this function while
+ * it is running.
+ * \return Returns the checksum.
+ */
+unsigned int World::checksum()
+{
+	StateScope scope(&state_);
+	SaveHeader game;
+	save_header(game);
+	Hash h;
+	h.add(&game, sizeof(game));
+	h.add((unsigned int)state_.shells_fired);
+	h.add((unsigned int)state_.missiles_killed);
+	SaveState::capture(checksum_records_);
+	if (!checksum_records_.empty())
+	{
+		h.add(&checksum_records_[0], checksum_records_.size()*sizeof(ObjectRecord));
+	}
+	return h.value();
+}
+
+/** \brief Input processing function for the game.
+ *
+ * This function applies the input events queued since the last update in the
+ * order they arrived. The Esc key is used as a rudimentary menu system and the
+ * mouse controls the Gun objects. Mouse movements have already been coalesced
+ * by the InputQueue so the guns are re-aimed at most once per frame between
+ * clicks, and each click aims the guns at the exact click position before firing.
+ * F5 saves the game to SAVE_FILE and F9 loads it back. Events after a
+ * successful load were meant for the game it replaced, so they are dropped.
+ */
+void World::process_input()
+{
+	ALLOC_TAG("input");
+	InputEvent e;
+	while (input_.pop(e))
+	{
+#ifdef DEBUG // toggle gun powerup with tab button in debug mode
+		if ((e.type == FL_KEYDOWN) && (e.x == FL_Tab))
+		{
+			for (unsigned int i = 0; i < Gun::guns().size(); i++)
+			{
+				Gun::guns()[i]->barrel_width(30-Gun::guns()[i]->barrel_width());
+			}
+		}
+#endif
+		if ((e.type == FL_KEYDOWN) && (e.x == FL_F + 5))
+		{
+			save(SAVE_FILE);
+		}
+		else if ((e.type == FL_KEYDOWN) && (e.x == FL_F + 9))
+		{
+			if (load(SAVE_FILE))
+			{
+				while (input_.pop(e))
+				{
+				}
+			}
+		}
+		else if ((e.type == FL_KEYDOWN) && (e.x == FL_Escape))
+		{
+			switch (gamestate_)
+			{
+				case INITIALISE: // start game
+					start_game();
+					break;
+				case NORMAL: // pause game
+					gamestate_ = PAUSED;
+					break;
+				case PAUSED: // unpause game
+					gamestate_ = NORMAL;
+					break;
+				case GAMEOVER: // restart game
+					cleanup();
+					start_game();
+					break;
+				default:
+					break;
+			}
+		}
+		else if ((gamestate_ == NORMAL) && ((e.type == FL_MOVE) || (e.type == FL_PUSH)))
+		{
+			for (unsigned int i = 0; i < Gun::guns().size(); i++)
+			{
+				Gun::guns()[i]->target(e.x, e.y);
+			}
+			if (e.type == FL_PUSH)
+			{
+				for (unsigned int i = 0; i < Gun::guns().size(); i++)
+				{
+					if ((Gun::guns()[i]->target_valid() == true) && (Shell::shells().size() + CommandBuffer::pending(SPAWN_SHELL) < state_.params.max_shells))
+					{
+						double width = Gun::guns()[i]->barrel_width();
+						// separate statements so the random numbers are drawn in the same order on every compiler
+						double target_x = e.x+i*SCATTER_FACTOR(width);
+						double target_y = e.y+i*SCATTER_FACTOR(width);
+						CommandBuffer::spawn_shell(Gun::guns()[i]->x(), Gun::guns()[i]->y(), target_x, target_y, width/2);
+						state_.shells_fired++;
+					}
+				}
+			}
+		}
+	}
+	CommandBuffer::apply();
+}
+
+/** \brief Animation function for the game.
+ *
+ * This function calls the animate and collision routines for the various objects
+ * in the game, and ends the game if the player has run out of guns or bases.
+ * Objects are never created or deleted while the registries are being looped
+ * over; the changes are recorded in the CommandBuffer and applied together
+ * at the end of the update, and objects destroyed earlier in the update are
+ * skipped. UFOs and missiles spawn at the times drawn by schedule(), or
+ * when the Scenario says. Every SPATIAL_SORT_INTERVAL updates the enemies
+ * are put back in order of position once the changes are applied.
+ * \param t is the amount of time in seconds to advance the game by.
+ */
+void World::animate(double t)
+{
+	TRACE_SCOPE("animate");
+	ALLOC_TAG("spawn");
+	const GameParams &p = state_.params;
+	double scale = p.level_scale(level_);
+	frame_++;
+	time_ = time_ + t;
+	state_.effects.clear();
+	TRACE_BEGIN("spawn");
+	if (scenario_)
+	{
+		//Spawn what the scenario has due by now
+		SpawnRecord s;
+		while (scenario_->next(time_ - scenario_start_, s))
+		{
+			if (s.type == OBJECT_UFO)
+			{
+				CommandBuffer::spawn_ufo(s.start_x, s.start_y, s.target_x, s.target_y, s.velocity);
+			}
+			else
+			{
+				CommandBuffer::spawn_missile(s.start_x, s.start_y, s.target_x, s.target_y, s.velocity);
+			}
+		}
+	}
+	else
+	{
+		if (spawn_level_ != level_)
+		{
+			schedule();
+		}
+		//Spawn UFOs due by now
+		while (next_ufo_ <= time_)
+		{
+			CommandBuffer::spawn_ufo(0, 100, WORLD_WIDTH + 50, 100, UFO_VELOCITY*scale);
+			next_ufo_ = next_ufo_ + game_rand_exponential(p.interval(p.ufo_spawn_factor, level_));
+		}
+		//Spawn Missiles due by now
+		while (next_missile_ <= time_)
+		{
+			if ((Missile::missiles().size() + CommandBuffer::pending(SPAWN_MISSILE) < p.max_missiles) && (PlayerItem::playeritems().size() != 0))
+			{
+				int index = game_rand() % PlayerItem::playeritems().size();
+				PlayerItem *target = PlayerItem::playeritems()[index];
+				double start_x = (double)(game_rand() % WORLD_WIDTH);
+				CommandBuffer::spawn_missile(start_x, 0.0, target->x(), target->y(), MISSILE_VELOCITY*scale);
+			}
+			next_missile_ = next_missile_ + game_rand_exponential(p.interval(p.missile_spawn_factor, level_));
+		}
+	}
+	TRACE_END("spawn");
+	//UFO action
+	TRACE_BEGIN("ufos");
+	ALLOC_PHASE("ufos");
+	for (unsigned int i = 0; i < UFO::ufos().size(); i++)
+	{
+		if (UFO::ufos()[i]->animate(t, level_))
+		{
+			CommandBuffer::destroy(UFO::ufos()[i]);
+		}
+	}
+	TRACE_END("ufos");
+	//Missile action
+	TRACE_BEGIN("missiles");
+	ALLOC_PHASE("missiles");
+	for (unsigned int i = 0; i < Missile::missiles().size(); i++)
+	{
+		if ((Missile::missiles()[i]->collision_detect() == true) || (Missile::missiles()[i]->animate(t)))
+		{
+#ifdef DEBUG2
+			cout << "missile " << i << " action" << endl;
+#endif
+			Missile::missiles()[i]->on_death();
+			CommandBuffer::destroy(Missile::missiles()[i]);
+		}
+	}
+	TRACE_END("missiles");
+	//Shell action
+	TRACE_BEGIN("shells");
+	ALLOC_PHASE("shells");
+	for (unsigned int i = 0; i < Shell::shells().size(); i++)
+	{
+		if (Shell::shells()[i]->animate(t))
+		{
+#ifdef DEBUG2
+			cout << "shell " << i << " action" << endl;
+#endif
+			Shell::shells()[i]->on_death();
+			CommandBuffer::destroy(Shell::shells()[i]);
+		}
+	}
+	TRACE_END("shells");
+	//Explosion animate
+	TRACE_BEGIN("explosions");
+	ALLOC_PHASE("explosions");
+	for (unsigned int i = 0; i < Explosion::explosions().size(); i++)
+	{
+		if (Explosion::explosions()[i]->animate(t))
+		{
+			CommandBuffer::destroy(Explosion::explosions()[i]);
+		}
+	}
+	TRACE_END("explosions");
+	//ShellExplosion collision
+	TRACE_BEGIN("collisions");
+	ALLOC_PHASE("collisions");
+	if (p.use_kill_mask)
+	{
+		score_ = ShellExplosion::collision_detect_all(score_);
+	}
+	for (unsigned int i = 0; i < ShellExplosion::shellexplosions().size(); i++)
+	{
+		if (ShellExplosion::shellexplosions()[i]->dead())
+		{
+			continue;
+		}
+		if (!p.use_kill_mask)
+		{
+			score_ = ShellExplosion::shellexplosions()[i]->collision_detect(score_);
+		}
+		if (ShellExplosion::shellexplosions()[i]->timealive() > 1)
+		{
+			CommandBuffer::destroy(ShellExplosion::shellexplosions()[i]);
+		}
+	}
+	TRACE_END("collisions");
+	CommandBuffer::apply();
+	level_ = 1 + score_ / SCORE_NEXT_LEVEL;
+	if (p.use_spatial_sort)
+	{
+		TRACE_BEGIN("spatial sort");
+		ALLOC_PHASE("spatial sort");
+		if (frame_ % SPATIAL_SORT_INTERVAL == 0)
+		{
+			state_.spatial_sort.sort();
+		}
+		else
+		{
+			state_.spatial_sort.step();
+		}
+		TRACE_END("spatial sort");
+	}
+
+	// if player has run out of guns or bases, game over
+	if ((Gun::guns().size() == 0) || (Base::bases().size() == 0))
+	{
+		gamestate_ = GAMEOVER;
+		cleanup();
+	}
+}
+
+/** \brief A function to publish a snapshot of the game.
+ *
+ * The game is captured into the back buffer, which is then handed to the
+ * drawing thread.
+ */
+void World::publish()
+{
+	ALLOC_TAG("publish");
+	capture(snapshots_.write_buffer());
+	snapshots_.publish();
+}
+
+/** \brief A function to capture a snapshot of the game.
+ *
+ * Every object captures its drawing state into the snapshot. Each kind of
+ * object is captured from its own registry, so every capture() call is
+ * resolved at compile time.
+ * \param snap The snapshot to fill in.
+ */
+void World::capture(Snapshot &snap)
+{
+	snap.clear();
+	for (unsigned int i = 0; i < Missile::missiles().size(); i++)
+	{
+		Missile::missiles()[i]->capture(snap);
+	}
+	for (unsigned int i = 0; i < UFO::ufos().size(); i++)
+	{
+		UFO::ufos()[i]->capture(snap);
+	}
+	for (unsigned int i = 0; i < Shell::shells().size(); i++)
+	{
+		Shell::shells()[i]->capture(snap);
+	}
+	for (unsigned int i = 0; i < ShellExplosion::shellexplosions().size(); i++)
+	{
+		ShellExplosion::shellexplosions()[i]->capture(snap);
+	}
+	for (unsigned int i = 0; i < Base::bases().size(); i++)
+	{
+		Base::bases()[i]->capture(snap);
+	}
+	for (unsigned int i = 0; i < Gun::guns().size(); i++)
+	{
+		Gun::guns()[i]->capture(snap);
+	}
+	snap.gamestate = gamestate_;
+	snap.score = score_;
+	snap.level = level_;
+	snap.frame = frame_;
+	snap.animate_time = animate_time_;
+}
+
+/** \brief A function to queue the effects of the last update for the Window.
+ *
+ * Effects that do not fit are dropped; they only change what is drawn.
+ */
+void World::send_effects()
+{
+	for (unsigned int i = 0; i < state_.effects.size(); i++)
+	{
+		effects_.push(state_.effects[i]);
+	}
+}
+
+/** \brief A function to pass the frame just simulated to the Recorder.
+ *
+ * Nothing is done if no Recorder is attached or it has no room for the
+ * frame.
+ */
+void World::record_frame()
+{
+	if (!recorder_)
+	{
+		return;
+	}
+	TRACE_SCOPE("record");
+	ALLOC_TAG("record");
+	Snapshot *snap = recorder_->frame();
+	if (snap)
+	{
+		capture(*snap);
+		recorder_->submit();
+	}
+}
+
+/** \brief A function to publish the frame just simulated to the SharedState.
+ *
+ * Nothing is done if no SharedState is attached.
+ */
+void World::share_frame()
+{
+	if (!shared_)
+	{
+		return;
+	}
+	TRACE_SCOPE("share");
+	ALLOC_TAG("share");
+	capture(shared_frame_);
+	shared_->publish(shared_frame_);
+}
+
+/** \brief A function to log the checksum of the frame just simulated.
+ *
+ * Nothing is done if no log is attached.
+ */
+void World::checksum_frame()
+{
+	if (!checksum_log_)
+	{
+		return;
+	}
+	TRACE_SCOPE("checksum");
+	ALLOC_TAG("checksum");
+	fprintf(checksum_log_, "%lu %08x\n", frame_, checksum());
+}
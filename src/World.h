@@ -0,0 +1,114 @@
+/** \file World.h
+ * \brief Header file for World class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef WORLD_H
+#define WORLD_H
+
+#include <stdio.h>
+
+#include "enum.h"
+#include "thread.h"
+#include "InputQueue.h"
+#include "Snapshot.h"
+#include "TripleBuffer.h"
+#include "SpscQueue.h"
+#include "WorldState.h"
+#include "SaveState.h"
+
+class Recorder;
+class SharedState;
+class Scenario;
+
+/** \brief The World class.
+ *
+ * The World class owns the state of the game and runs the simulation on its
+ * own thread. Input reaches it through the InputQueue and after every update
+ * it publishes a Snapshot of the game through a TripleBuffer, which the Window
+ * draws from. Neither thread ever waits for the other.
+ *
+ * Every World has its own WorldState, so any number of them can exist at
+ * once. clone() makes an independent copy of a World that step() can then
+ * run ahead without a thread, for lookahead search and what-if analysis.
+ * A Recorder can be attached to write every frame the World simulates, and
+ * a SharedState to publish every frame to other processes. A checksum of
+ * the whole game can be logged after every update, so runs that should be
+ * identical can be compared frame by frame. The enemies can be scripted by
+ * a Scenario instead of being spawned at random.
+ * Visual effects reported while the thread runs are queued for the Window.
+ */
+class World
+{
+public:
+	World();
+	virtual ~World();
+
+	virtual void start();
+	virtual void stop();
+	virtual InputQueue& input();
+	virtual bool updated();
+	virtual const Snapshot& snapshot();
+	virtual bool next_effect(EffectState &e);
+	virtual bool save(const char *filename);
+	virtual bool load(const char *filename);
+	virtual World* clone();
+	virtual void step(int ticks, double t = TIMESTEP);
+	virtual int state();
+	virtual int score();
+	virtual int level();
+	virtual unsigned long frame();
+	virtual double time();
+	virtual unsigned long shells_fired();
+	virtual unsigned long missiles_killed();
+	virtual GameParams& params();
+	virtual void seed(unsigned int s);
+	virtual void record(Recorder *recorder);
+	virtual void share(SharedState *shared);
+	virtual void scenario(Scenario *scenario);
+	virtual void log_checksums(FILE *log);
+	virtual unsigned int checksum();
+	virtual void capture_state(SaveHeader &header, vector<ObjectRecord> &records);
+protected:
+	virtual void run();
+	virtual void process_input();
+	virtual void animate(double t);
+	virtual void publish();
+	virtual void capture(Snapshot &snap);
+	virtual void record_frame();
+	virtual void share_frame();
+	virtual void checksum_frame();
+	virtual void send_effects();
+	virtual void start_game();
+	virtual void schedule();
+	virtual void cleanup();
+private:
+	static void thread_main(void *world);
+	void save_header(SaveHeader &h);
+	WorldState state_;
+	Thread thread_;
+	volatile long running_;
+	InputQueue input_;
+	Recorder *recorder_;   ///< writes every simulated frame, 0 if not recording
+	SharedState *shared_;  ///< publishes every simulated frame, 0 if not sharing
+	Scenario *scenario_;   ///< spawns the enemies, 0 to spawn them at random
+	double scenario_start_; ///< game time the game, or the scenario if attached later, was started at
+	Scenario *own_scenario_; ///< the copy of another World's Scenario made by clone(), 0 if none
+	Snapshot shared_frame_; ///< the frame being published to shared_
+	FILE *checksum_log_;   ///< gets a checksum after every update, 0 if not logging
+	vector<ObjectRecord> checksum_records_;
+	TripleBuffer<Snapshot> snapshots_;
+	SpscQueue<EffectState, EFFECT_QUEUE_SIZE> effects_;
+	int gamestate_;
+	int score_;
+	int level_;
+	unsigned long frame_;
+	double time_;          ///< seconds of game time played
+	double next_ufo_;      ///< game time of the next UFO spawn
+	double next_missile_;  ///< game time of the next missile spawn
+	int spawn_level_;      ///< level the spawn times were drawn for, 0 if not drawn yet
+	double animate_time_;
+};
+
+#endif
@@ -0,0 +1,150 @@
+/** \file WorldState.cpp
+ * \brief Code implementation for WorldState and StateScope classes
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "WorldState.h"
+
+#include <math.h>
+
+#include "thread.h"
+#include "random.h"
+
+/** \brief The WorldState used by threads that have not chosen one.
+ */
+static WorldState default_state;
+
+/** \brief The current WorldState of each thread, 0 for default_state.
+ */
+static THREAD_LOCAL WorldState *current_state = 0;
+
+/** \brief Constructor for GameParams.
+ *
+ * The constructor sets every parameter to its default.
+ */
+GameParams::GameParams()
+{
+	level_scale_base = LEVEL_SCALE_BASE;
+	level_scale_step = LEVEL_SCALE_STEP;
+	ufo_spawn_factor = UFO_SPAWN_FACTOR;
+	missile_spawn_factor = MISSILE_SPAWN_FACTOR;
+	ufo_fire_rate = UFO_FIRE_RATE;
+	max_missiles = MAX_MISSILES;
+	max_shells = MAX_SHELLS;
+	use_kill_mask = true;
+	use_spatial_sort = true;
+}
+
+/** \brief A function to return how much harder a level is than the first.
+ *
+ * Spawn and fire rates and enemy velocities are multiplied by this.
+ * \param level The level.
+ * \return Returns the scale factor.
+ */
+double GameParams::level_scale(int level) const
+{
+	return level_scale_base + level*level_scale_step;
+}
+
+/** \brief A function to return the average time between random events.
+ *
+ * \param factor The spawn factor or fire rate of the event.
+ * \param level The level.
+ * \return Returns the average number of seconds between events, which is
+ *	HUGE_VAL if the level scale is not positive so the event never happens.
+ */
+double GameParams::interval(double factor, int level) const
+{
+	double rate = FPS*level_scale(level)/factor;
+	return (rate > 0) ? 1/rate : HUGE_VAL;
+}
+
+/** \brief A function to switch off every optimised way of running the rules.
+ *
+ * The game is then run by the straightforward reference code, such as the
+ * brute force collision loops, which fsd-sim --diff compares the optimised
+ * code against.
+ */
+void GameParams::reference()
+{
+	use_kill_mask = false;
+	use_spatial_sort = false;
+}
+
+/** \brief Constructor for WorldState.
+ *
+ * The new state is empty and its random number generator has the same fixed
+ * seed as every other new state until game_srand() is called. The registries
+ * and buffers reserve room for WORLD_RESERVE objects up front so that they do
+ * not keep growing during play.
+ */
+WorldState::WorldState()
+{
+	bases.reserve(WORLD_RESERVE);
+	guns.reserve(WORLD_RESERVE);
+	playeritems.reserve(WORLD_RESERVE);
+	projectiles.reserve(WORLD_RESERVE);
+	enemyitems.reserve(WORLD_RESERVE);
+	missiles.reserve(WORLD_RESERVE);
+	ufos.reserve(WORLD_RESERVE);
+	shells.reserve(WORLD_RESERVE);
+	explosions.reserve(WORLD_RESERVE);
+	shellexplosions.reserve(WORLD_RESERVE);
+	handle_slots.reserve(WORLD_RESERVE);
+	commands.reserve(WORLD_RESERVE);
+	effects.reserve(WORLD_RESERVE);
+	handle_free_head = 0;
+	handle_free_tail = 0;
+	for (int i = 0; i < COMMAND_TYPES; i++)
+	{
+		pending[i] = 0;
+	}
+	rand_state = GAME_RAND_SEED;
+	shells_fired = 0;
+	missiles_killed = 0;
+	scripted = false;
+}
+
+/** \brief Destructor for WorldState.
+ */
+WorldState::~WorldState()
+{
+}
+
+/** \brief A function to get this thread's current WorldState.
+ *
+ * \return Returns the current WorldState.
+ */
+WorldState& WorldState::current()
+{
+	return current_state ? *current_state : default_state;
+}
+
+/** \brief A function to set this thread's current WorldState.
+ *
+ * \param state The new current WorldState, or 0 for the default one.
+ */
+void WorldState::current(WorldState *state)
+{
+	current_state = (state == &default_state) ? 0 : state;
+}
+
+/** \brief Constructor for StateScope.
+ *
+ * \param state The WorldState to make current.
+ */
+StateScope::StateScope(WorldState *state)
+{
+	previous_ = &WorldState::current();
+	WorldState::current(state);
+}
+
+/** \brief Destructor for StateScope.
+ *
+ * The destructor makes the previous WorldState current again.
+ */
+StateScope::~StateScope()
+{
+	WorldState::current(previous_);
+}
@@ -0,0 +1,127 @@
+/** \file WorldState.h
+ * \brief Header file for WorldState class
+ *
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef WORLDSTATE_H
+#define WORLDSTATE_H
+
+#include "enum.h"
+#include "Handle.h"
+#include "CommandBuffer.h"
+#include "ObjectPool.h"
+#include "KillMask.h"
+#include "SpatialSort.h"
+#include "Snapshot.h"
+
+class Base;
+class Gun;
+class PlayerItem;
+class Projectile;
+class EnemyItem;
+class Missile;
+class UFO;
+class Shell;
+class Explosion;
+class ShellExplosion;
+
+/** \brief Tunable game parameters.
+ *
+ * The constructor fills in the defaults from enum.h. The spawn factors and
+ * fire rate were tuned as the odds of an event on each update at FPS, and
+ * are still given that way, but events are now timed by interval() so they
+ * happen just as often whatever the update rate.
+ *
+ * The use_ switches choose optimised ways of running the rules. Each must
+ * play exactly the same game as the straightforward code it replaces, which
+ * is kept as the reference that reference() switches back to.
+ */
+struct GameParams
+{
+	GameParams();
+	double level_scale(int level) const;
+	double interval(double factor, int level) const;
+	void reference();
+
+	double level_scale_base;
+	double level_scale_step;
+	double ufo_spawn_factor;      ///< average updates at FPS between UFOs on the first level
+	double missile_spawn_factor;  ///< average updates at FPS between missiles on the first level
+	double ufo_fire_rate;         ///< average updates at FPS between each UFO's missiles
+	unsigned int max_missiles;
+	unsigned int max_shells;
+	bool use_kill_mask;           ///< find explosion kills with the KillMask
+	bool use_spatial_sort;        ///< keep the enemies in order of position with the SpatialSort
+};
+
+/** \brief The WorldState class.
+ *
+ * The WorldState class holds everything that used to be global to the game:
+ * the registries behind Base::bases() and the other accessors, the
+ * HandleTable, the CommandBuffer, the random number generator, the game
+ * parameters, the statistics the rules keep as they run, the pool the
+ * objects are allocated from, the KillMask, the SpatialSort, the effects
+ * reported by the current update and whether the enemies are scripted.
+ * Each thread has a current WorldState, which is what those static
+ * functions use, so several worlds can exist at once and be simulated on
+ * different threads. Threads that never choose one share a default WorldState.
+ *
+ * The WorldState does not own the objects in it. Objects must be created and
+ * deleted while their WorldState is current.
+ */
+class WorldState
+{
+public:
+	WorldState();
+	virtual ~WorldState();
+
+	static WorldState& current();
+	static void current(WorldState *state);
+
+	vector<Base*> bases;
+	vector<Gun*> guns;
+	vector<PlayerItem*> playeritems;
+	vector<Projectile*> projectiles;
+	vector<EnemyItem*> enemyitems;
+	vector<Missile*> missiles;
+	vector<UFO*> ufos;
+	vector<Shell*> shells;
+	vector<Explosion*> explosions;
+	vector<ShellExplosion*> shellexplosions;
+
+	ObjectPool pool;
+	KillMask kill_mask;
+	SpatialSort spatial_sort;
+
+	vector<HandleSlot> handle_slots;
+	unsigned int handle_free_head; ///< oldest free handle slot, 0 if none
+	unsigned int handle_free_tail; ///< newest free handle slot, 0 if none
+
+	vector<Command> commands;
+	int pending[COMMAND_TYPES];
+	vector<EffectState> effects;
+
+	unsigned int rand_state;
+
+	GameParams params;
+	unsigned long shells_fired;
+	unsigned long missiles_killed; ///< missiles destroyed by shell explosions
+	bool scripted;                 ///< enemies come from a Scenario, so UFOs do not fire by themselves
+};
+
+/** \brief The StateScope class.
+ *
+ * Makes a WorldState current on this thread for as long as the StateScope
+ * exists, then restores the previous one.
+ */
+class StateScope
+{
+public:
+	StateScope(WorldState *state);
+	virtual ~StateScope();
+private:
+	WorldState *previous_;
+};
+
+#endif
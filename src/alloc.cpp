@@ -0,0 +1,241 @@
+/** \file alloc.cpp
+ * \brief Code implementation for the allocation counting functions.
+ *
+ * Each thread claims one of ALLOC_MAX_THREADS sets of counters on its first
+ * allocation and is the only thread that writes to them, so counting takes
+ * no locks. The counters live in static storage rather than thread local
+ * storage so they can still be reported after the thread has finished.
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifdef ALLOC_STATS
+
+#include "alloc.h"
+
+#include <stdlib.h>
+#include <new>
+
+#include "enum.h"
+#include "thread.h"
+
+/** \brief The allocation counters of one thread.
+ */
+struct AllocStats
+{
+	volatile long count;          ///< allocations
+	volatile long bytes;          ///< bytes requested
+	long frames;                  ///< calls to alloc_frame()
+	long frames_allocating;       ///< frames with at least one allocation
+	long worst_frame;             ///< most allocations in one frame
+	long worst_frame_bytes;       ///< most bytes requested in one frame
+	long frame_start;             ///< count at the start of this frame
+	long frame_start_bytes;       ///< bytes at the start of this frame
+	const char *tags[ALLOC_MAX_TAGS];
+	long tag_count[ALLOC_MAX_TAGS];
+	long tag_bytes[ALLOC_MAX_TAGS];
+	int tag_total;
+};
+
+/** \brief The counters of every thread, claimed in order.
+ */
+static AllocStats stats[ALLOC_MAX_THREADS];
+
+/** \brief Number of sets of counters claimed so far, which may exceed ALLOC_MAX_THREADS.
+ */
+static volatile long claimed = 0;
+
+/** \brief This thread's counters, 0 before its first allocation.
+ */
+static THREAD_LOCAL AllocStats *thread_stats = 0;
+
+/** \brief Set on threads that found no free counters.
+ */
+static THREAD_LOCAL bool uncounted = false;
+
+/** \brief This thread's current tag.
+ */
+static THREAD_LOCAL const char *current_tag = 0;
+
+/** \brief Function to get this thread's counters, claiming some if needed.
+ *
+ * \return Returns the counters, or 0 if every set has been claimed.
+ */
+static AllocStats* counters()
+{
+	if (thread_stats || uncounted)
+	{
+		return thread_stats;
+	}
+	long index = atomic_increment(&claimed) - 1;
+	if (index >= ALLOC_MAX_THREADS)
+	{
+		uncounted = true;
+		return 0;
+	}
+	thread_stats = &stats[index];
+	return thread_stats;
+}
+
+/** \brief Function to count an allocation.
+ *
+ * \param size The number of bytes requested.
+ */
+static void count(size_t size)
+{
+	AllocStats *s = counters();
+	if (!s)
+	{
+		return;
+	}
+	atomic_store(&s->count, s->count + 1);
+	atomic_store(&s->bytes, s->bytes + (long)size);
+	const char *tag = current_tag ? current_tag : "untagged";
+	int i = 0;
+	while ((i < s->tag_total) && (s->tags[i] != tag))
+	{
+		i++;
+	}
+	if (i == s->tag_total)
+	{
+		if (s->tag_total == ALLOC_MAX_TAGS)
+		{
+			return;
+		}
+		s->tags[i] = tag;
+		s->tag_count[i] = 0;
+		s->tag_bytes[i] = 0;
+		s->tag_total++;
+	}
+	s->tag_count[i]++;
+	s->tag_bytes[i] += (long)size;
+}
+
+/** \brief Replacement global allocation function that counts allocations.
+ */
+void* operator new(size_t size) throw(std::bad_alloc)
+{
+	count(size);
+	void *p = malloc(size ? size : 1);
+	if (!p)
+	{
+		throw std::bad_alloc();
+	}
+	return p;
+}
+
+/** \brief Replacement global array allocation function that counts allocations.
+ */
+void* operator new[](size_t size) throw(std::bad_alloc)
+{
+	return operator new(size);
+}
+
+/** \brief Replacement global deallocation function.
+ */
+void operator delete(void *p) throw()
+{
+	free(p);
+}
+
+/** \brief Replacement global array deallocation function.
+ */
+void operator delete[](void *p) throw()
+{
+	free(p);
+}
+
+/** \brief Function to return the number of allocations made by the calling thread.
+ *
+ * \return Returns the number of allocations so far.
+ */
+long alloc_count()
+{
+	AllocStats *s = counters();
+	return s ? s->count : 0;
+}
+
+/** \brief Function to change the calling thread's tag.
+ *
+ * \param name The tag, a string literal.
+ */
+void alloc_phase(const char *name)
+{
+	current_tag = name;
+}
+
+/** \brief Function to mark the end of a frame on the calling thread.
+ *
+ * The allocations and bytes since the previous call are counted towards
+ * the frame totals in the report.
+ */
+void alloc_frame()
+{
+	AllocStats *s = counters();
+	if (!s)
+	{
+		return;
+	}
+	long n = s->count - s->frame_start;
+	s->frames++;
+	if (n > 0)
+	{
+		s->frames_allocating++;
+	}
+	if (n > s->worst_frame)
+	{
+		s->worst_frame = n;
+	}
+	long bytes = s->bytes - s->frame_start_bytes;
+	if (bytes > s->worst_frame_bytes)
+	{
+		s->worst_frame_bytes = bytes;
+	}
+	s->frame_start = s->count;
+	s->frame_start_bytes = s->bytes;
+}
+
+/** \brief Function to write the counters of every thread.
+ *
+ * The per tag and per frame figures of a thread are only exact if the
+ * thread has finished or is the calling thread.
+ * \param file The file to write to.
+ */
+void alloc_report(FILE *file)
+{
+	long threads = atomic_load(&claimed);
+	for (long t = 0; (t < threads) && (t < ALLOC_MAX_THREADS); t++)
+	{
+		AllocStats &s = stats[t];
+		fprintf(file, "thread %ld: %ld allocations, %ld bytes", t + 1, atomic_load(&s.count), atomic_load(&s.bytes));
+		if (s.frames > 0)
+		{
+			fprintf(file, ", %.2f allocations and %.1f bytes per frame over %ld frames, %ld frames allocated,"
+				" most in one frame %ld allocations and %ld bytes", (double)s.count/s.frames, (double)s.bytes/s.frames,
+				s.frames, s.frames_allocating, s.worst_frame, s.worst_frame_bytes);
+		}
+		fprintf(file, "\n");
+		for (int i = 0; i < s.tag_total; i++)
+		{
+			fprintf(file, "\t%-16s %8ld allocations %10ld bytes\n", s.tags[i], s.tag_count[i], s.tag_bytes[i]);
+		}
+	}
+}
+
+/** \brief Constructor for AllocTag.
+ *
+ * \param name The tag, a string literal.
+ */
+AllocTag::AllocTag(const char *name)
+{
+	previous_ = current_tag;
+	current_tag = name;
+}
+
+/** \brief Destructor for AllocTag.
+ */
+AllocTag::~AllocTag()
+{
+	current_tag = previous_;
+}
+
+#endif
@@ -0,0 +1,52 @@
+/** \file alloc.h
+ * \brief Header file for the allocation counting functions.
+ *
+ * When ALLOC_STATS is defined the global operator new is replaced by one
+ * that counts every heap allocation and the bytes requested, per thread and
+ * per tag. A tag is a string literal naming what the thread is doing, such
+ * as a phase of the update or the type of object being created. ALLOC_TAG
+ * sets the tag for the rest of the enclosing scope and ALLOC_PHASE changes
+ * it until the next ALLOC_PHASE or the end of that scope. ALLOC_FRAME marks
+ * the end of a frame. Otherwise the macros below do nothing.
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef ALLOC_H
+#define ALLOC_H
+
+#include <stdio.h>
+
+#ifdef ALLOC_STATS
+#define ALLOC_TAG(name) AllocTag alloc_tag(name)
+#define ALLOC_PHASE(name) alloc_phase(name)
+#define ALLOC_FRAME() alloc_frame()
+#define ALLOC_REPORT(file) alloc_report(file)
+#else
+#define ALLOC_TAG(name)
+#define ALLOC_PHASE(name)
+#define ALLOC_FRAME()
+#define ALLOC_REPORT(file)
+#endif
+
+#ifdef ALLOC_STATS
+long alloc_count();
+void alloc_phase(const char *name);
+void alloc_frame();
+void alloc_report(FILE *file);
+
+/** \brief The AllocTag class.
+ *
+ * Sets the calling thread's tag while it exists and restores the previous
+ * tag afterwards.
+ */
+class AllocTag
+{
+public:
+	AllocTag(const char *name);
+	~AllocTag();
+private:
+	const char *previous_;
+};
+#endif
+
+#endif
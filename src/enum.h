@@ -17,17 +17,48 @@
 #define M_PI 3.14159265358979323846
 #endif
 
+//Build options (define in the project settings)
+// DEBUG       draw collision radii and log object deletion
+// FIXED_POINT store positions, velocities and radii in 16.16 fixed point so
+//             the simulation is bit-identical on every build (see fixed.h)
+// TRACE       record the phases of each update and draw and write them to
+//             TRACE_FILE on exit (see trace.h)
+// ALLOC_STATS count heap allocations per thread, phase and object type and
+//             report them on exit (see alloc.h)
+
 //Basic Window values
 #define FPS 60.0
 #define TIMESCALE 1.0
 #define TIMESTEP TIMESCALE/FPS
-#define WIN_WIDTH 800
-#define WIN_HEIGHT 600
+// Positions and sizes in the game are in world units. The Window maps the
+// world onto however many pixels it has, so the window size and render
+// resolution never change how the game plays.
+#define WORLD_WIDTH 800
+#define WORLD_HEIGHT 600
 #define GROUND_HEIGHT 60
+#define WIN_WIDTH WORLD_WIDTH // initial window size in pixels
+#define WIN_HEIGHT WORLD_HEIGHT
+#define RENDER_SCALE 1.0 // default render resolution as a fraction of the window's
 #define TIMER_CALLBACK 65535
 #define SEPARATION 200
+#define TEXT_LENGTH 64 // longest message drawn in the window, including the terminator
+#define MAX_CATCHUP 15 // most simulation steps run at once when behind real time
+#define INPUT_QUEUE_SIZE 256 // must be a power of two
+#define SAVE_FILE "fsd.state" // F5 saves the game here, F9 loads it
+#define TRACE_FILE "fsd.trace.json"
+#define TRACE_BUFFER_EVENTS (1 << 20) // events each thread can record
+#define TRACE_MAX_THREADS 16
+#define ALLOC_MAX_THREADS 16
+#define ALLOC_MAX_TAGS 32 // distinct tags counted per thread
+#define ALLOC_WARMUP 60.0 // seconds of game time before fsd-sim --zero-alloc expects no allocations
+#define POOL_GRANULE 16 // bytes, object sizes are rounded up to a multiple of this
+#define POOL_SIZE_CLASSES 16
+#define POOL_CHUNK_OBJECTS 64 // objects taken from the heap at once
+#define WORLD_RESERVE 256 // objects of each kind a world has room for before its registries grow
 
 //Window
+// The spawn factors, caps and level scaling are only defaults; each world
+// reads them from its GameParams so they can be changed at run time.
 #define MAX_BASES 10
 #define MAX_GUNS 5
 #define MAX_SHELLS 20
@@ -42,7 +73,57 @@
 //Game state
 enum {INITIALISE = 0,NORMAL, GAMEOVER, PAUSED};
 #define SCORE_NEXT_LEVEL 20
-#define LEVEL_SCALE (0.8 + level*0.2)
+#define LEVEL_SCALE_BASE 0.8 // difficulty scale is LEVEL_SCALE_BASE + level*LEVEL_SCALE_STEP
+#define LEVEL_SCALE_STEP 0.2
+
+//Level of detail
+// Counts are scaled by how crowded the screen is, so a smaller window
+// switches to less detail sooner. The simulation is never affected.
+enum {DETAIL_FULL = 0, DETAIL_REDUCED, DETAIL_MINIMAL};
+#define LOD_MISSILE_TAILS 200 // missiles before trails are drawn as short tails
+#define LOD_MISSILE_POINTS 2000 // missiles before they are drawn as points
+#define LOD_MISSILE_TAIL_LENGTH 15.0
+#define LOD_EXPLOSION_MERGE 48 // visible explosions before they are merged
+#define LOD_EXPLOSION_CELL 4 // size in world units of the grid merged explosions are drawn on
+#define LOD_UFO_SIMPLE 50 // UFOs before they are drawn as plain shapes
+
+//Governor
+#define FRAME_BUDGET (1/FPS) // seconds of drawing and simulation per frame
+#define QUALITY_MAX 4
+#define GOVERNOR_SMOOTHING 0.1 // weight of the newest frame in the average cost
+#define GOVERNOR_DOWN_FRAMES 10 // frames over budget before dropping quality
+#define GOVERNOR_UP_FRAMES 120 // frames well under budget before raising quality
+#define GOVERNOR_UP_FRACTION 0.7 // "well under" budget
+#define GOVERNOR_HUD_INTERVAL 15 // frames between HUD updates at the lowest quality
+
+//Recording
+enum {RECORD_PPM = 0, RECORD_RAW};
+#define RECORD_QUEUE_SIZE 16 // frames waiting to be encoded, must be a power of two
+#define RECORD_POLL 0.001 // seconds the encoder sleeps when it has nothing to do
+
+//Particles
+// Effects are what the game reports for drawing, particles how they are drawn.
+enum {EFFECT_FLASH = 0, EFFECT_DEBRIS, EFFECT_IMPACT};
+enum {PARTICLE_SPARK = 0, PARTICLE_DEBRIS, PARTICLE_SMOKE, PARTICLE_KINDS};
+#define EFFECT_QUEUE_SIZE 1024 // effects waiting to be drawn, must be a power of two
+#define PARTICLE_CAPACITY 131072 // particles alive at once, more are not spawned
+#define PARTICLE_GRAVITY 300.0 // world units per second squared
+#define PARTICLE_SHADES 4 // colours each kind of particle fades through
+
+//Shared memory
+enum {SHARED_BASE = 0, SHARED_GUN, SHARED_MISSILE, SHARED_UFO, SHARED_SHELL, SHARED_EXPLOSION};
+#define SHARED_MAGIC 0x4d485346 // "FSHM" in a little endian int
+#define SHARED_VERSION 2
+#define SHARED_SLOTS 8 // frames kept in the ring
+#define SHARED_ENTITIES 4096 // entities per frame, more are counted but not written
+#define SHARED_POLL 1.0 // seconds between lines printed by fsd-sim --watch
+
+//Software rendering
+#define TILE_SIZE 64 // pixels across and down each tile drawn by a TileCanvas thread
+#define SPAN_CACHE_SIZE 256 // sizes of pie a SoftCanvas keeps the row spans of
+
+//Scenarios
+#define SCENARIO_CHUNK 4096 // spawns read from a scenario file at once
 
 //Gun
 #define BARREL_WIDTH 10
@@ -52,13 +133,20 @@ enum {INITIALISE = 0,NORMAL, GAMEOVER, PAUSED};
 //Shell
 #define SHELL_VELOCITY 1500.0
 #define SHELL_BLAST_FACTOR 8
-#define SCATTER_FACTOR(width) (rand()%(int)width*SHELL_BLAST_FACTOR - width*SHELL_BLAST_FACTOR/2)
+#define SCATTER_FACTOR(width) (game_rand()%(int)width*SHELL_BLAST_FACTOR - width*SHELL_BLAST_FACTOR/2)
 
 //ShellExplode
 #define SE_INITIAL_PERIOD 0.1
+#define KILL_MASK_CELL 16 // size in world units of the grid explosions are marked on for collisions
+#define KILL_MASK_MARGIN UFO_RADIUS // largest EnemyItem radius the mask answers for
+#define KILL_MASK_RESERVE 4096 // explosion edge cells the mask has room for before it grows
+#define SPATIAL_SORT_INTERVAL 30 // updates between sorts of the enemies by position
+#define SPATIAL_SORT_CELL 8 // size in world units of the grid enemies are sorted on
+#define SPATIAL_SORT_DISORDER 16 // the enemies are not re-sorted while fewer than one in this many neighbours are out of order
+#define SPATIAL_SORT_STEPS 8 // updates the enemies are moved into order over after a sort, fewer than SPATIAL_SORT_INTERVAL
 
 //Missile
-#define MISSILE_VELOCITY (((rand()%100+50)+(rand()%100+50)+(rand()%100+50))/3) //Approximate gaussian probability
+#define MISSILE_VELOCITY (((game_rand()%100+50)+(game_rand()%100+50)+(game_rand()%100+50))/3) //Approximate gaussian probability
 #define MISSILE_SPAWN_FACTOR 50 // The higher the number, the less often the missiles spawn
 
 //UFO
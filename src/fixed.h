@@ -0,0 +1,98 @@
+/** \file fixed.h
+ * \brief Header file for fixed point arithmetic.
+ *
+ * When FIXED_POINT is defined, positions, velocities and collision radii are
+ * stored as 16.16 fixed point integers instead of doubles, and collision tests
+ * compare integer squared distances. Integer arithmetic gives bit-identical
+ * results whatever the compiler, its floating point flags or vector width.
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef FIXED_H
+#define FIXED_H
+
+#include <math.h>
+
+#ifdef _MSC_VER
+typedef __int64 fixed_wide_t;
+#else
+typedef long long fixed_wide_t;
+#endif
+
+/** \brief A 16.16 fixed point number.
+ */
+typedef int fixed_t;
+
+/** \brief The product of two fixed_t values, or a squared fixed_t distance, in 32.32 fixed point.
+ */
+typedef fixed_wide_t fixed_sq_t;
+
+#define FIXED_SHIFT 16
+#define FIXED_ONE (1 << FIXED_SHIFT)
+
+/** \brief Convert a double to fixed point, rounding to nearest.
+ *
+ * \param d The value to convert.
+ * \return Returns the fixed point value.
+ */
+inline fixed_t to_fixed(double d)
+{
+	return (fixed_t)floor(d*FIXED_ONE + 0.5);
+}
+
+/** \brief Convert a fixed point value to a double.
+ *
+ * The conversion is exact.
+ * \param f The value to convert.
+ * \return Returns the value as a double.
+ */
+inline double from_fixed(fixed_t f)
+{
+	return f/(double)FIXED_ONE;
+}
+
+/** \brief Multiply two fixed point values.
+ *
+ * \param a First value.
+ * \param b Second value.
+ * \return Returns a*b, rounded towards negative infinity.
+ */
+inline fixed_t fixed_mul(fixed_t a, fixed_t b)
+{
+	return (fixed_t)(((fixed_wide_t)a*b) >> FIXED_SHIFT);
+}
+
+/** \brief Integer square root.
+ *
+ * \param n The value to take the square root of.
+ * \return Returns the largest integer r with r*r <= n.
+ */
+inline fixed_wide_t isqrt(fixed_wide_t n)
+{
+	if (n <= 0)
+	{
+		return 0;
+	}
+	fixed_wide_t r = 0;
+	fixed_wide_t bit = (fixed_wide_t)1 << 62;
+	while (bit > n)
+	{
+		bit >>= 2;
+	}
+	while (bit != 0)
+	{
+		if (n >= r + bit)
+		{
+			n = n - (r + bit);
+			r = (r >> 1) + bit;
+		}
+		else
+		{
+			r >>= 1;
+		}
+		bit >>= 2;
+	}
+	return r;
+}
+
+#endif
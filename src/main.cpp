@@ -6,18 +6,183 @@
  */
 #include <Fl/Fl.H>
 #include <stdlib.h>
+#include <stdio.h>
+#include <string.h>
 
 #include "Window.h"
+#include "Recorder.h"
+#include "SharedState.h"
+#include "Scenario.h"
+#include "trace.h"
+#include "alloc.h"
 
 void timer_callback(void*);
 
+/** \brief The render resolution chosen on the command line.
+ */
+static double render_scale = RENDER_SCALE;
+
+/** \brief The frame time budget chosen on the command line, in seconds.
+ */
+static double frame_budget = FRAME_BUDGET;
+
+/** \brief Where to record frames to, 0 if not recording.
+ */
+static const char *record_path = 0;
+
+/** \brief The recording format chosen on the command line.
+ */
+static int record_format = RECORD_PPM;
+
+/** \brief The recorded frame size chosen on the command line.
+ */
+static double record_scale = 1;
+
+/** \brief The number of threads to draw recorded frames with.
+ */
+static int record_threads = 1;
+
+/** \brief The name of the shared memory to publish frames to, 0 if not sharing.
+ */
+static const char *shm_name = 0;
+
+/** \brief The scenario to script the enemies with, 0 for random enemies.
+ */
+static const char *scenario_path = 0;
+
+/** \brief Command line option handler.
+ *
+ * This function handles the options FLTK does not know about:
+ * -render-scale, the render resolution as a fraction of the window's,
+ * -frame-budget, the milliseconds a frame may take before the drawing
+ * quality is lowered, as described for Governor,
+ * -record, the file name pattern or file to record every frame to,
+ * -record-format, ppm or raw, and -record-scale, the size of the recorded
+ * frames as a fraction of the world's, and -record-threads, the number of
+ * threads to draw them with. See Recorder for the formats.
+ * -shm, the name of shared memory to publish every frame to for other
+ * processes, as described for SharedState.
+ * -scenario, a file of scripted enemies to play instead of random ones, as
+ * described for Scenario.
+ * \param argc The number of arguments.
+ * \param argv The arguments.
+ * \param i The index of the argument to handle, moved past what is used.
+ * \return Returns the number of arguments used, 0 if it is not an option.
+ */
+static int arg(int argc, char **argv, int &i)
+{
+	if (i + 1 >= argc)
+	{
+		return 0;
+	}
+	const char *value = argv[i + 1];
+	if ((strcmp(argv[i], "-render-scale") == 0) && (atof(value) > 0))
+	{
+		render_scale = atof(value);
+	}
+	else if ((strcmp(argv[i], "-frame-budget") == 0) && (atof(value) > 0))
+	{
+		frame_budget = atof(value)/1000;
+	}
+	else if (strcmp(argv[i], "-record") == 0)
+	{
+		record_path = value;
+	}
+	else if ((strcmp(argv[i], "-record-format") == 0) && ((strcmp(value, "ppm") == 0) || (strcmp(value, "raw") == 0)))
+	{
+		record_format = (strcmp(value, "raw") == 0) ? RECORD_RAW : RECORD_PPM;
+	}
+	else if ((strcmp(argv[i], "-record-scale") == 0) && (atof(value) > 0))
+	{
+		record_scale = atof(value);
+	}
+	else if ((strcmp(argv[i], "-record-threads") == 0) && (atoi(value) > 0))
+	{
+		record_threads = atoi(value);
+	}
+	else if (strcmp(argv[i], "-shm") == 0)
+	{
+		shm_name = value;
+	}
+	else if (strcmp(argv[i], "-scenario") == 0)
+	{
+		scenario_path = value;
+	}
+	else
+	{
+		return 0;
+	}
+	i += 2;
+	return 2;
+}
+
 /** \brief Program entry point.
  */
 int main (int argc, char **argv) {
+	TRACE_THREAD("fltk");
+	int i;
+	if (Fl::args(argc, argv, i, arg) < argc)
+	{
+		fprintf(stderr, "usage: %s [-render-scale SCALE] [-frame-budget MS]\n"
+			"\t[-record PATTERN|FILE] [-record-format ppm|raw] [-record-scale SCALE]\n"
+			"\t[-record-threads N] [-shm NAME] [-scenario FILE]\n%s", argv[0], Fl::help);
+		return 1;
+	}
+	Recorder recorder;
+	if (record_path && !recorder.open(record_path, record_format, record_scale, false, record_threads))
+	{
+		fprintf(stderr, "%s: cannot record to %s\n", argv[0], record_path);
+		return 1;
+	}
+	SharedState shared;
+	if (shm_name && !shared.create(shm_name))
+	{
+		fprintf(stderr, "%s: cannot create shared memory %s\n", argv[0], shm_name);
+		return 1;
+	}
+	Scenario scenario;
+	if (scenario_path && !scenario.open(scenario_path))
+	{
+		fprintf(stderr, "%s: cannot read scenario %s\n", argv[0], scenario_path);
+		return 1;
+	}
 	Window win(WIN_WIDTH, WIN_HEIGHT, "Flying String Defence");
+	win.render_scale(render_scale);
+	win.frame_budget(frame_budget);
+	if (record_path)
+	{
+		win.record(&recorder);
+	}
+	if (shm_name)
+	{
+		win.share(&shared);
+	}
+	if (scenario_path)
+	{
+		win.scenario(&scenario);
+	}
 	Fl::add_timeout(1/FPS, timer_callback);
 	win.show(argc, argv);
-	return Fl::run();
+	int ret = Fl::run();
+	if (scenario_path)
+	{
+		win.scenario(0);
+	}
+	if (shm_name)
+	{
+		win.share(0);
+		shared.close();
+	}
+	if (record_path)
+	{
+		win.record(0);
+		recorder.close();
+		fprintf(stderr, "%s: recorded %lu frames of %dx%d, dropped %lu%s\n", argv[0], recorder.written(),
+			recorder.width(), recorder.height(), recorder.dropped(), recorder.failed() ? ", writing failed" : "");
+	}
+	TRACE_DUMP(TRACE_FILE);
+	ALLOC_REPORT(stderr);
+	return ret;
 }
 
 /** \brief Timer callback to create timed events.
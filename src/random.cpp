@@ -0,0 +1,78 @@
+/** \file random.cpp
+ * \brief Code implementation for the game's random number generator.
+ *
+ * The game uses its own xorshift generator instead of rand() so that its state
+ * is a single number that can be saved, restored and seeded explicitly, and so
+ * the sequence is the same on every platform. The state, which is never zero,
+ * belongs to the current WorldState.
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "random.h"
+
+#include <math.h>
+
+#include "WorldState.h"
+
+/** \brief Function to seed the generator.
+ *
+ * \param seed The seed. Any value is allowed.
+ */
+void game_srand(unsigned int seed)
+{
+	// mix the seed so that nearby seeds give unrelated sequences
+	seed = (seed ^ 61) ^ (seed >> 16);
+	seed = seed + (seed << 3);
+	seed = seed ^ (seed >> 4);
+	seed = seed*0x27d4eb2d;
+	seed = seed ^ (seed >> 15);
+	WorldState::current().rand_state = (seed == 0) ? GAME_RAND_SEED : seed;
+}
+
+/** \brief Function to return the next random number.
+ *
+ * \return Returns a number from 0 to GAME_RAND_MAX.
+ */
+int game_rand()
+{
+	unsigned int &state = WorldState::current().rand_state;
+	unsigned int x = state;
+	x = x ^ (x << 13);
+	x = x ^ (x >> 17);
+	x = x ^ (x << 5);
+	state = x;
+	return (int)(x >> 1);
+}
+
+/** \brief Function to return the time until the next event of a Poisson process.
+ *
+ * The gaps between the events of a Poisson process are exponentially
+ * distributed, so a process can be run by drawing each event's time when the
+ * previous one happens instead of rolling a die every update.
+ * \param mean The average time between events.
+ * \return Returns a time greater than zero if mean is greater than zero.
+ */
+double game_rand_exponential(double mean)
+{
+	// uniform in (0, 1) so the logarithm is finite and never zero
+	double u = (game_rand() + 0.5)/(GAME_RAND_MAX + 1.0);
+	return -mean*log(u);
+}
+
+/** \brief Function to read the generator state.
+ *
+ * \return Returns the state, which can be passed back to game_rand_state(unsigned int).
+ */
+unsigned int game_rand_state()
+{
+	return WorldState::current().rand_state;
+}
+
+/** \brief Function to restore the generator state.
+ *
+ * \param state A state previously returned by game_rand_state().
+ */
+void game_rand_state(unsigned int state)
+{
+	WorldState::current().rand_state = (state == 0) ? GAME_RAND_SEED : state;
+}
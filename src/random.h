@@ -0,0 +1,22 @@
+/** \file random.h
+ * \brief Header file for the game's random number generator.
+ *
+ * The game uses its own xorshift generator instead of rand() so that its state
+ * is a single number that can be saved, restored and seeded explicitly, and so
+ * the sequence is the same on every platform.
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef RANDOM_H
+#define RANDOM_H
+
+#define GAME_RAND_MAX 0x7fffffff
+#define GAME_RAND_SEED 2463534242u // state before game_srand() is called
+
+void game_srand(unsigned int seed);
+int game_rand();
+double game_rand_exponential(double mean);
+unsigned int game_rand_state();
+void game_rand_state(unsigned int state);
+
+#endif
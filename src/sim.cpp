@@ -0,0 +1,1181 @@
+/** \file sim.cpp
+ * \brief Main file for the fsd-sim batch runner
+ *
+ * fsd-sim plays games without a window as fast as the machine allows. Each
+ * game has its own seed, an automated player and optionally changed game
+ * parameters, and the games are shared out between a number of threads. One
+ * result row is written per game, in game order, as CSV or as JSON lines.
+ *
+ * Usage: fsd-sim [--games N] [--seed S] [--threads N] [--policy idle|random|greedy]
+ *	[--max-time SECONDS] [--tick-rate HZ] [--format csv|json] [--output FILE]
+ *	[--param NAME=VALUE]... [--zero-alloc]
+ *	[--record PATTERN|FILE] [--record-format ppm|raw] [--record-scale SCALE]
+ *	[--record-threads N] [--shm NAME] [--checksums FILE] [--diff] [--tolerance T]
+ *	[--scenario FILE]
+ *        fsd-sim --make-scenario FILE [--seed S] [--max-time SECONDS] [--param NAME=VALUE]...
+ *        fsd-sim --watch NAME
+ *        fsd-sim --compare FILE FILE
+ *
+ * Game i is played with seed S+i, so any row can be replayed on its own with
+ * "--games 1 --seed <seed>". The parameter names are the GameParams members.
+ * --tick-rate changes how many updates a second of game time is split into,
+ * FPS by default; the game and the automated player are timed in game time,
+ * so the difficulty should not depend on it.
+ *
+ * --zero-alloc needs a build with ALLOC_STATS defined. Each game is played for
+ * the whole of --max-time, restarting whenever it is lost, and fsd-sim fails
+ * if any game allocates memory after the first ALLOC_WARMUP seconds.
+ *
+ * --record writes every frame of a single game to PPM files or a raw RGB
+ * stream, as described for Recorder, at --record-scale times the size of
+ * the world, drawn on --record-threads threads. Frames are encoded on
+ * their own thread; as there is no clock to keep up with the game waits for
+ * the encoder rather than drop frames.
+ *
+ * --shm publishes every frame to shared memory of that name, as described
+ * for SharedState, so other processes can watch. The games are then played
+ * on one thread, one after another. fsd-sim --watch NAME is such a process:
+ * it prints a CSV line about the latest frame every SHARED_POLL seconds
+ * until the games finish.
+ *
+ * --checksums logs a checksum of the whole game after every update of a
+ * single game, as described for World::log_checksums(). fsd-sim --compare
+ * reads two such logs and reports the first frame they differ on, exiting
+ * with 1 if they differ at all.
+ *
+ * --diff plays each game twice in lockstep, once with the reference rules
+ * of GameParams::reference() and once with the optimised rules, by the
+ * same player. After every update the whole state of the two games is
+ * compared, positions and times to within --tolerance world units or
+ * seconds, 0 by default. The first difference is reported with both
+ * versions of the objects concerned and fsd-sim exits with 1.
+ *
+ * --scenario plays every game against the scripted enemies of a Scenario
+ * file instead of random ones. fsd-sim --make-scenario writes such a file,
+ * --max-time seconds long, with enemies spawned at the first level's rates
+ * of the game parameters, so --param can make it as dense as needed.
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include <Fl/Fl.H>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <math.h>
+#include <stddef.h>
+
+#include "World.h"
+#include "thread.h"
+#include "SpscQueue.h"
+#include "Recorder.h"
+#include "SharedState.h"
+#include "Scenario.h"
+#include "random.h"
+#include "Gun.h"
+#include "EnemyItem.h"
+#include "trace.h"
+#include "alloc.h"
+
+//Players
+enum {POLICY_IDLE = 0, POLICY_RANDOM, POLICY_GREEDY};
+#define POLICY_INTERVAL 0.1 // seconds of game time between clicks
+#define RESULT_QUEUE_SIZE 64 // must be a power of two
+
+/** \brief The options the batch was started with.
+ */
+struct SimOptions
+{
+	unsigned int games;
+	unsigned int seed;
+	int threads;
+	int policy;
+	double max_time;   ///< seconds of game time before a game is stopped
+	double tick;       ///< seconds of game time per update
+	bool json;
+	bool zero_alloc;   ///< play for max_time and count allocations after warm up
+	GameParams params;
+	Recorder *recorder; ///< records the game, 0 if not recording
+	SharedState *shared; ///< publishes the games, 0 if not sharing
+	FILE *checksums;    ///< logs the game's checksums, 0 if not logging
+	const char *scenario; ///< scripts the enemies of every game, 0 for random enemies
+};
+
+/** \brief The result of one game.
+ */
+struct GameResult
+{
+	unsigned int game;
+	unsigned int seed;
+	double survival_time; ///< seconds of game time played
+	int score;
+	int level;
+	unsigned long shells_fired;
+	unsigned long missiles_killed;
+	bool game_over;       ///< false if the game reached max_time
+	long allocations;     ///< allocations after warm up, for --zero-alloc
+};
+
+/** \brief The SimWorld class.
+ *
+ * The SimWorld class is a World with an automated player. Before each
+ * update's input is processed the player may click, which goes through
+ * exactly the same path as a click in the Window.
+ */
+class SimWorld : public World
+{
+public:
+	SimWorld(int policy);
+protected:
+	virtual void process_input();
+private:
+	virtual bool choose_target(int &x, int &y);
+	int policy_;
+	double next_click_; ///< game time of the player's next click
+};
+
+/** \brief A worker thread and the queue it passes results back through.
+ */
+struct Worker
+{
+	const SimOptions *options;
+	volatile long *next_game;
+	SpscQueue<GameResult, RESULT_QUEUE_SIZE> results;
+	Thread thread;
+};
+
+/** \brief Constructor for SimWorld.
+ *
+ * \param policy One of the POLICY_ values.
+ */
+SimWorld::SimWorld(int policy)
+{
+	policy_ = policy;
+	next_click_ = 0;
+}
+
+/** \brief Input processing function for the automated player.
+ *
+ * Every POLICY_INTERVAL seconds of game time the player clicks on the target
+ * it chooses.
+ */
+void SimWorld::process_input()
+{
+	int x, y;
+	if ((state() == NORMAL) && (time() >= next_click_))
+	{
+		while (next_click_ <= time())
+		{
+			next_click_ = next_click_ + POLICY_INTERVAL;
+		}
+		if (choose_target(x, y))
+		{
+			input().push(FL_PUSH, x, y);
+		}
+	}
+	World::process_input();
+}
+
+/** \brief A function to decide which of two enemies the greedy player aims at.
+ *
+ * The lower enemy is chosen, and ties are broken by the rest of the state
+ * the aim is worked out from, so the choice does not depend on the order
+ * of the EnemyItem registry, which the SpatialSort changes.
+ * \param a An enemy.
+ * \param b Another enemy.
+ * \return Returns true if a is chosen over b.
+ */
+static bool lower(EnemyItem *a, EnemyItem *b)
+{
+	if (a->y() != b->y())
+	{
+		return a->y() > b->y();
+	}
+	if (a->x() != b->x())
+	{
+		return a->x() < b->x();
+	}
+	if (a->target_x() != b->target_x())
+	{
+		return a->target_x() < b->target_x();
+	}
+	if (a->target_y() != b->target_y())
+	{
+		return a->target_y() < b->target_y();
+	}
+	if (a->start_x() != b->start_x())
+	{
+		return a->start_x() < b->start_x();
+	}
+	if (a->start_y() != b->start_y())
+	{
+		return a->start_y() < b->start_y();
+	}
+	return a->velocity() < b->velocity();
+}
+
+/** \brief A function to choose where the automated player clicks.
+ *
+ * The random player clicks anywhere in the sky. The greedy player clicks
+ * where the lowest enemy will be when a shell from the centre gun reaches
+ * it. The random numbers come from the game's generator, so a game is still
+ * decided by its seed alone.
+ * \param x Set to the x co-ordinate to click on.
+ * \param y Set to the y co-ordinate to click on.
+ * \return Returns true if the player clicks.
+ */
+bool SimWorld::choose_target(int &x, int &y)
+{
+	double ground = WORLD_HEIGHT - GROUND_HEIGHT;
+	if (policy_ == POLICY_RANDOM)
+	{
+		x = game_rand() % WORLD_WIDTH;
+		y = game_rand() % (int)(ground - GUN_BASE_RADIUS);
+		return true;
+	}
+	if (policy_ != POLICY_GREEDY)
+	{
+		return false;
+	}
+	EnemyItem *lowest = 0;
+	for (unsigned int i = 0; i < EnemyItem::enemyitems().size(); i++)
+	{
+		EnemyItem *e = EnemyItem::enemyitems()[i];
+		if (!e->dead() && (e->x() >= 0) && (e->x() < WORLD_WIDTH) && (!lowest || lower(e, lowest)))
+		{
+			lowest = e;
+		}
+	}
+	if (!lowest)
+	{
+		return false;
+	}
+	double dx = lowest->target_x() - lowest->start_x();
+	double dy = lowest->target_y() - lowest->start_y();
+	double length = sqrt(dx*dx + dy*dy);
+	double gx = WORLD_WIDTH/2 - lowest->x();
+	double gy = ground - lowest->y();
+	double flight = sqrt(gx*gx + gy*gy)/SHELL_VELOCITY;
+	double lead = (length > 0) ? lowest->velocity()*flight/length : 0;
+	x = (int)(lowest->x() + dx*lead);
+	y = (int)(lowest->y() + dy*lead);
+	if (y > ground - GUN_BASE_RADIUS)
+	{
+		y = (int)(ground - GUN_BASE_RADIUS);
+	}
+	return true;
+}
+
+/** \brief A function to play one game to the end.
+ *
+ * \param options The batch options.
+ * \param game The number of the game in the batch.
+ * \param r The result to fill in.
+ */
+static void play(const SimOptions &options, unsigned int game, GameResult &r)
+{
+	Scenario scenario;
+	SimWorld w(options.policy);
+	w.seed(options.seed + game);
+	w.params() = options.params;
+	w.record(options.recorder);
+	w.share(options.shared);
+	w.log_checksums(options.checksums);
+	if (options.scenario && scenario.open(options.scenario))
+	{
+		w.scenario(&scenario);
+	}
+	w.input().push(FL_KEYDOWN, FL_Escape, 0); // start the game
+#ifdef ALLOC_STATS
+	long warm = -1;
+#endif
+	do
+	{
+#ifdef ALLOC_STATS
+		if ((warm < 0) && (w.time() >= ALLOC_WARMUP))
+		{
+			warm = alloc_count();
+		}
+#endif
+		if (options.zero_alloc && (w.state() == GAMEOVER))
+		{
+			w.input().push(FL_KEYDOWN, FL_Escape, 0); // restart the game
+		}
+		w.step(1, options.tick);
+	} while ((options.zero_alloc || (w.state() != GAMEOVER)) && (w.time() < options.max_time));
+	r.game = game;
+	r.seed = options.seed + game;
+	r.survival_time = w.time();
+	r.score = w.score();
+	r.level = w.level();
+	r.shells_fired = w.shells_fired();
+	r.missiles_killed = w.missiles_killed();
+	r.game_over = (w.state() == GAMEOVER);
+	r.allocations = 0;
+#ifdef ALLOC_STATS
+	if (warm >= 0)
+	{
+		r.allocations = alloc_count() - warm;
+	}
+#endif
+}
+
+/** \brief Entry point for the worker threads.
+ *
+ * Each worker takes the next unplayed game until there are none left. The
+ * only thing the workers share is the game counter.
+ * \param worker Pointer to the Worker.
+ */
+static void worker_main(void *worker)
+{
+	Worker *w = (Worker*)worker;
+	TRACE_THREAD("worker");
+	long game;
+	while ((game = atomic_increment(w->next_game) - 1) < (long)w->options->games)
+	{
+		GameResult r;
+		play(*w->options, (unsigned int)game, r);
+		while (!w->results.push(r))
+		{
+			Thread::sleep(0.001);
+		}
+	}
+}
+
+/** \brief A function to write one result row.
+ *
+ * \param out The file to write to.
+ * \param r The result.
+ * \param options The batch options, which decide the format and columns.
+ */
+static void write_result(FILE *out, const GameResult &r, const SimOptions &options)
+{
+	if (options.json)
+	{
+		fprintf(out, "{\"game\":%u,\"seed\":%u,\"survival_time\":%.3f,\"score\":%d,\"level\":%d,"
+			"\"shells_fired\":%lu,\"missiles_killed\":%lu,\"game_over\":%s",
+			r.game, r.seed, r.survival_time, r.score, r.level, r.shells_fired, r.missiles_killed,
+			r.game_over ? "true" : "false");
+		if (options.zero_alloc)
+		{
+			fprintf(out, ",\"allocations\":%ld", r.allocations);
+		}
+		fprintf(out, "}\n");
+	}
+	else
+	{
+		fprintf(out, "%u,%u,%.3f,%d,%d,%lu,%lu,%d", r.game, r.seed, r.survival_time, r.score, r.level,
+			r.shells_fired, r.missiles_killed, r.game_over ? 1 : 0);
+		if (options.zero_alloc)
+		{
+			fprintf(out, ",%ld", r.allocations);
+		}
+		fprintf(out, "\n");
+	}
+	fflush(out);
+}
+
+/** \brief A function to change a game parameter by name.
+ *
+ * \param params The parameters to change.
+ * \param setting The setting, in the form NAME=VALUE.
+ * \return Returns false if the name is unknown or the value is missing.
+ */
+static bool set_param(GameParams &params, const char *setting)
+{
+	const char *eq = strchr(setting, '=');
+	if (!eq || (eq[1] == 0))
+	{
+		return false;
+	}
+	string name(setting, eq - setting);
+	double value = atof(eq + 1);
+	if ((value < 1) && (name != "level_scale_base") && (name != "level_scale_step") && (name != "use_kill_mask")
+		&& (name != "use_spatial_sort"))
+	{
+		return false; // the caps must allow one object, and smaller factors would flood the game
+	}
+	if (name == "level_scale_base")
+	{
+		params.level_scale_base = value;
+	}
+	else if (name == "level_scale_step")
+	{
+		params.level_scale_step = value;
+	}
+	else if (name == "ufo_spawn_factor")
+	{
+		params.ufo_spawn_factor = value;
+	}
+	else if (name == "missile_spawn_factor")
+	{
+		params.missile_spawn_factor = value;
+	}
+	else if (name == "ufo_fire_rate")
+	{
+		params.ufo_fire_rate = value;
+	}
+	else if (name == "max_missiles")
+	{
+		params.max_missiles = (unsigned int)value;
+	}
+	else if (name == "max_shells")
+	{
+		params.max_shells = (unsigned int)value;
+	}
+	else if (name == "use_kill_mask")
+	{
+		params.use_kill_mask = (value != 0);
+	}
+	else if (name == "use_spatial_sort")
+	{
+		params.use_spatial_sort = (value != 0);
+	}
+	else
+	{
+		return false;
+	}
+	return true;
+}
+
+/** \brief A function to print the usage message.
+ */
+static void usage()
+{
+	fprintf(stderr, "usage: fsd-sim [--games N] [--seed S] [--threads N] [--policy idle|random|greedy]\n"
+		"\t[--max-time SECONDS] [--tick-rate HZ] [--format csv|json] [--output FILE]\n"
+		"\t[--param NAME=VALUE]... [--zero-alloc]\n"
+		"\t[--record PATTERN|FILE] [--record-format ppm|raw] [--record-scale SCALE]\n"
+		"\t[--record-threads N] [--shm NAME] [--checksums FILE] [--diff] [--tolerance T]\n"
+		"\t[--scenario FILE]\n"
+		"       fsd-sim --make-scenario FILE [--seed S] [--max-time SECONDS] [--param NAME=VALUE]...\n"
+		"       fsd-sim --watch NAME\n"
+		"       fsd-sim --compare FILE FILE\n"
+		"parameters: level_scale_base level_scale_step ufo_spawn_factor missile_spawn_factor\n"
+		"\tufo_fire_rate max_missiles max_shells use_kill_mask use_spatial_sort\n");
+}
+
+/** \brief A function to watch games another fsd-sim is publishing.
+ *
+ * \param name The name of the shared memory.
+ * \return Returns the exit code for fsd-sim.
+ */
+static int watch(const char *name)
+{
+	SharedState shared;
+	if (!shared.attach(name))
+	{
+		fprintf(stderr, "fsd-sim: cannot watch %s\n", name);
+		return 1;
+	}
+	printf("frame,gamestate,score,level,bases,guns,missiles,ufos,shells,explosions,dropped\n");
+	unsigned int last = 0;
+	while (!shared.closed())
+	{
+		int sequence;
+		const SharedFrame *f = shared.begin_read(sequence);
+		if (f)
+		{
+			unsigned int frame = f->frame;
+			int gamestate = f->gamestate;
+			int score = f->score;
+			int level = f->level;
+			int dropped = f->dropped;
+			int counts[SHARED_EXPLOSION + 1] = {0};
+			int count = (f->count < SHARED_ENTITIES) ? f->count : SHARED_ENTITIES;
+			for (int i = 0; i < count; i++)
+			{
+				int kind = f->entities[i].kind;
+				if ((kind >= 0) && (kind <= SHARED_EXPLOSION))
+				{
+					counts[kind]++;
+				}
+			}
+			if (!shared.end_read(f, sequence))
+			{
+				continue; // overwritten while being read
+			}
+			if (frame != last)
+			{
+				printf("%u,%d,%d,%d,%d,%d,%d,%d,%d,%d,%d\n", frame, gamestate, score, level, counts[SHARED_BASE],
+					counts[SHARED_GUN], counts[SHARED_MISSILE], counts[SHARED_UFO], counts[SHARED_SHELL],
+					counts[SHARED_EXPLOSION], dropped);
+				fflush(stdout);
+				last = frame;
+			}
+		}
+		Thread::sleep(SHARED_POLL);
+	}
+	return 0;
+}
+
+/** \brief A function to find the first frame two checksum logs differ on.
+ *
+ * \param a The name of the first log.
+ * \param b The name of the second log.
+ * \return Returns the exit code for fsd-sim, 0 if the logs match.
+ */
+static int compare(const char *a, const char *b)
+{
+	FILE *fa = fopen(a, "r");
+	FILE *fb = fopen(b, "r");
+	if (!fa || !fb)
+	{
+		fprintf(stderr, "fsd-sim: cannot open %s\n", fa ? b : a);
+		if (fa)
+		{
+			fclose(fa);
+		}
+		if (fb)
+		{
+			fclose(fb);
+		}
+		return 2;
+	}
+	unsigned long frames = 0;
+	int ret = 0;
+	while (true)
+	{
+		unsigned long frame_a, frame_b;
+		unsigned int sum_a, sum_b;
+		bool more_a = (fscanf(fa, "%lu %x", &frame_a, &sum_a) == 2);
+		bool more_b = (fscanf(fb, "%lu %x", &frame_b, &sum_b) == 2);
+		if (!more_a && !more_b)
+		{
+			printf("identical over %lu frames\n", frames);
+			break;
+		}
+		if (!more_a || !more_b)
+		{
+			printf("identical over %lu frames, then %s ends\n", frames, more_a ? b : a);
+			ret = 1;
+			break;
+		}
+		if ((frame_a != frame_b) || (sum_a != sum_b))
+		{
+			printf("first difference at frame %lu: %s has frame %lu %08x, %s has frame %lu %08x\n",
+				frame_a, a, frame_a, sum_a, b, frame_b, sum_b);
+			ret = 1;
+			break;
+		}
+		frames++;
+	}
+	fclose(fa);
+	fclose(fb);
+	return ret;
+}
+
+/** \brief The names of the object types, for reports.
+ */
+static const char *object_names[OBJECT_TYPES] = {"none", "base", "gun", "missile", "ufo", "shell", "shellexplosion"};
+
+/** \brief A floating point field of ObjectRecord, for comparing records.
+ */
+struct RecordField
+{
+	const char *name;
+	size_t offset;
+};
+
+/** \brief The floating point fields of ObjectRecord.
+ */
+static const RecordField record_fields[] =
+{
+	{"x", offsetof(ObjectRecord, x)},
+	{"y", offsetof(ObjectRecord, y)},
+	{"radius", offsetof(ObjectRecord, radius)},
+	{"start_x", offsetof(ObjectRecord, start_x)},
+	{"start_y", offsetof(ObjectRecord, start_y)},
+	{"target_x", offsetof(ObjectRecord, target_x)},
+	{"target_y", offsetof(ObjectRecord, target_y)},
+	{"velocity", offsetof(ObjectRecord, velocity)},
+	{"barrel_width", offsetof(ObjectRecord, barrel_width)},
+	{"blast_radius", offsetof(ObjectRecord, blast_radius)},
+	{"timealive", offsetof(ObjectRecord, timealive)},
+	{"max_radius", offsetof(ObjectRecord, max_radius)},
+	{"next_event", offsetof(ObjectRecord, next_event)}
+};
+
+/** \brief A function to return a floating point field of a record.
+ */
+static double field(const ObjectRecord &r, const RecordField &f)
+{
+	return *(const double*)((const char*)&r + f.offset);
+}
+
+/** \brief A function to print an object in a --diff report.
+ *
+ * \param label Which game the object is from.
+ * \param index The index of the object's record.
+ * \param r The record.
+ */
+static void print_record(const char *label, unsigned int index, const ObjectRecord &r)
+{
+	int type = ((r.type >= 0) && (r.type < OBJECT_TYPES)) ? r.type : OBJECT_NONE;
+	printf("  %s object %u: %s level=%d", label, index, object_names[type], r.level);
+	for (unsigned int i = 0; i < sizeof(record_fields)/sizeof(record_fields[0]); i++)
+	{
+		printf(" %s=%.17g", record_fields[i].name, field(r, record_fields[i]));
+	}
+	printf("\n");
+}
+
+/** \brief A function to compare two numbers for --diff.
+ *
+ * \return Returns true if a and b are within tolerance of each other.
+ */
+static bool within(double a, double b, double tolerance)
+{
+	return (a == b) || (fabs(a - b) <= tolerance);
+}
+
+/** \brief A function to print the first line of a --diff report.
+ *
+ * \param game The number of the game in the batch.
+ * \param seed The game's seed.
+ * \param frame The frame the games first differ after.
+ */
+static void print_heading(unsigned int game, unsigned int seed, unsigned long frame)
+{
+	printf("game %u seed %u: first difference after frame %lu\n", game, seed, frame);
+}
+
+/** \brief A function to find the first difference between two games.
+ *
+ * Objects are compared first, as a difference in them is usually what
+ * causes any difference in the score or statistics.
+ * \param ref The game played by the reference rules.
+ * \param opt The game played by the optimised rules.
+ * \param tolerance How far apart positions and times may be.
+ * \param game The number of the game in the batch.
+ * \param seed The game's seed.
+ * \return Returns true if the games match, otherwise prints the difference
+ *	and returns false.
+ */
+static bool same_state(World &ref, World &opt, double tolerance, unsigned int game, unsigned int seed)
+{
+	vector<ObjectRecord> ref_records;
+	vector<ObjectRecord> opt_records;
+	SaveHeader a, b;
+	ref.capture_state(a, ref_records);
+	opt.capture_state(b, opt_records);
+	unsigned int count = (ref_records.size() < opt_records.size()) ? ref_records.size() : opt_records.size();
+	for (unsigned int i = 0; i < count; i++)
+	{
+		const ObjectRecord &r = ref_records[i];
+		const ObjectRecord &o = opt_records[i];
+		const char *differs = 0;
+		if (r.type != o.type)
+		{
+			differs = "type";
+		}
+		else if (r.level != o.level)
+		{
+			differs = "level";
+		}
+		for (unsigned int j = 0; !differs && (j < sizeof(record_fields)/sizeof(record_fields[0])); j++)
+		{
+			if (!within(field(r, record_fields[j]), field(o, record_fields[j]), tolerance))
+			{
+				differs = record_fields[j].name;
+			}
+		}
+		if (differs)
+		{
+			print_heading(game, seed, ref.frame());
+			printf("  object %u differs in %s\n", i, differs);
+			print_record("reference", i, r);
+			print_record("optimised", i, o);
+			return false;
+		}
+	}
+	if (ref_records.size() != opt_records.size())
+	{
+		print_heading(game, seed, ref.frame());
+		printf("  reference has %u objects, optimised has %u\n", (unsigned int)ref_records.size(), (unsigned int)opt_records.size());
+		bool ref_longer = (ref_records.size() > opt_records.size());
+		print_record(ref_longer ? "reference" : "optimised", count, ref_longer ? ref_records[count] : opt_records[count]);
+		return false;
+	}
+	const char *what = 0;
+	if (a.gamestate != b.gamestate)
+	{
+		what = "gamestate";
+	}
+	else if ((a.score != b.score) || (a.level != b.level))
+	{
+		what = "score or level";
+	}
+	else if (a.rand_state != b.rand_state)
+	{
+		what = "random number generator";
+	}
+	else if (!within(a.time, b.time, tolerance) || !within(a.next_ufo, b.next_ufo, tolerance)
+		|| !within(a.next_missile, b.next_missile, tolerance) || (a.spawn_level != b.spawn_level))
+	{
+		what = "game time or spawn times";
+	}
+	else if ((ref.shells_fired() != opt.shells_fired()) || (ref.missiles_killed() != opt.missiles_killed()))
+	{
+		what = "statistics";
+	}
+	if (what)
+	{
+		print_heading(game, seed, ref.frame());
+		printf("  %s differs\n", what);
+		printf("  reference gamestate=%d score=%d level=%d rand=%08x time=%.17g next_ufo=%.17g next_missile=%.17g"
+			" shells_fired=%lu missiles_killed=%lu\n", a.gamestate, a.score, a.level, a.rand_state, a.time,
+			a.next_ufo, a.next_missile, ref.shells_fired(), ref.missiles_killed());
+		printf("  optimised gamestate=%d score=%d level=%d rand=%08x time=%.17g next_ufo=%.17g next_missile=%.17g"
+			" shells_fired=%lu missiles_killed=%lu\n", b.gamestate, b.score, b.level, b.rand_state, b.time,
+			b.next_ufo, b.next_missile, opt.shells_fired(), opt.missiles_killed());
+		return false;
+	}
+	return true;
+}
+
+/** \brief A function to play each game with the reference and optimised rules in lockstep.
+ *
+ * \param options The batch options; the optimised game uses options.params.
+ * \param tolerance How far apart positions and times may be.
+ * \return Returns the exit code for fsd-sim, 0 if every game matched.
+ */
+static int diff(const SimOptions &options, double tolerance)
+{
+	for (unsigned int game = 0; game < options.games; game++)
+	{
+		unsigned int seed = options.seed + game;
+		// the players choose from the state, which is compared every update,
+		// so they click the same until the games differ
+		Scenario ref_scenario;
+		Scenario opt_scenario;
+		SimWorld ref(options.policy);
+		SimWorld opt(options.policy);
+		ref.seed(seed);
+		opt.seed(seed);
+		ref.params() = options.params;
+		ref.params().reference();
+		opt.params() = options.params;
+		if (options.scenario && ref_scenario.open(options.scenario) && opt_scenario.open(options.scenario))
+		{
+			ref.scenario(&ref_scenario);
+			opt.scenario(&opt_scenario);
+		}
+		ref.input().push(FL_KEYDOWN, FL_Escape, 0); // start the games
+		opt.input().push(FL_KEYDOWN, FL_Escape, 0);
+		do
+		{
+			ref.step(1, options.tick);
+			opt.step(1, options.tick);
+			if (!same_state(ref, opt, tolerance, game, seed))
+			{
+				return 1;
+			}
+		} while ((ref.state() != GAMEOVER) && (ref.time() < options.max_time));
+		printf("game %u seed %u: identical over %lu frames\n", game, seed, ref.frame());
+		fflush(stdout);
+	}
+	return 0;
+}
+
+/** \brief A function to write a scenario of random enemies.
+ *
+ * Enemies are spawned as the game spawns them on the first level, from the
+ * game parameters, and each UFO's shots are added as missiles fired from
+ * where it will be at the time, whether or not it has been shot down by
+ * then. The random numbers come from a generator of the scenario's own,
+ * seeded with options.seed, so the same options write the same file.
+ * \param options The batch options.
+ * \param filename The file to write.
+ * \return Returns the exit code for fsd-sim.
+ */
+static int make_scenario(const SimOptions &options, const char *filename)
+{
+	const double targets[][2] = {
+		{WORLD_WIDTH/2 + SEPARATION/2, WORLD_HEIGHT - GROUND_HEIGHT},
+		{WORLD_WIDTH/2 - SEPARATION/2, WORLD_HEIGHT - GROUND_HEIGHT},
+		{WORLD_WIDTH/2 + 3*SEPARATION/2, WORLD_HEIGHT - GROUND_HEIGHT},
+		{WORLD_WIDTH/2 - 3*SEPARATION/2, WORLD_HEIGHT - GROUND_HEIGHT},
+		{WORLD_WIDTH/2, WORLD_HEIGHT - GROUND_HEIGHT},
+		{WORLD_WIDTH/2 + SEPARATION, WORLD_HEIGHT - GROUND_HEIGHT},
+		{WORLD_WIDTH/2 - SEPARATION, WORLD_HEIGHT - GROUND_HEIGHT}}; // the bases and guns of World::start_game()
+	const int target_count = sizeof(targets)/sizeof(targets[0]);
+	WorldState state;
+	StateScope scope(&state);
+	game_srand(options.seed);
+	const GameParams &p = options.params;
+	double scale = p.level_scale(1);
+	Scenario scenario;
+	if (!scenario.create(filename))
+	{
+		fprintf(stderr, "fsd-sim: cannot write %s\n", filename);
+		return 1;
+	}
+	vector<double> ufo_start; // spawn time of each UFO still firing
+	vector<double> ufo_shot;  // time of its next shot
+	double next_ufo = game_rand_exponential(p.interval(p.ufo_spawn_factor, 1));
+	double next_missile = game_rand_exponential(p.interval(p.missile_spawn_factor, 1));
+	bool ok = true;
+	while (ok)
+	{
+		double t = (next_ufo < next_missile) ? next_ufo : next_missile;
+		int shooter = -1;
+		for (unsigned int i = 0; i < ufo_shot.size(); i++)
+		{
+			if (ufo_shot[i] < t)
+			{
+				t = ufo_shot[i];
+				shooter = i;
+			}
+		}
+		if (t > options.max_time)
+		{
+			break;
+		}
+		SpawnRecord r;
+		memset(&r, 0, sizeof(r));
+		r.time = t;
+		r.type = OBJECT_MISSILE;
+		if (shooter >= 0)
+		{
+			r.start_x = UFO_VELOCITY*scale*(t - ufo_start[shooter]);
+			r.start_y = 100;
+			if (r.start_x >= WORLD_WIDTH)
+			{
+				ufo_start[shooter] = ufo_start.back();
+				ufo_shot[shooter] = ufo_shot.back();
+				ufo_start.pop_back();
+				ufo_shot.pop_back();
+				continue;
+			}
+			ufo_shot[shooter] = ufo_shot[shooter] + game_rand_exponential(p.interval(p.ufo_fire_rate, 1));
+		}
+		else if (t == next_ufo)
+		{
+			r.type = OBJECT_UFO;
+			r.start_y = 100;
+			r.target_x = WORLD_WIDTH + 50;
+			r.target_y = 100;
+			r.velocity = UFO_VELOCITY*scale;
+			ufo_start.push_back(t);
+			ufo_shot.push_back(t + game_rand_exponential(p.interval(p.ufo_fire_rate, 1)));
+			next_ufo = next_ufo + game_rand_exponential(p.interval(p.ufo_spawn_factor, 1));
+		}
+		else
+		{
+			r.start_x = (double)(game_rand() % WORLD_WIDTH);
+			next_missile = next_missile + game_rand_exponential(p.interval(p.missile_spawn_factor, 1));
+		}
+		if (r.type == OBJECT_MISSILE)
+		{
+			int target = game_rand() % target_count;
+			r.target_x = targets[target][0];
+			r.target_y = targets[target][1];
+			r.velocity = MISSILE_VELOCITY*scale;
+		}
+		ok = scenario.write(r);
+	}
+	unsigned int count = scenario.count();
+	if (!scenario.close() || !ok)
+	{
+		fprintf(stderr, "fsd-sim: cannot write %s\n", filename);
+		return 1;
+	}
+	printf("%s: %u spawns over %.0f seconds\n", filename, count, options.max_time);
+	return 0;
+}
+
+/** \brief Program entry point.
+ */
+int main(int argc, char **argv)
+{
+	SimOptions options;
+	options.games = 1;
+	options.seed = 1;
+	options.threads = Thread::cores();
+	options.policy = POLICY_GREEDY;
+	options.max_time = 600;
+	options.tick = TIMESTEP;
+	options.json = false;
+	options.zero_alloc = false;
+	options.recorder = 0;
+	options.shared = 0;
+	options.checksums = 0;
+	options.scenario = 0;
+	const char *output = 0;
+	const char *record = 0;
+	int record_format = RECORD_PPM;
+	double record_scale = 1;
+	int record_threads = 1;
+	const char *shm = 0;
+	const char *checksums = 0;
+	bool differential = false;
+	double tolerance = 0;
+	const char *make = 0;
+
+	for (int i = 1; i < argc; i++)
+	{
+		string arg = argv[i];
+		if (arg == "--zero-alloc")
+		{
+			options.zero_alloc = true;
+			continue;
+		}
+		if (arg == "--diff")
+		{
+			differential = true;
+			continue;
+		}
+		if (i + 1 >= argc)
+		{
+			usage();
+			return 1;
+		}
+		string value = argv[++i];
+		if (arg == "--games")
+		{
+			options.games = (unsigned int)atoi(value.c_str());
+		}
+		else if (arg == "--seed")
+		{
+			options.seed = (unsigned int)strtoul(value.c_str(), 0, 10);
+		}
+		else if (arg == "--threads")
+		{
+			options.threads = atoi(value.c_str());
+		}
+		else if ((arg == "--policy") && (value == "idle"))
+		{
+			options.policy = POLICY_IDLE;
+		}
+		else if ((arg == "--policy") && (value == "random"))
+		{
+			options.policy = POLICY_RANDOM;
+		}
+		else if ((arg == "--policy") && (value == "greedy"))
+		{
+			options.policy = POLICY_GREEDY;
+		}
+		else if (arg == "--max-time")
+		{
+			options.max_time = atof(value.c_str());
+		}
+		else if ((arg == "--tick-rate") && (atof(value.c_str()) > 0))
+		{
+			options.tick = 1/atof(value.c_str());
+		}
+		else if ((arg == "--format") && ((value == "csv") || (value == "json")))
+		{
+			options.json = (value == "json");
+		}
+		else if (arg == "--output")
+		{
+			output = argv[i];
+		}
+		else if (arg == "--record")
+		{
+			record = argv[i];
+		}
+		else if ((arg == "--record-format") && ((value == "ppm") || (value == "raw")))
+		{
+			record_format = (value == "raw") ? RECORD_RAW : RECORD_PPM;
+		}
+		else if ((arg == "--record-scale") && (atof(value.c_str()) > 0))
+		{
+			record_scale = atof(value.c_str());
+		}
+		else if ((arg == "--record-threads") && (atoi(value.c_str()) > 0))
+		{
+			record_threads = atoi(value.c_str());
+		}
+		else if (arg == "--shm")
+		{
+			shm = argv[i];
+		}
+		else if (arg == "--watch")
+		{
+			return watch(argv[i]);
+		}
+		else if ((arg == "--tolerance") && (atof(value.c_str()) >= 0))
+		{
+			tolerance = atof(value.c_str());
+		}
+		else if (arg == "--checksums")
+		{
+			checksums = argv[i];
+		}
+		else if (arg == "--scenario")
+		{
+			options.scenario = argv[i];
+		}
+		else if (arg == "--make-scenario")
+		{
+			make = argv[i];
+		}
+		else if ((arg == "--compare") && (i + 1 < argc))
+		{
+			return compare(argv[i], argv[i + 1]);
+		}
+		else if ((arg != "--param") || !set_param(options.params, value.c_str()))
+		{
+			usage();
+			return 1;
+		}
+	}
+	if ((options.threads < 1) || (options.max_time <= 0) || (record && (options.games != 1))
+		|| (checksums && (options.games != 1)))
+	{
+		usage();
+		return 1;
+	}
+	if (make)
+	{
+		return make_scenario(options, make);
+	}
+	Scenario check;
+	if (options.scenario && !check.open(options.scenario))
+	{
+		fprintf(stderr, "fsd-sim: cannot read scenario %s\n", options.scenario);
+		return 1;
+	}
+	if (differential)
+	{
+		return diff(options, tolerance);
+	}
+#ifndef ALLOC_STATS
+	if (options.zero_alloc)
+	{
+		fprintf(stderr, "fsd-sim: --zero-alloc needs a build with ALLOC_STATS defined\n");
+		return 1;
+	}
+#endif
+	if ((unsigned int)options.threads > options.games)
+	{
+		options.threads = (options.games > 0) ? options.games : 1;
+	}
+	if (shm)
+	{
+		options.threads = 1; // one thread may publish
+	}
+
+	FILE *out = output ? fopen(output, "w") : stdout;
+	if (!out)
+	{
+		fprintf(stderr, "fsd-sim: cannot open %s\n", output);
+		return 1;
+	}
+	Recorder recorder;
+	if (record)
+	{
+		if (!recorder.open(record, record_format, record_scale, true, record_threads))
+		{
+			fprintf(stderr, "fsd-sim: cannot record to %s\n", record);
+			return 1;
+		}
+		options.recorder = &recorder;
+	}
+	SharedState shared;
+	if (shm)
+	{
+		if (!shared.create(shm))
+		{
+			fprintf(stderr, "fsd-sim: cannot create shared memory %s\n", shm);
+			return 1;
+		}
+		options.shared = &shared;
+	}
+	FILE *checksum_log = 0;
+	if (checksums)
+	{
+		checksum_log = fopen(checksums, "w");
+		if (!checksum_log)
+		{
+			fprintf(stderr, "fsd-sim: cannot open %s\n", checksums);
+			return 1;
+		}
+		options.checksums = checksum_log;
+	}
+	if (!options.json)
+	{
+		fprintf(out, "game,seed,survival_time,score,level,shells_fired,missiles_killed,game_over%s\n",
+			options.zero_alloc ? ",allocations" : "");
+	}
+
+	volatile long next_game = 0;
+	vector<Worker*> workers;
+	for (int i = 0; i < options.threads; i++)
+	{
+		Worker *w = new Worker;
+		w->options = &options;
+		w->next_game = &next_game;
+		workers.push_back(w);
+	}
+	for (unsigned int i = 0; i < workers.size(); i++)
+	{
+		workers[i]->thread.start(worker_main, workers[i]);
+	}
+
+	// results arrive in any order; hold them back so rows come out in game order
+	vector<GameResult> results(options.games);
+	vector<bool> done(options.games, false);
+	unsigned int written = 0;
+	unsigned int allocating = 0;
+	while (written < options.games)
+	{
+		bool received = false;
+		for (unsigned int i = 0; i < workers.size(); i++)
+		{
+			GameResult r;
+			while (workers[i]->results.pop(r))
+			{
+				results[r.game] = r;
+				done[r.game] = true;
+				received = true;
+			}
+		}
+		while ((written < options.games) && done[written])
+		{
+			write_result(out, results[written], options);
+			if (options.zero_alloc && (results[written].allocations > 0))
+			{
+				allocating++;
+			}
+			written++;
+		}
+		if (!received)
+		{
+			Thread::sleep(0.001);
+		}
+	}
+
+	for (unsigned int i = 0; i < workers.size(); i++)
+	{
+		workers[i]->thread.join();
+		delete workers[i];
+	}
+	if (record)
+	{
+		recorder.close();
+		fprintf(stderr, "fsd-sim: recorded %lu frames of %dx%d\n", recorder.written(), recorder.width(), recorder.height());
+		if (recorder.failed())
+		{
+			fprintf(stderr, "fsd-sim: writing %s failed\n", record);
+			return 1;
+		}
+	}
+	if (checksum_log)
+	{
+		fclose(checksum_log);
+	}
+	if (out != stdout)
+	{
+		fclose(out);
+	}
+	TRACE_DUMP(TRACE_FILE);
+	if (allocating > 0)
+	{
+		fprintf(stderr, "fsd-sim: %u of %u games allocated after %.0f seconds\n", allocating, options.games, ALLOC_WARMUP);
+		ALLOC_REPORT(stderr);
+		return 1;
+	}
+	return 0;
+}
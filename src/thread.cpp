@@ -0,0 +1,218 @@
+/** \file thread.cpp
+ * \brief Code implementation for thread functions.
+ *
+ * The thread code wraps the small amount of threading support the game needs,
+ * and includes code to make it cross-platform between POSIX and Windows
+ * systems.
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#include "thread.h"
+
+#ifndef WIN32
+#include <time.h>
+#include <unistd.h>
+#endif
+
+/** \brief The function and argument handed to a new thread.
+ */
+struct ThreadStart
+{
+	void (*func)(void*);
+	void *arg;
+};
+
+#ifdef WIN32
+/** \brief Entry point for new threads on Windows systems.
+ *
+ * \param p Pointer to a heap allocated ThreadStart, deleted once read.
+ * \return Returns 0.
+ */
+static DWORD WINAPI thread_entry(LPVOID p)
+#else
+/** \brief Entry point for new threads on POSIX systems.
+ *
+ * \param p Pointer to a heap allocated ThreadStart, deleted once read.
+ * \return Returns 0.
+ */
+static void *thread_entry(void *p)
+#endif
+{
+	ThreadStart *ts = (ThreadStart*)p;
+	void (*func)(void*) = ts->func;
+	void *arg = ts->arg;
+	delete ts;
+	func(arg);
+	return 0;
+}
+
+/** \brief Constructor for Thread.
+ *
+ * The constructor does not start a thread, call start() to do that.
+ */
+Thread::Thread()
+{
+	running_ = false;
+}
+
+/** \brief Destructor for Thread.
+ *
+ * The destructor waits for the thread to finish if it is still running.
+ */
+Thread::~Thread()
+{
+	join();
+}
+
+/** \brief A function to start the thread.
+ *
+ * \param func The function to run on the new thread.
+ * \param arg The argument to pass to func.
+ * \return Returns true if the thread was started, false otherwise.
+ */
+bool Thread::start(void (*func)(void*), void *arg)
+{
+	if (running_)
+	{
+		return false;
+	}
+	ThreadStart *ts = new ThreadStart;
+	ts->func = func;
+	ts->arg = arg;
+#ifdef WIN32
+	handle_ = CreateThread(NULL, 0, thread_entry, ts, 0, NULL);
+	running_ = (handle_ != NULL);
+#else
+	running_ = (pthread_create(&handle_, NULL, thread_entry, ts) == 0);
+#endif
+	if (!running_)
+	{
+		delete ts;
+	}
+	return running_;
+}
+
+/** \brief A function to wait for the thread to finish.
+ *
+ * Does nothing if the thread was never started or has already been joined.
+ */
+void Thread::join()
+{
+	if (!running_)
+	{
+		return;
+	}
+#ifdef WIN32
+	WaitForSingleObject(handle_, INFINITE);
+	CloseHandle(handle_);
+#else
+	pthread_join(handle_, NULL);
+#endif
+	running_ = false;
+}
+
+/** \brief A function to check if the thread has been started and not joined.
+ *
+ * \return Returns true if the thread is running.
+ */
+bool Thread::running()
+{
+	return running_;
+}
+
+/** \brief A function to suspend the calling thread.
+ *
+ * \param seconds The time to sleep for in seconds, type double. Values less
+ *	than or equal to zero return immediately.
+ */
+void Thread::sleep(double seconds)
+{
+	if (seconds <= 0)
+	{
+		return;
+	}
+#ifdef WIN32
+	Sleep((DWORD)(seconds*1000));
+#else
+	timespec ts;
+	ts.tv_sec = (time_t)seconds;
+	ts.tv_nsec = (long)((seconds - ts.tv_sec)*1000000000.0);
+	nanosleep(&ts, NULL);
+#endif
+}
+
+/** \brief Constructor for Semaphore.
+ *
+ * The count starts at zero.
+ */
+Semaphore::Semaphore()
+{
+#ifdef WIN32
+	handle_ = CreateSemaphore(NULL, 0, 0x7fffffff, NULL);
+#else
+	pthread_mutex_init(&mutex_, NULL);
+	pthread_cond_init(&cond_, NULL);
+	count_ = 0;
+#endif
+}
+
+/** \brief Destructor for Semaphore.
+ *
+ * No thread may still be waiting on it.
+ */
+Semaphore::~Semaphore()
+{
+#ifdef WIN32
+	CloseHandle(handle_);
+#else
+	pthread_cond_destroy(&cond_);
+	pthread_mutex_destroy(&mutex_);
+#endif
+}
+
+/** \brief A function to add one to the count, waking a waiting thread.
+ */
+void Semaphore::post()
+{
+#ifdef WIN32
+	ReleaseSemaphore(handle_, 1, NULL);
+#else
+	pthread_mutex_lock(&mutex_);
+	count_++;
+	pthread_cond_signal(&cond_);
+	pthread_mutex_unlock(&mutex_);
+#endif
+}
+
+/** \brief A function to wait until the count is above zero and take one off.
+ */
+void Semaphore::wait()
+{
+#ifdef WIN32
+	WaitForSingleObject(handle_, INFINITE);
+#else
+	pthread_mutex_lock(&mutex_);
+	while (count_ == 0)
+	{
+		pthread_cond_wait(&cond_, &mutex_);
+	}
+	count_--;
+	pthread_mutex_unlock(&mutex_);
+#endif
+}
+
+/** \brief A function to return the number of processors.
+ *
+ * \return Returns the number of processors available, at least 1.
+ */
+int Thread::cores()
+{
+#ifdef WIN32
+	SYSTEM_INFO info;
+	GetSystemInfo(&info);
+	int n = (int)info.dwNumberOfProcessors;
+#else
+	int n = (int)sysconf(_SC_NPROCESSORS_ONLN);
+#endif
+	return (n > 0) ? n : 1;
+}
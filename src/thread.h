@@ -0,0 +1,197 @@
+/** \file thread.h
+ * \brief Header file for thread and atomic functions.
+ *
+ * The thread code wraps the small amount of threading support the game needs,
+ * a thread that can be started and joined, a sleep function, a semaphore to
+ * wake waiting threads with and a few atomic operations on a long or an int,
+ * and includes code to make it cross-platform between POSIX and Windows
+ * systems.
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef THREAD_H
+#define THREAD_H
+
+#ifdef WIN32
+#include <windows.h>
+#else
+#include <pthread.h>
+#endif
+
+/** \brief Storage class for a variable with a separate copy for each thread.
+ */
+#ifdef WIN32
+#define THREAD_LOCAL __declspec(thread)
+#else
+#define THREAD_LOCAL __thread
+#endif
+
+/** \brief The Thread class.
+ *
+ * The Thread class runs a function on a new thread. The function is passed
+ * the argument given to start() and the thread ends when the function
+ * returns. join() waits for it to finish.
+ */
+class Thread
+{
+public:
+	Thread();
+	virtual ~Thread();
+
+	virtual bool start(void (*func)(void*), void *arg);
+	virtual void join();
+	virtual bool running();
+	static void sleep(double seconds);
+	static int cores();
+private:
+#ifdef WIN32
+	HANDLE handle_;
+#else
+	pthread_t handle_;
+#endif
+	bool running_;
+};
+
+/** \brief The Semaphore class.
+ *
+ * The Semaphore class holds a count. post() adds one to it, and wait() blocks
+ * until it is above zero and then takes one off, so a thread can sleep until
+ * another has work for it.
+ */
+class Semaphore
+{
+public:
+	Semaphore();
+	virtual ~Semaphore();
+	virtual void post();
+	virtual void wait();
+private:
+	Semaphore(const Semaphore&);
+	Semaphore &operator=(const Semaphore&);
+#ifdef WIN32
+	HANDLE handle_;
+#else
+	pthread_mutex_t mutex_;
+	pthread_cond_t cond_;
+	long count_;
+#endif
+};
+
+/** \brief Atomically read a value.
+ *
+ * Acts as a full memory barrier.
+ * \param p Address of the value to read.
+ * \return Returns the value.
+ */
+inline long atomic_load(volatile long *p)
+{
+#ifdef WIN32
+	return InterlockedCompareExchange(p, 0, 0);
+#else
+	return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/** \brief Atomically replace a value, returning the old value.
+ *
+ * Acts as a full memory barrier.
+ * \param p Address of the value to replace.
+ * \param v The new value.
+ * \return Returns the previous value.
+ */
+inline long atomic_exchange(volatile long *p, long v)
+{
+#ifdef WIN32
+	return InterlockedExchange(p, v);
+#else
+	return __atomic_exchange_n(p, v, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/** \brief Atomically add one to a value, returning the new value.
+ *
+ * Acts as a full memory barrier.
+ * \param p Address of the value to increment.
+ * \return Returns the incremented value.
+ */
+inline long atomic_increment(volatile long *p)
+{
+#ifdef WIN32
+	return InterlockedIncrement(p);
+#else
+	return __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/** \brief Atomically read a 32 bit value.
+ *
+ * Acts as a full memory barrier.
+ * \param p Address of the value to read.
+ * \return Returns the value.
+ */
+inline int atomic_load(volatile int *p)
+{
+#ifdef WIN32
+	return InterlockedCompareExchange((volatile LONG*)p, 0, 0);
+#else
+	return __atomic_load_n(p, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/** \brief Atomically add one to a 32 bit value, returning the new value.
+ *
+ * Acts as a full memory barrier.
+ * \param p Address of the value to increment.
+ * \return Returns the incremented value.
+ */
+inline int atomic_increment(volatile int *p)
+{
+#ifdef WIN32
+	return InterlockedIncrement((volatile LONG*)p);
+#else
+	return __atomic_add_fetch(p, 1, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/** \brief Atomically write a 32 bit value.
+ *
+ * Acts as a full memory barrier.
+ * \param p Address of the value to write.
+ * \param v The new value.
+ */
+inline void atomic_store(volatile int *p, int v)
+{
+#ifdef WIN32
+	InterlockedExchange((volatile LONG*)p, v);
+#else
+	__atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+#endif
+}
+
+/** \brief Stop reads and writes being reordered across this point.
+ */
+inline void memory_barrier()
+{
+#ifdef WIN32
+	MemoryBarrier();
+#else
+	__atomic_thread_fence(__ATOMIC_SEQ_CST);
+#endif
+}
+
+/** \brief Atomically write a value.
+ *
+ * Acts as a full memory barrier.
+ * \param p Address of the value to write.
+ * \param v The new value.
+ */
+inline void atomic_store(volatile long *p, long v)
+{
+#ifdef WIN32
+	InterlockedExchange(p, v);
+#else
+	__atomic_store_n(p, v, __ATOMIC_SEQ_CST);
+#endif
+}
+
+#endif
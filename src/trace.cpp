@@ -0,0 +1,214 @@
+/** \file trace.cpp
+ * \brief Code implementation for the trace functions.
+ *
+ * Every thread that records an event claims one of TRACE_MAX_THREADS
+ * buffers the first time it does so, which is the only time tracing
+ * allocates. The owning thread is the only writer of a buffer and publishes
+ * each event by atomically updating the buffer's count, so trace_dump() can
+ * read the buffers while other threads are still recording.
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifdef TRACE
+
+#include "trace.h"
+
+#include <stdio.h>
+
+#include "enum.h"
+#include "thread.h"
+
+#ifndef WIN32
+#include <time.h>
+#endif
+
+/** \brief A recorded event.
+ */
+struct TraceEvent
+{
+	const char *name;
+	char phase;        ///< 'B' begin, 'E' end or 'C' counter
+	double time;       ///< microseconds
+	long value;        ///< counter value
+};
+
+/** \brief The events recorded by one thread.
+ */
+struct TraceBuffer
+{
+	const char *thread_name;
+	volatile long count;
+	volatile long dropped;
+	TraceEvent events[TRACE_BUFFER_EVENTS];
+};
+
+/** \brief The claimed buffers. A buffer is only read once its ready flag is set.
+ */
+static TraceBuffer *buffers[TRACE_MAX_THREADS];
+static volatile long ready[TRACE_MAX_THREADS];
+
+/** \brief Number of buffers claimed so far, which may exceed TRACE_MAX_THREADS.
+ */
+static volatile long claimed = 0;
+
+/** \brief This thread's buffer, 0 before its first event.
+ */
+static THREAD_LOCAL TraceBuffer *buffer = 0;
+
+/** \brief Set on threads that found no free buffer.
+ */
+static THREAD_LOCAL bool untraced = false;
+
+/** \brief Function to return a high resolution time stamp.
+ *
+ * \return Returns the time in microseconds from an arbitrary start.
+ */
+static double trace_time()
+{
+#ifdef WIN32
+	LARGE_INTEGER count, frequency;
+	QueryPerformanceCounter(&count);
+	QueryPerformanceFrequency(&frequency);
+	return count.QuadPart*1000000.0/frequency.QuadPart;
+#else
+	timespec ts;
+	clock_gettime(CLOCK_MONOTONIC, &ts);
+	return ts.tv_sec*1000000.0 + ts.tv_nsec/1000.0;
+#endif
+}
+
+/** \brief Function to get this thread's buffer, claiming one if needed.
+ *
+ * \return Returns the buffer, or 0 if every buffer has been claimed.
+ */
+static TraceBuffer* thread_buffer()
+{
+	if (buffer || untraced)
+	{
+		return buffer;
+	}
+	long index = atomic_increment(&claimed) - 1;
+	if (index >= TRACE_MAX_THREADS)
+	{
+		untraced = true;
+		return 0;
+	}
+	buffer = new TraceBuffer;
+	buffer->thread_name = 0;
+	buffer->count = 0;
+	buffer->dropped = 0;
+	buffers[index] = buffer;
+	atomic_store(&ready[index], 1);
+	return buffer;
+}
+
+/** \brief Function to record an event.
+ *
+ * \param name The event name, a string literal.
+ * \param phase 'B' to begin a phase, 'E' to end it or 'C' for a counter.
+ * \param value The value of a counter, ignored otherwise.
+ */
+void trace_event(const char *name, char phase, long value)
+{
+	TraceBuffer *b = thread_buffer();
+	if (!b)
+	{
+		return;
+	}
+	long n = b->count;
+	if (n >= TRACE_BUFFER_EVENTS)
+	{
+		atomic_store(&b->dropped, b->dropped + 1);
+		return;
+	}
+	TraceEvent &e = b->events[n];
+	e.name = name;
+	e.phase = phase;
+	e.time = trace_time();
+	e.value = value;
+	atomic_store(&b->count, n + 1);
+}
+
+/** \brief Function to name the calling thread in the trace.
+ *
+ * \param name The thread name, a string literal.
+ */
+void trace_thread(const char *name)
+{
+	TraceBuffer *b = thread_buffer();
+	if (b)
+	{
+		b->thread_name = name;
+	}
+}
+
+/** \brief Function to write every recorded event to a file.
+ *
+ * Events recorded while the file is being written may be left out.
+ * \param filename The file to write.
+ * \return Returns true if the file was written.
+ */
+bool trace_dump(const char *filename)
+{
+	FILE *f = fopen(filename, "w");
+	if (!f)
+	{
+		return false;
+	}
+	fprintf(f, "{\"traceEvents\":[\n");
+	bool first = true;
+	long threads = atomic_load(&claimed);
+	for (long t = 0; (t < threads) && (t < TRACE_MAX_THREADS); t++)
+	{
+		if (!atomic_load(&ready[t]))
+		{
+			continue;
+		}
+		const TraceBuffer *b = buffers[t];
+		long count = atomic_load((volatile long*)&b->count);
+		if (b->thread_name)
+		{
+			fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%ld,\"args\":{\"name\":\"%s\"}}",
+				first ? "" : ",\n", t + 1, b->thread_name);
+			first = false;
+		}
+		for (long i = 0; i < count; i++)
+		{
+			const TraceEvent &e = b->events[i];
+			fprintf(f, "%s{\"name\":\"%s\",\"ph\":\"%c\",\"ts\":%.3f,\"pid\":1,\"tid\":%ld", first ? "" : ",\n",
+				e.name, e.phase, e.time, t + 1);
+			if (e.phase == 'C')
+			{
+				fprintf(f, ",\"args\":{\"value\":%ld}", e.value);
+			}
+			fprintf(f, "}");
+			first = false;
+		}
+		long dropped = atomic_load((volatile long*)&b->dropped);
+		if (dropped)
+		{
+			fprintf(stderr, "trace: thread %ld dropped %ld events\n", t + 1, dropped);
+		}
+	}
+	fprintf(f, "\n],\"displayTimeUnit\":\"ms\"}\n");
+	return fclose(f) == 0;
+}
+
+/** \brief Constructor for TraceScope.
+ *
+ * \param name The phase name, a string literal.
+ */
+TraceScope::TraceScope(const char *name)
+{
+	name_ = name;
+	trace_event(name_, 'B', 0);
+}
+
+/** \brief Destructor for TraceScope.
+ */
+TraceScope::~TraceScope()
+{
+	trace_event(name_, 'E', 0);
+}
+
+#endif
@@ -0,0 +1,55 @@
+/** \file trace.h
+ * \brief Header file for the trace functions.
+ *
+ * The trace code records the start and end of phases of the game, such as
+ * each part of an update or each pass of a draw, and writes them out as a
+ * Chrome trace_event JSON file that can be opened in chrome://tracing or
+ * Perfetto. Tracing is only compiled in when TRACE is defined; otherwise the
+ * macros below do nothing.
+ *
+ * Each thread records into its own preallocated buffer, so recording an
+ * event takes no locks and never allocates. A full buffer drops further
+ * events. Event names must be string literals.
+ * \author Tim Boundy
+ * \date October 2026
+ */
+#ifndef TRACE_H
+#define TRACE_H
+
+#ifdef TRACE
+#define TRACE_BEGIN(name) trace_event(name, 'B', 0)
+#define TRACE_END(name) trace_event(name, 'E', 0)
+#define TRACE_COUNTER(name, value) trace_event(name, 'C', value)
+#define TRACE_SCOPE(name) TraceScope trace_scope(name)
+#define TRACE_THREAD(name) trace_thread(name)
+#define TRACE_DUMP(filename) trace_dump(filename)
+#else
+#define TRACE_BEGIN(name)
+#define TRACE_END(name)
+#define TRACE_COUNTER(name, value)
+#define TRACE_SCOPE(name)
+#define TRACE_THREAD(name)
+#define TRACE_DUMP(filename)
+#endif
+
+#ifdef TRACE
+void trace_event(const char *name, char phase, long value);
+void trace_thread(const char *name);
+bool trace_dump(const char *filename);
+
+/** \brief The TraceScope class.
+ *
+ * Records a begin event when created and the matching end event when it
+ * goes out of scope.
+ */
+class TraceScope
+{
+public:
+	TraceScope(const char *name);
+	~TraceScope();
+private:
+	const char *name_;
+};
+#endif
+
+#endif